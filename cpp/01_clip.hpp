@@ -23,6 +23,24 @@ auto clip(const Eigen::MatrixBase<Derived>& X,
     return X.array().max(min_val).min(max_val).matrix();
 }
 
+/**
+ * Clip を呼び出し側のバッファに書き込む
+ *
+ * 一時領域を作らずに out へ直接評価する。out に X を渡すと in-place で適用する。
+ *
+ * @param out 出力 (X と同じ形状、呼び出し側で確保)
+ * @param X 入力テンソル
+ * @param min_val 最小値 (省略可能)
+ * @param max_val 最大値 (省略可能)
+ */
+template<typename Derived>
+void clip_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+               const Eigen::MatrixBase<Derived>& X,
+               double min_val = -std::numeric_limits<double>::infinity(),
+               double max_val = std::numeric_limits<double>::infinity()) {
+    out = clip(X, min_val, max_val);
+}
+
 } // namespace onnx
 
 #endif // ONNX_01_CLIP_HPP
@@ -6,47 +6,68 @@
 namespace onnx {
 
 /**
- * ONNX Div operator
+ * Div を呼び出し側のバッファに書き込む
  *
- * 2つのテンソルの要素ごとの除算を行う。
- * ブロードキャストをサポート。
+ * 出力は A と同じ形状。各要素は A の同じ位置だけを読むので out に A を渡してよい
+ * (in-place)。B は A と同じ形状のときに限り out と重なってよい。
  *
- * @param A 被除数テンソル
- * @param B 除数テンソル
- * @return C: A / B の結果
+ * @param out 出力 (A と同じ形状、呼び出し側で確保)
+ * @param A 入力テンソル1
+ * @param B 入力テンソル2
  */
 template<typename Derived1, typename Derived2>
-auto div(const Eigen::MatrixBase<Derived1>& A,
-         const Eigen::MatrixBase<Derived2>& B) {
+void div_into(Eigen::Ref<Eigen::MatrixXd> out,
+              const Eigen::MatrixBase<Derived1>& A,
+              const Eigen::MatrixBase<Derived2>& B) {
     // Same shape - element-wise division
     if (A.rows() == B.rows() && A.cols() == B.cols()) {
-        return (A.array() / B.array()).matrix();
+        out = (A.array() / B.array()).matrix();
+        return;
     }
 
     // Broadcasting: B is a row vector (1, cols)
     if (B.rows() == 1 && B.cols() == A.cols()) {
-        return (A.array().rowwise() / B.row(0).array()).matrix();
+        out = (A.array().rowwise() / B.row(0).array()).matrix();
+        return;
     }
 
     // Broadcasting: B is a column vector (rows, 1)
     if (B.cols() == 1 && B.rows() == A.rows()) {
-        return (A.array().colwise() / B.col(0).array()).matrix();
+        out = (A.array().colwise() / B.col(0).array()).matrix();
+        return;
     }
 
     // Broadcasting: B is a scalar (1, 1)
     if (B.rows() == 1 && B.cols() == 1) {
-        return (A.array() / B(0, 0)).matrix();
+        out = (A.array() / B(0, 0)).matrix();
+        return;
     }
 
     // General broadcasting
-    Eigen::MatrixXd result(A.rows(), A.cols());
     for (int i = 0; i < A.rows(); ++i) {
         for (int j = 0; j < A.cols(); ++j) {
             int bi = (B.rows() == 1) ? 0 : i;
             int bj = (B.cols() == 1) ? 0 : j;
-            result(i, j) = A(i, j) / B(bi, bj);
+            out(i, j) = A(i, j) / B(bi, bj);
         }
     }
+}
+
+/**
+ * ONNX Div operator
+ *
+ * 2つのテンソルの要素ごとの除算を行う。
+ * ブロードキャストをサポート。
+ *
+ * @param A 被除数テンソル
+ * @param B 除数テンソル
+ * @return C: A / B の結果
+ */
+template<typename Derived1, typename Derived2>
+Eigen::MatrixXd div(const Eigen::MatrixBase<Derived1>& A,
+                    const Eigen::MatrixBase<Derived2>& B) {
+    Eigen::MatrixXd result(A.rows(), A.cols());
+    div_into(result, A, B);
     return result;
 }
 
@@ -18,6 +18,20 @@ auto sqrt(const Eigen::MatrixBase<Derived>& X) {
     return X.array().sqrt().matrix();
 }
 
+/**
+ * Sqrt を呼び出し側のバッファに書き込む
+ *
+ * 一時領域を作らずに out へ直接評価する。out に X を渡すと in-place で適用する。
+ *
+ * @param out 出力 (X と同じ形状、呼び出し側で確保)
+ * @param X 入力テンソル
+ */
+template<typename Derived>
+void sqrt_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+               const Eigen::MatrixBase<Derived>& X) {
+    out = sqrt(X);
+}
+
 } // namespace onnx
 
 #endif // ONNX_01_SQRT_HPP
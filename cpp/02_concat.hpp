@@ -2,6 +2,7 @@
 #define ONNX_02_CONCAT_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <vector>
 
 namespace onnx {
@@ -101,6 +102,145 @@ Eigen::MatrixXd concat(const Eigen::MatrixBase<Derived1>& A,
     }
 }
 
+/**
+ * Concat の出力バッファ上での各入力の配置
+ *
+ * outer = prod(shape[:axis]), inner = prod(shape[axis+1:])。
+ * 入力 k は出力の各行 (長さ output_shape[axis] * inner) の
+ * [offsets[k] * inner, (offsets[k] + sizes[k]) * inner) を占める。
+ */
+struct ConcatPlan {
+    std::vector<int> output_shape;
+    std::vector<int> offsets;
+    std::vector<int> sizes;
+    long outer;
+    long inner;
+    int axis;
+};
+
+/**
+ * Helper function: Concat の出力形状と各入力の配置を計算する
+ *
+ * @param shapes 各入力の形状 (axis 以外は同じ)
+ * @param axis 連結する軸 (負の値は末尾から数える)
+ * @return 出力形状と各入力のオフセット
+ */
+inline ConcatPlan concat_plan(const std::vector<std::vector<int>>& shapes, int axis) {
+    const int rank = shapes[0].size();
+    if (axis < 0) axis += rank;
+
+    ConcatPlan plan;
+    plan.axis = axis;
+    plan.output_shape = shapes[0];
+    plan.output_shape[axis] = 0;
+    for (const auto& shape : shapes) {
+        plan.offsets.push_back(plan.output_shape[axis]);
+        plan.sizes.push_back(shape[axis]);
+        plan.output_shape[axis] += shape[axis];
+    }
+
+    plan.outer = 1;
+    plan.inner = 1;
+    for (int d = 0; d < axis; ++d) plan.outer *= plan.output_shape[d];
+    for (int d = axis + 1; d < rank; ++d) plan.inner *= plan.output_shape[d];
+    return plan;
+}
+
+/**
+ * Concat の出力スロット (concat elimination)
+ *
+ * 入力 k が占める出力バッファの領域を、書き込み可能な行優先の
+ * (outer x sizes[k] * inner) ビューとして返す。
+ * The producer of input k can evaluate its result directly into this view
+ * (e.g. slot.noalias() = W * cols); the concat copy for that input is then
+ * skipped by passing nullptr to concat_into(). When outer == 1 the slot is
+ * a contiguous range of the output.
+ *
+ * @param output 出力バッファ (prod(plan.output_shape) 要素)
+ * @param plan concat_plan() の結果
+ * @param k 入力の番号
+ * @return 出力バッファを参照するストライド付きビュー
+ */
+inline Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>, 0, Eigen::OuterStride<>>
+concat_slot(Eigen::VectorXd& output, const ConcatPlan& plan, int k) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+    const long row_length = plan.output_shape[plan.axis] * plan.inner;
+    return Eigen::Map<RowMatrix, 0, Eigen::OuterStride<>>(
+        output.data() + plan.offsets[k] * plan.inner, plan.outer, plan.sizes[k] * plan.inner,
+        Eigen::OuterStride<>(row_length > 0 ? row_length : 1));
+}
+
+/**
+ * Concat の出力スロット (2D)
+ *
+ * 行列 output の中で入力が占めるブロックを返す。
+ * 例えば planar (C x H*W) 形式のチャネル連結では axis=0 の行ブロックになる。
+ *
+ * @param output 出力行列
+ * @param axis 連結する軸 (0: 行方向, 1: 列方向)
+ * @param offset 入力の開始位置
+ * @param size 入力の軸方向サイズ
+ * @return 書き込み可能なブロック
+ */
+inline Eigen::Block<Eigen::MatrixXd> concat_slot(Eigen::MatrixXd& output, int axis, int offset, int size) {
+    if (axis == 0) {
+        return output.block(offset, 0, size, output.cols());
+    }
+    return output.block(0, offset, output.rows(), size);
+}
+
+/**
+ * Concat を事前確保した出力バッファに書き込む
+ *
+ * inputs[k] が nullptr の入力は、生成側が concat_slot() に直接書き込み済みとして
+ * コピーを省略する。各出力行について、残りの入力の連続した区間をそのままコピーする。
+ *
+ * @param output 出力バッファ (prod(plan.output_shape) 要素、呼び出し側で確保)
+ * @param plan concat_plan() の結果
+ * @param inputs 各入力 (flattened, row-major)。nullptr は書き込み済み
+ */
+inline void concat_into(Eigen::Ref<Eigen::VectorXd> output,
+                        const ConcatPlan& plan,
+                        const std::vector<const Eigen::VectorXd*>& inputs) {
+    const long row_length = plan.output_shape[plan.axis] * plan.inner;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long o = 0; o < plan.outer; ++o) {
+        double* dst = output.data() + o * row_length;
+        for (size_t k = 0; k < inputs.size(); ++k) {
+            if (inputs[k] == nullptr) continue;
+            const long chunk = plan.sizes[k] * plan.inner;
+            const double* src = inputs[k]->data() + o * chunk;
+            std::copy(src, src + chunk, dst + plan.offsets[k] * plan.inner);
+        }
+    }
+}
+
+/**
+ * ONNX Concat operator (N-D)
+ *
+ * 複数のテンソルを指定された軸に沿って連結する。
+ *
+ * @param inputs 連結するテンソルのリスト (flattened, row-major)
+ * @param shapes 各入力の形状
+ * @param axis 連結する軸 (負の値は末尾から数える)
+ * @param output_shape 出力テンソルの形状 - optional output
+ * @return result: 連結されたテンソル (flattened, row-major)
+ */
+inline Eigen::VectorXd concat(const std::vector<const Eigen::VectorXd*>& inputs,
+                              const std::vector<std::vector<int>>& shapes,
+                              int axis,
+                              std::vector<int>* output_shape = nullptr) {
+    ConcatPlan plan = concat_plan(shapes, axis);
+    if (output_shape != nullptr) *output_shape = plan.output_shape;
+
+    Eigen::VectorXd result(plan.outer * plan.output_shape[plan.axis] * plan.inner);
+    concat_into(result, plan, inputs);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_02_CONCAT_HPP
@@ -2,6 +2,7 @@
 #define ONNX_02_FLATTEN_HPP
 
 #include <Eigen/Dense>
+#include <vector>
 
 namespace onnx {
 
@@ -18,31 +19,55 @@ namespace onnx {
  */
 template<typename Derived>
 Eigen::MatrixXd flatten(const Eigen::MatrixBase<Derived>& input_tensor, int axis = 1) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+
     int rows = input_tensor.rows();
     int cols = input_tensor.cols();
 
-    if (axis == 0) {
-        // 全要素を1行に平坦化
-        Eigen::MatrixXd result(1, rows * cols);
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result(0, i * cols + j) = input_tensor(i, j);
-            }
-        }
-        return result;
-    } else if (axis == 1) {
+    if (axis == 1) {
         // 2D行列の場合はそのまま返す（既に2次元）
         return input_tensor.eval();
-    } else {
-        // axis == 2: 全要素を1列に平坦化
-        Eigen::MatrixXd result(rows * cols, 1);
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result(i * cols + j, 0) = input_tensor(i, j);
-            }
-        }
-        return result;
     }
+
+    // 全要素を行優先の順に1行 (axis=0) または1列 (axis=2) に平坦化
+    Eigen::MatrixXd result = (axis == 0) ? Eigen::MatrixXd(1, rows * cols) : Eigen::MatrixXd(rows * cols, 1);
+    Eigen::Map<RowMatrix>(result.data(), rows, cols) = input_tensor;
+    return result;
+}
+
+/**
+ * Helper function: Flatten の出力形状を計算する
+ *
+ * (prod(shape[:axis]), prod(shape[axis:])) を返す。負の axis は末尾から数える。
+ */
+inline std::vector<int> flatten_output_shape(const std::vector<int>& shape, int axis = 1) {
+    const int rank = shape.size();
+    if (axis < 0) axis += rank;
+
+    int outer = 1, inner = 1;
+    for (int d = 0; d < axis; ++d) outer *= shape[d];
+    for (int d = axis; d < rank; ++d) inner *= shape[d];
+    return {outer, inner};
+}
+
+/**
+ * Zero-copy Flatten (N-D)
+ *
+ * ONNX Flatten をメタデータのみの操作として行う。
+ * 行優先のデータは平坦化しても並びが変わらないため、入力をそのまま参照する。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param axis 平坦化の基準となる軸 (負の値は末尾から数える)
+ * @param output_shape 出力テンソルの形状 (2次元) (output)
+ * @return 出力テンソルを参照するビュー
+ */
+inline Eigen::Map<const Eigen::VectorXd> flatten_view(const Eigen::VectorXd& data,
+                                                      const std::vector<int>& shape,
+                                                      int axis,
+                                                      std::vector<int>& output_shape) {
+    output_shape = flatten_output_shape(shape, axis);
+    return Eigen::Map<const Eigen::VectorXd>(data.data(), data.size());
 }
 
 } // namespace onnx
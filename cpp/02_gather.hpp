@@ -2,17 +2,28 @@
 #define ONNX_02_GATHER_HPP
 
 #include <Eigen/Dense>
+#include <cstring>
+#include <string>
 #include <vector>
 
 namespace onnx {
 
+/**
+ * Helper function: 負のインデックスを正規化する
+ *
+ * ONNX では [-dim, dim) のインデックスを受け付け、負の値は末尾から数える。
+ */
+inline long gather_normalize_index(long index, long dim) {
+    return (index < 0) ? index + dim : index;
+}
+
 /**
  * ONNX Gather operator
  *
  * 指定された軸に沿って、インデックスで指定された要素を収集する。
  *
  * @param data 入力テンソル
- * @param indices 収集するインデックスのベクトル
+ * @param indices 収集するインデックスのベクトル (負の値は末尾から数える)
  * @param axis 収集する軸 (0: 行, 1: 列)
  * @return output: 収集された要素
  */
@@ -25,7 +36,7 @@ Eigen::MatrixXd gather(const Eigen::MatrixBase<Derived>& data,
         Eigen::MatrixXd result(indices.size(), data.cols());
 
         for (size_t i = 0; i < indices.size(); ++i) {
-            result.row(i) = data.row(indices[i]);
+            result.row(i) = data.row(gather_normalize_index(indices[i], data.rows()));
         }
 
         return result;
@@ -34,7 +45,7 @@ Eigen::MatrixXd gather(const Eigen::MatrixBase<Derived>& data,
         Eigen::MatrixXd result(data.rows(), indices.size());
 
         for (size_t i = 0; i < indices.size(); ++i) {
-            result.col(i) = data.col(indices[i]);
+            result.col(i) = data.col(gather_normalize_index(indices[i], data.cols()));
         }
 
         return result;
@@ -44,6 +55,8 @@ Eigen::MatrixXd gather(const Eigen::MatrixBase<Derived>& data,
 /**
  * Gather with Eigen vector indices
  *
+ * インデックスは中間の std::vector を作らずにそのまま読み出す。
+ *
  * @param data 入力テンソル
  * @param indices 収集するインデックスのEigenベクトル
  * @param axis 収集する軸 (0: 行, 1: 列)
@@ -53,12 +66,240 @@ template<typename Derived1, typename Derived2>
 Eigen::MatrixXd gather(const Eigen::MatrixBase<Derived1>& data,
                        const Eigen::MatrixBase<Derived2>& indices,
                        int axis = 0) {
-    std::vector<int> idx_vec;
-    for (int i = 0; i < indices.size(); ++i) {
-        idx_vec.push_back(static_cast<int>(indices(i)));
+    const int n = indices.size();
+
+    if (axis == 0) {
+        Eigen::MatrixXd result(n, data.cols());
+        for (int i = 0; i < n; ++i) {
+            result.row(i) = data.row(gather_normalize_index(static_cast<long>(indices(i)), data.rows()));
+        }
+        return result;
+    } else {
+        Eigen::MatrixXd result(data.rows(), n);
+        for (int i = 0; i < n; ++i) {
+            result.col(i) = data.col(gather_normalize_index(static_cast<long>(indices(i)), data.cols()));
+        }
+        return result;
+    }
+}
+
+/**
+ * Gather (N-D) の出力形状
+ *
+ * @param shape 入力テンソルの形状
+ * @param indices_shape インデックスの形状
+ * @param axis 収集する軸 (負の値は末尾から数える)
+ * @return shape[:axis] + indices_shape + shape[axis+1:]
+ */
+inline std::vector<int> gather_output_shape(const std::vector<int>& shape,
+                                            const std::vector<int>& indices_shape,
+                                            int axis = 0) {
+    if (axis < 0) axis += shape.size();
+    std::vector<int> out(shape.begin(), shape.begin() + axis);
+    out.insert(out.end(), indices_shape.begin(), indices_shape.end());
+    out.insert(out.end(), shape.begin() + axis + 1, shape.end());
+    return out;
+}
+
+/**
+ * Gather (N-D) を呼び出し側のバッファに書き込む
+ *
+ * With outer = prod(shape[:axis]) and inner = prod(shape[axis+1:]), every
+ * (outer, index) pair is one contiguous slab of inner elements, copied with
+ * memcpy. Slabs are independent and are distributed over threads. For an
+ * embedding table (axis = 0) each index copies one row.
+ *
+ * @param output 出力 (gather_output_shape() の要素数、呼び出し側で確保、data と重ならないこと)
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major, 負の値は末尾から数える)
+ * @param axis 収集する軸 (負の値は末尾から数える)
+ */
+template<typename IndexT>
+void gather_into(Eigen::Ref<Eigen::VectorXd> output,
+                 const Eigen::VectorXd& data,
+                 const std::vector<int>& shape,
+                 const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                 int axis = 0) {
+    const int rank = shape.size();
+    if (axis < 0) axis += rank;
+
+    long outer = 1, inner = 1;
+    for (int d = 0; d < axis; ++d) outer *= shape[d];
+    for (int d = axis + 1; d < rank; ++d) inner *= shape[d];
+    const long dim = shape[axis];
+    const long n = indices.size();
+
+    const double* src = data.data();
+    const IndexT* idx = indices.data();
+    double* dst = output.data();
+    const size_t bytes = inner * sizeof(double);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long s = 0; s < outer * n; ++s) {
+        const long o = s / n;
+        const long j = gather_normalize_index(static_cast<long>(idx[s % n]), dim);
+        std::memcpy(dst + s * inner, src + (o * dim + j) * inner, bytes);
     }
+}
 
-    return gather(data, idx_vec, axis);
+/**
+ * ONNX Gather operator (N-D)
+ *
+ * 指定された軸に沿って、インデックスで指定された要素を収集する。
+ * 出力を確保して gather_into() を呼ぶ。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major, 負の値は末尾から数える)
+ * @param indices_shape インデックスの形状
+ * @param axis 収集する軸 (負の値は末尾から数える)
+ * @param output_shape 出力形状 shape[:axis] + indices_shape + shape[axis+1:] - optional output
+ * @return output: 収集された要素 (flattened, row-major)
+ */
+template<typename IndexT>
+Eigen::VectorXd gather(const Eigen::VectorXd& data,
+                       const std::vector<int>& shape,
+                       const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                       const std::vector<int>& indices_shape,
+                       int axis = 0,
+                       std::vector<int>* output_shape = nullptr) {
+    const int rank = shape.size();
+    if (axis < 0) axis += rank;
+    if (output_shape != nullptr) *output_shape = gather_output_shape(shape, indices_shape, axis);
+
+    long outer = 1, inner = 1;
+    for (int d = 0; d < axis; ++d) outer *= shape[d];
+    for (int d = axis + 1; d < rank; ++d) inner *= shape[d];
+
+    Eigen::VectorXd result(outer * indices.size() * inner);
+    gather_into(result, data, shape, indices, axis);
+    return result;
+}
+
+/**
+ * Helper function: バッグの長さから開始位置を計算する
+ *
+ * lengths[b] 個ずつのインデックスが順に並んでいるとき、各バッグの開始位置を返す。
+ */
+template<typename IndexT>
+Eigen::Matrix<IndexT, Eigen::Dynamic, 1> embeddingbag_offsets(const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& lengths) {
+    Eigen::Matrix<IndexT, Eigen::Dynamic, 1> offsets(lengths.size());
+    IndexT start = 0;
+    for (int b = 0; b < lengths.size(); ++b) {
+        offsets(b) = start;
+        start += lengths(b);
+    }
+    return offsets;
+}
+
+/**
+ * EmbeddingBag を呼び出し側のバッファに書き込む
+ *
+ * 埋め込みテーブルから行を収集し、バッグごとに sum / mean / max で集約する。
+ * Equivalent to gather(table, indices, axis=0) followed by a reduction
+ * over each bag, but rows are accumulated straight from the table into the
+ * bag's output row, so the gathered (num_indices x dim) tensor is never
+ * materialized. The whole row a few indices ahead is prefetched, one cache
+ * line at a time; the look-ahead runs on into the following bag, which the
+ * same thread usually handles next. Bags are independent and are
+ * distributed over threads. Empty bags produce zeros.
+ *
+ * @param output 出力 (num_bags * dim 要素、呼び出し側で確保)
+ * @param table 埋め込みテーブル (flattened (num_embeddings, dim), row-major)
+ * @param dim 埋め込みの次元数
+ * @param indices 収集する行のインデックス (int32 / int64, 負の値は末尾から数える)
+ * @param offsets 各バッグの開始位置 (昇順、バッグ b は [offsets[b], offsets[b+1]))
+ * @param mode 集約方法 ("sum", "mean", "max")
+ * @param per_sample_weights インデックスごとの重み (mode="sum" のみ、mean / max では無視) - optional
+ */
+template<typename IndexT>
+void embeddingbag_into(Eigen::Ref<Eigen::VectorXd> output,
+                       const Eigen::VectorXd& table,
+                       int dim,
+                       const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                       const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& offsets,
+                       const std::string& mode = "sum",
+                       const Eigen::VectorXd* per_sample_weights = nullptr) {
+    const long num_rows = table.size() / dim;
+    const long num_indices = indices.size();
+    const int num_bags = offsets.size();
+    const int prefetch_distance = 4;
+    const int doubles_per_line = 64 / sizeof(double);
+
+    const bool use_max = (mode == "max");
+    const bool use_mean = (mode == "mean");
+
+    output.setZero();
+    const double* src = table.data();
+    const IndexT* idx = indices.data();
+    const double* weights = (per_sample_weights != nullptr && mode == "sum")
+        ? per_sample_weights->data() : nullptr;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (int b = 0; b < num_bags; ++b) {
+        const long begin = static_cast<long>(offsets(b));
+        const long end = (b + 1 < num_bags) ? static_cast<long>(offsets(b + 1)) : num_indices;
+        if (end <= begin) continue;
+
+        Eigen::Map<Eigen::VectorXd> out(output.data() + static_cast<long>(b) * dim, dim);
+
+        for (long i = begin; i < end; ++i) {
+#if defined(__GNUC__)
+            if (i + prefetch_distance < num_indices) {
+                const long next = gather_normalize_index(static_cast<long>(idx[i + prefetch_distance]), num_rows);
+                const double* p = src + next * dim;
+                for (int k = 0; k < dim; k += doubles_per_line) __builtin_prefetch(p + k);
+            }
+#endif
+            const long r = gather_normalize_index(static_cast<long>(idx[i]), num_rows);
+            Eigen::Map<const Eigen::VectorXd> row(src + r * dim, dim);
+
+            if (use_max) {
+                if (i == begin) {
+                    out = row;
+                } else {
+                    out = out.cwiseMax(row);
+                }
+            } else if (weights != nullptr) {
+                out += weights[i] * row;
+            } else {
+                out += row;
+            }
+        }
+
+        if (use_mean) out /= static_cast<double>(end - begin);
+    }
+}
+
+/**
+ * EmbeddingBag (Gather + Reduce)
+ *
+ * 埋め込みテーブルから行を収集し、バッグごとに sum / mean / max で集約する。
+ * 出力を確保して embeddingbag_into() を呼ぶ。
+ *
+ * @param table 埋め込みテーブル (flattened (num_embeddings, dim), row-major)
+ * @param dim 埋め込みの次元数
+ * @param indices 収集する行のインデックス (int32 / int64, 負の値は末尾から数える)
+ * @param offsets 各バッグの開始位置 (昇順、バッグ b は [offsets[b], offsets[b+1]))
+ * @param mode 集約方法 ("sum", "mean", "max")
+ * @param per_sample_weights インデックスごとの重み (mode="sum" のみ、mean / max では無視) - optional
+ * @return 集約結果 (flattened (num_bags, dim), row-major)
+ */
+template<typename IndexT>
+Eigen::VectorXd embeddingbag(const Eigen::VectorXd& table,
+                             int dim,
+                             const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                             const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& offsets,
+                             const std::string& mode = "sum",
+                             const Eigen::VectorXd* per_sample_weights = nullptr) {
+    Eigen::VectorXd result(static_cast<long>(offsets.size()) * dim);
+    embeddingbag_into(result, table, dim, indices, offsets, mode, per_sample_weights);
+    return result;
 }
 
 } // namespace onnx
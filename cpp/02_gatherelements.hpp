@@ -0,0 +1,113 @@
+#ifndef ONNX_02_GATHERELEMENTS_HPP
+#define ONNX_02_GATHERELEMENTS_HPP
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace onnx {
+
+/**
+ * Helper function: 部分形状の各位置に対応する入力バッファ上のオフセット
+ *
+ * shape[begin:end] の全ての位置 (行優先) について、
+ * 入力テンソルのストライド strides[begin:end] でのオフセットを並べる。
+ */
+inline std::vector<long> gatherelements_offsets(const std::vector<int>& shape,
+                                                const std::vector<long>& strides,
+                                                int begin, int end) {
+    std::vector<long> offsets(1, 0);
+    for (int d = begin; d < end; ++d) {
+        std::vector<long> next;
+        next.reserve(offsets.size() * shape[d]);
+        for (long base : offsets) {
+            for (int i = 0; i < shape[d]; ++i) next.push_back(base + i * strides[d]);
+        }
+        offsets.swap(next);
+    }
+    return offsets;
+}
+
+/**
+ * GatherElements を呼び出し側のバッファに書き込む
+ *
+ * 指定された軸に沿って、インデックステンソルの各要素が指す入力要素を収集する。
+ * output[i_0, ..., i_{r-1}] = data[i_0, ..., indices[i_0, ..., i_{r-1}], ..., i_{r-1}]
+ * The output has the shape of indices. Offsets of the outer and inner
+ * positions in data are precomputed once, so the kernel is a flat loop
+ * over (outer, index, inner), parallelized over the outer positions.
+ *
+ * @param output 出力 (indices と同じ要素数、呼び出し側で確保、data と重ならないこと)
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major, 負の値は末尾から数える)
+ * @param indices_shape インデックスの形状 (data と同じランク)
+ * @param axis 収集する軸 (負の値は末尾から数える)
+ */
+template<typename IndexT>
+void gatherelements_into(Eigen::Ref<Eigen::VectorXd> output,
+                        const Eigen::VectorXd& data,
+                        const std::vector<int>& shape,
+                        const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                        const std::vector<int>& indices_shape,
+                        int axis = 0) {
+    const int rank = shape.size();
+    if (axis < 0) axis += rank;
+
+    std::vector<long> strides(rank, 1);
+    for (int d = rank - 2; d >= 0; --d) strides[d] = strides[d + 1] * shape[d + 1];
+
+    const std::vector<long> outer_offsets = gatherelements_offsets(indices_shape, strides, 0, axis);
+    const std::vector<long> inner_offsets = gatherelements_offsets(indices_shape, strides, axis + 1, rank);
+    const long outer = outer_offsets.size();
+    const long inner = inner_offsets.size();
+    const long n = indices_shape[axis];
+    const long dim = shape[axis];
+    const long axis_stride = strides[axis];
+
+    const double* src = data.data();
+    const IndexT* idx = indices.data();
+    double* dst = output.data();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long o = 0; o < outer; ++o) {
+        const double* base = src + outer_offsets[o];
+        for (long j = 0; j < n; ++j) {
+            const long pos = (o * n + j) * inner;
+            for (long i = 0; i < inner; ++i) {
+                long k = static_cast<long>(idx[pos + i]);
+                if (k < 0) k += dim;
+                dst[pos + i] = base[k * axis_stride + inner_offsets[i]];
+            }
+        }
+    }
+}
+
+/**
+ * ONNX GatherElements operator
+ *
+ * 指定された軸に沿って、インデックステンソルの各要素が指す入力要素を収集する。
+ * 出力を確保して gatherelements_into() を呼ぶ。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major, 負の値は末尾から数える)
+ * @param indices_shape インデックスの形状 (data と同じランク)
+ * @param axis 収集する軸 (負の値は末尾から数える)
+ * @return output: 収集された要素 (flattened, indices_shape, row-major)
+ */
+template<typename IndexT>
+Eigen::VectorXd gatherelements(const Eigen::VectorXd& data,
+                               const std::vector<int>& shape,
+                               const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                               const std::vector<int>& indices_shape,
+                               int axis = 0) {
+    Eigen::VectorXd result(indices.size());
+    gatherelements_into(result, data, shape, indices, indices_shape, axis);
+    return result;
+}
+
+} // namespace onnx
+
+#endif // ONNX_02_GATHERELEMENTS_HPP
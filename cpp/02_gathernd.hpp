@@ -0,0 +1,119 @@
+#ifndef ONNX_02_GATHERND_HPP
+#define ONNX_02_GATHERND_HPP
+
+#include <Eigen/Dense>
+#include <cstring>
+#include <vector>
+
+namespace onnx {
+
+/**
+ * GatherND の出力形状
+ *
+ * @param shape 入力テンソルの形状
+ * @param indices_shape インデックスの形状
+ * @param batch_dims バッチ次元の数
+ * @return indices_shape[:-1] + shape[batch_dims + indices_shape[-1]:]
+ */
+inline std::vector<int> gathernd_output_shape(const std::vector<int>& shape,
+                                              const std::vector<int>& indices_shape,
+                                              int batch_dims = 0) {
+    std::vector<int> out(indices_shape.begin(), indices_shape.end() - 1);
+    out.insert(out.end(), shape.begin() + batch_dims + indices_shape.back(), shape.end());
+    return out;
+}
+
+/**
+ * GatherND を呼び出し側のバッファに書き込む
+ *
+ * インデックステンソルの最後の次元を入力の先頭軸の座標とみなし、部分テンソルを収集する。
+ * With k = indices_shape.back(), each index tuple selects one contiguous
+ * slab of prod(shape[batch_dims + k:]) elements, copied with memcpy.
+ * Tuples are independent and are distributed over threads.
+ *
+ * @param output 出力 (gathernd_output_shape() の要素数、呼び出し側で確保、data と重ならないこと)
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major, 負の値は末尾から数える)
+ * @param indices_shape インデックスの形状
+ * @param batch_dims バッチ次元の数 (data と indices で共通の先頭軸)
+ */
+template<typename IndexT>
+void gathernd_into(Eigen::Ref<Eigen::VectorXd> output,
+                   const Eigen::VectorXd& data,
+                   const std::vector<int>& shape,
+                   const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                   const std::vector<int>& indices_shape,
+                   int batch_dims = 0) {
+    const int rank = shape.size();
+    const int k = indices_shape.back();
+
+    std::vector<long> strides(rank, 1);
+    for (int d = rank - 2; d >= 0; --d) strides[d] = strides[d + 1] * shape[d + 1];
+
+    long batch = 1;
+    for (int d = 0; d < batch_dims; ++d) batch *= shape[d];
+    const long batch_stride = (batch_dims > 0) ? strides[batch_dims - 1] : 0;
+
+    long slab = 1;
+    for (int d = batch_dims + k; d < rank; ++d) slab *= shape[d];
+
+    long per_batch = 1;
+    for (size_t d = batch_dims; d + 1 < indices_shape.size(); ++d) per_batch *= indices_shape[d];
+    const long tuples = batch * per_batch;
+
+    const double* src = data.data();
+    const IndexT* idx = indices.data();
+    double* dst = output.data();
+    const size_t bytes = slab * sizeof(double);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long t = 0; t < tuples; ++t) {
+        long offset = (t / per_batch) * batch_stride;
+        for (int j = 0; j < k; ++j) {
+            long i = static_cast<long>(idx[t * k + j]);
+            const int d = batch_dims + j;
+            if (i < 0) i += shape[d];
+            offset += i * strides[d];
+        }
+        std::memcpy(dst + t * slab, src + offset, bytes);
+    }
+}
+
+/**
+ * ONNX GatherND operator
+ *
+ * インデックステンソルの最後の次元を入力の先頭軸の座標とみなし、部分テンソルを収集する。
+ * 出力を確保して gathernd_into() を呼ぶ。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major, 負の値は末尾から数える)
+ * @param indices_shape インデックスの形状
+ * @param batch_dims バッチ次元の数 (data と indices で共通の先頭軸)
+ * @param output_shape 出力形状 indices_shape[:-1] + shape[batch_dims + k:] - optional output
+ * @return output: 収集された要素 (flattened, row-major)
+ */
+template<typename IndexT>
+Eigen::VectorXd gathernd(const Eigen::VectorXd& data,
+                         const std::vector<int>& shape,
+                         const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                         const std::vector<int>& indices_shape,
+                         int batch_dims = 0,
+                         std::vector<int>* output_shape = nullptr) {
+    const std::vector<int> out_shape = gathernd_output_shape(shape, indices_shape, batch_dims);
+    if (output_shape != nullptr) *output_shape = out_shape;
+
+    long size = 1;
+    for (int d : out_shape) size *= d;
+
+    Eigen::VectorXd result(size);
+    gathernd_into(result, data, shape, indices, indices_shape, batch_dims);
+    return result;
+}
+
+} // namespace onnx
+
+#endif // ONNX_02_GATHERND_HPP
@@ -2,14 +2,92 @@
 #define ONNX_02_RESHAPE_HPP
 
 #include <Eigen/Dense>
+#include <vector>
 
 namespace onnx {
 
+/**
+ * Helper function: 行優先の連続データを取得する
+ *
+ * data の要素が行優先 (ONNX の並び) で連続して格納されていれば
+ * そのポインタを返す。そうでなければ storage に行優先でコピーする。
+ */
+template<typename Derived>
+const double* reshape_contiguous_data(const Eigen::DenseBase<Derived>& data, Eigen::VectorXd& storage) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+
+    if constexpr (bool(Derived::Flags & Eigen::DirectAccessBit)) {
+        const Derived& d = data.derived();
+        const bool row_major = bool(Derived::Flags & Eigen::RowMajorBit);
+        bool contiguous;
+        if (d.rows() == 1 || d.cols() == 1) {
+            contiguous = (d.size() <= 1) || (d.rows() == 1 ? d.colStride() == 1 : d.rowStride() == 1);
+        } else {
+            contiguous = row_major && d.innerStride() == 1 && d.outerStride() == d.cols();
+        }
+        if (contiguous) return d.data();
+    }
+
+    storage.resize(data.size());
+    Eigen::Map<RowMatrix>(storage.data(), data.rows(), data.cols()) = data;
+    return storage.data();
+}
+
+/**
+ * Helper function: Reshape の出力形状を計算する
+ *
+ * 0 は (allowzero が false の場合) 入力の同じ位置の次元をコピーし、
+ * -1 は残りの要素数から推論する。allowzero が true の場合、0 はサイズ0の次元になる。
+ * 次の new_shape は無効として false を返す: -1 が複数ある、-1 未満の値がある、
+ * コピー元の次元がない位置に 0 がある、-1 を推論できない (残りの次元の積が 0
+ * または要素数を割り切れない)、要素数が入力と一致しない。
+ *
+ * @param shape 入力テンソルの形状
+ * @param new_shape 指定された形状
+ * @param output_shape 出力テンソルの形状 (output, 有効な場合のみ書き込む)
+ * @param allowzero 0 をそのまま次元として扱うか
+ * @return new_shape が有効なら true
+ */
+inline bool reshape_output_shape(const std::vector<int>& shape,
+                                 const std::vector<int>& new_shape,
+                                 std::vector<int>& output_shape,
+                                 bool allowzero = false) {
+    long total = 1;
+    for (int d : shape) total *= d;
+
+    std::vector<int> out(new_shape);
+    int infer = -1;
+    long known = 1;
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (out[i] == 0 && !allowzero) {
+            if (i >= shape.size()) return false;
+            out[i] = shape[i];
+        }
+        if (out[i] == -1) {
+            if (infer >= 0) return false;
+            infer = static_cast<int>(i);
+        } else if (out[i] < 0) {
+            return false;
+        } else {
+            known *= out[i];
+        }
+    }
+    if (infer >= 0) {
+        if (known == 0 || total % known != 0) return false;
+        out[infer] = static_cast<int>(total / known);
+    } else if (known != total) {
+        return false;
+    }
+    output_shape = out;
+    return true;
+}
+
 /**
  * ONNX Reshape operator
  *
  * テンソルを新しい形状に変形する。
  * Eigenは2D行列のみをサポートするため、2D形状への変形を行う。
+ * 要素は行優先 (ONNX) の順に並べ替えられる。
  *
  * @param data 入力テンソル
  * @param rows 新しい行数
@@ -18,20 +96,63 @@ namespace onnx {
  */
 template<typename Derived>
 Eigen::MatrixXd reshape(const Eigen::MatrixBase<Derived>& data, int rows, int cols) {
-    // データを1次元配列として扱い、新しい形状に再構成
-    Eigen::MatrixXd reshaped(rows, cols);
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
 
-    int total_elements = data.rows() * data.cols();
+    Eigen::VectorXd storage;
+    const double* flat = reshape_contiguous_data(data, storage);
+    return Eigen::Map<const RowMatrix>(flat, rows, cols);
+}
 
-    for (int i = 0; i < total_elements; ++i) {
-        int old_row = i / data.cols();
-        int old_col = i % data.cols();
-        int new_row = i / cols;
-        int new_col = i % cols;
-        reshaped(new_row, new_col) = data(old_row, old_col);
-    }
+/**
+ * Zero-copy Reshape (2D)
+ *
+ * 行優先の並びを保ったまま (rows, cols) に変形したビューを返す。
+ * 入力が行優先で連続していればデータを共有し、そうでなければ storage にコピーする。
+ *
+ * @param data 入力テンソル
+ * @param rows 新しい行数
+ * @param cols 新しい列数
+ * @param storage 入力が連続していない場合の書き込み先
+ * @return 変形されたテンソルを参照する行優先のビュー
+ */
+template<typename Derived>
+Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+reshape_view(const Eigen::MatrixBase<Derived>& data, int rows, int cols, Eigen::VectorXd& storage) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+    return Eigen::Map<const RowMatrix>(reshape_contiguous_data(data, storage), rows, cols);
+}
 
-    return reshaped;
+/**
+ * Zero-copy Reshape (N-D)
+ *
+ * ONNX Reshape をメタデータのみの操作として行う。
+ * The returned view shares the input buffer (flattened, row-major); only
+ * output_shape is computed. A copy into storage is made only when the
+ * input is not stored contiguously in row-major order. An invalid
+ * new_shape (see reshape_output_shape()) leaves output_shape empty and
+ * returns an empty view with a null data pointer; a valid rank-0 result
+ * also has an empty shape but always views one element.
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param new_shape 指定された形状 (0: 入力の次元をコピー, -1: 推論)
+ * @param output_shape 出力テンソルの形状 (output)
+ * @param storage 入力が連続していない場合の書き込み先
+ * @param allowzero 0 をそのまま次元として扱うか
+ * @return 出力テンソルを参照するビュー
+ */
+template<typename Derived>
+Eigen::Map<const Eigen::VectorXd> reshape_view(const Eigen::DenseBase<Derived>& data,
+                                               const std::vector<int>& shape,
+                                               const std::vector<int>& new_shape,
+                                               std::vector<int>& output_shape,
+                                               Eigen::VectorXd& storage,
+                                               bool allowzero = false) {
+    output_shape.clear();
+    if (!reshape_output_shape(shape, new_shape, output_shape, allowzero)) {
+        return Eigen::Map<const Eigen::VectorXd>(nullptr, 0);
+    }
+    return Eigen::Map<const Eigen::VectorXd>(reshape_contiguous_data(data, storage), data.size());
 }
 
 } // namespace onnx
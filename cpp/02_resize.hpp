@@ -2,85 +2,628 @@
 #define ONNX_02_RESIZE_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <cmath>
+#include <string>
+#include <vector>
+
+#include "runtime/arena.hpp"
 
 namespace onnx {
 
 /**
- * ONNX Resize operator
+ * Helper function: 出力座標を入力座標に変換する
  *
- * テンソルをリサイズする。
- * nearest neighbor または bilinear 補間をサポート。
+ * ONNX の coordinate_transformation_mode に従う。
+ * "half_pixel", "half_pixel_symmetric", "pytorch_half_pixel",
+ * "align_corners", "asymmetric", "tf_crop_and_resize" をサポート。
+ */
+inline double resize_source_coordinate(int x, double scale, int in_size, int out_size,
+                                       const std::string& coordinate_transformation_mode,
+                                       double roi_start = 0.0, double roi_end = 1.0) {
+    const std::string& m = coordinate_transformation_mode;
+    if (m == "align_corners") {
+        return (out_size == 1) ? 0.0 : x * static_cast<double>(in_size - 1) / (out_size - 1);
+    }
+    if (m == "asymmetric") {
+        return x / scale;
+    }
+    if (m == "pytorch_half_pixel") {
+        return (out_size > 1) ? (x + 0.5) / scale - 0.5 : 0.0;
+    }
+    if (m == "half_pixel_symmetric") {
+        double adjustment = out_size / (scale * in_size);
+        double offset = in_size / 2.0 * (1.0 - adjustment);
+        return offset + (x + 0.5) / scale - 0.5;
+    }
+    if (m == "tf_crop_and_resize") {
+        if (out_size == 1) return 0.5 * (roi_start + roi_end) * (in_size - 1);
+        return roi_start * (in_size - 1) + x * (roi_end - roi_start) * (in_size - 1) / (out_size - 1);
+    }
+    // half_pixel (default)
+    return (x + 0.5) / scale - 0.5;
+}
+
+/**
+ * Helper function: 補間カーネル
  *
- * @param X 入力テンソル
- * @param scale_row 行方向のスケール係数
- * @param scale_col 列方向のスケール係数
- * @param mode 補間モード ("nearest" または "linear")
- * @return Y: リサイズされたテンソル
+ * linear: max(0, 1 - |d|)
+ * cubic: Keys の3次畳み込みカーネル (係数 a)
  */
-template<typename Derived>
-Eigen::MatrixXd resize(const Eigen::MatrixBase<Derived>& X,
-                       double scale_row,
-                       double scale_col,
-                       const std::string& mode = "nearest") {
-    int input_rows = X.rows();
-    int input_cols = X.cols();
+inline double resize_kernel(double d, bool cubic, double cubic_coeff_a) {
+    d = std::abs(d);
+    if (!cubic) return std::max(0.0, 1.0 - d);
+    const double a = cubic_coeff_a;
+    if (d <= 1.0) return ((a + 2.0) * d - (a + 3.0)) * d * d + 1.0;
+    if (d < 2.0) return ((a * d - 5.0 * a) * d + 8.0 * a) * d - 4.0 * a;
+    return 0.0;
+}
+
+/**
+ * 1軸分のリサイズテーブル
+ *
+ * 出力位置 o は taps 個の入力位置 index[o * taps + k] の
+ * weight[o * taps + k] による重み付き和になる。
+ * outside[o] が真の位置は extrapolation_value で埋める (tf_crop_and_resize)。
+ */
+struct ResizeAxisTable {
+    int taps = 1;
+    std::vector<int> index;
+    std::vector<double> weight;
+    std::vector<char> outside;
+    bool identity = false;
 
-    int output_rows = static_cast<int>(std::round(input_rows * scale_row));
-    int output_cols = static_cast<int>(std::round(input_cols * scale_col));
+    // Integer upsampling ratio (0 if out_size is not a multiple of in_size).
+    // replicate: nearest with index[o] == o / ratio.
+    // stencil: every output o = i * ratio + r uses taps i + phase_offset[r * taps + k]
+    // with the fixed weights phase_weight[r * taps + k] (clamped at the borders).
+    int ratio = 0;
+    bool replicate = false;
+    bool stencil = false;
+    std::vector<int> phase_offset;
+    std::vector<double> phase_weight;
+};
+
+/**
+ * Helper function: 整数倍拡大の高速パスを判定する
+ *
+ * out_size が in_size の整数倍で、テーブルが出力位置の位相 (o % ratio) ごとに
+ * 同じオフセットと重みを持つ場合、replicate / stencil を設定する。
+ */
+inline void resize_detect_integer_ratio(ResizeAxisTable& t, int in_size, int out_size) {
+    if (in_size <= 0 || out_size <= in_size || out_size % in_size != 0) return;
+    for (int o = 0; o < out_size; ++o) {
+        if (t.outside[o]) return;
+    }
 
-    Eigen::MatrixXd Y(output_rows, output_cols);
+    const int k = out_size / in_size;
+    const int taps = t.taps;
+    t.ratio = k;
 
-    if (mode == "nearest") {
-        // Nearest neighbor interpolation
-        for (int i = 0; i < output_rows; ++i) {
-            for (int j = 0; j < output_cols; ++j) {
-                // マッピング元の座標を計算
-                int src_row = static_cast<int>(std::floor(i / scale_row));
-                int src_col = static_cast<int>(std::floor(j / scale_col));
+    if (taps == 1) {
+        t.replicate = true;
+        for (int o = 0; o < out_size && t.replicate; ++o) {
+            if (t.index[o] != o / k) t.replicate = false;
+        }
+        return;
+    }
 
-                // 境界チェック
-                src_row = std::min(src_row, input_rows - 1);
-                src_col = std::min(src_col, input_cols - 1);
+    // Phase offsets / weights from an interior input position
+    const int mid = in_size / 2;
+    if (mid - taps < 0 || mid + taps >= in_size) return;
+    t.phase_offset.resize(static_cast<long>(k) * taps);
+    t.phase_weight.resize(static_cast<long>(k) * taps);
+    for (int r = 0; r < k; ++r) {
+        long o = static_cast<long>(mid) * k + r;
+        for (int j = 0; j < taps; ++j) {
+            t.phase_offset[r * taps + j] = t.index[o * taps + j] - mid;
+            t.phase_weight[r * taps + j] = t.weight[o * taps + j];
+        }
+    }
 
-                Y(i, j) = X(src_row, src_col);
+    // The whole table must follow the phase pattern
+    for (int o = 0; o < out_size; ++o) {
+        const int i = o / k, r = o % k;
+        for (int j = 0; j < taps; ++j) {
+            int p = std::min(std::max(i + t.phase_offset[r * taps + j], 0), in_size - 1);
+            double w = t.weight[static_cast<long>(o) * taps + j];
+            if (w == 0.0 && t.phase_weight[r * taps + j] == 0.0) continue;
+            if (t.index[static_cast<long>(o) * taps + j] != p ||
+                std::abs(w - t.phase_weight[r * taps + j]) > 1e-12) {
+                return;
             }
         }
-    } else if (mode == "linear" || mode == "bilinear") {
-        // Bilinear interpolation
-        for (int i = 0; i < output_rows; ++i) {
-            for (int j = 0; j < output_cols; ++j) {
-                // マッピング元の連続座標を計算
-                double src_row = i / scale_row;
-                double src_col = j / scale_col;
-
-                // 近傍の4点を取得
-                int r0 = static_cast<int>(std::floor(src_row));
-                int r1 = std::min(r0 + 1, input_rows - 1);
-                int c0 = static_cast<int>(std::floor(src_col));
-                int c1 = std::min(c0 + 1, input_cols - 1);
-
-                // 補間係数
-                double dr = src_row - r0;
-                double dc = src_col - c0;
-
-                // バイリニア補間
-                double v00 = X(r0, c0);
-                double v01 = X(r0, c1);
-                double v10 = X(r1, c0);
-                double v11 = X(r1, c1);
-
-                double v0 = v00 * (1 - dc) + v01 * dc;
-                double v1 = v10 * (1 - dc) + v11 * dc;
-                Y(i, j) = v0 * (1 - dr) + v1 * dr;
+    }
+    t.stencil = true;
+}
+
+/**
+ * Helper function: 1軸分のインデックス / 重みテーブルを作成する
+ *
+ * Coordinates, rounding and kernel weights are evaluated once per output
+ * position instead of once per output element. With antialias and
+ * scale < 1 the kernel is stretched by 1 / scale and its weights are
+ * normalized, as in the ONNX reference.
+ */
+inline ResizeAxisTable resize_axis_table(int in_size, int out_size, double scale,
+                                         const std::string& mode,
+                                         const std::string& coordinate_transformation_mode,
+                                         const std::string& nearest_mode,
+                                         double cubic_coeff_a,
+                                         bool antialias,
+                                         bool exclude_outside,
+                                         double roi_start = 0.0, double roi_end = 1.0) {
+    ResizeAxisTable t;
+    t.outside.assign(out_size, 0);
+
+    const bool cubic = (mode == "cubic");
+    const bool linear = (mode == "linear" || mode == "bilinear");
+    const bool crop = (coordinate_transformation_mode == "tf_crop_and_resize");
+
+    if (!cubic && !linear) {
+        // Nearest neighbor
+        t.taps = 1;
+        t.index.resize(out_size);
+        t.weight.assign(out_size, 1.0);
+        for (int o = 0; o < out_size; ++o) {
+            double x = resize_source_coordinate(o, scale, in_size, out_size,
+                                                coordinate_transformation_mode, roi_start, roi_end);
+            if (crop && (x < 0.0 || x > in_size - 1)) t.outside[o] = 1;
+
+            int i;
+            if (nearest_mode == "floor") {
+                i = static_cast<int>(std::floor(x));
+            } else if (nearest_mode == "ceil") {
+                i = static_cast<int>(std::ceil(x));
+            } else if (nearest_mode == "round_prefer_ceil") {
+                i = static_cast<int>(std::floor(x + 0.5));
+            } else {
+                // round_prefer_floor
+                i = static_cast<int>(std::ceil(x - 0.5));
             }
+            t.index[o] = std::min(std::max(i, 0), in_size - 1);
         }
     } else {
-        // デフォルトはnearest
-        return resize(X, scale_row, scale_col, "nearest");
+        const double support = cubic ? 2.0 : 1.0;
+        const double s = (antialias && scale < 1.0) ? scale : 1.0;
+        const double radius = support / s;
+
+        t.taps = static_cast<int>(std::ceil(2.0 * radius));
+        t.index.assign(static_cast<long>(out_size) * t.taps, 0);
+        t.weight.assign(static_cast<long>(out_size) * t.taps, 0.0);
+
+        for (int o = 0; o < out_size; ++o) {
+            double x = resize_source_coordinate(o, scale, in_size, out_size,
+                                                coordinate_transformation_mode, roi_start, roi_end);
+            if (crop && (x < 0.0 || x > in_size - 1)) t.outside[o] = 1;
+
+            int* idx = t.index.data() + static_cast<long>(o) * t.taps;
+            double* w = t.weight.data() + static_cast<long>(o) * t.taps;
+
+            // Taps p with x - radius < p <= x + radius
+            int p0 = static_cast<int>(std::floor(x - radius)) + 1;
+            int count = std::min(t.taps, static_cast<int>(std::floor(x + radius)) - p0 + 1);
+            double sum = 0.0;
+            for (int k = 0; k < count; ++k) {
+                int p = p0 + k;
+                double wk = resize_kernel((p - x) * s, cubic, cubic_coeff_a);
+                if (exclude_outside && (p < 0 || p >= in_size)) wk = 0.0;
+                idx[k] = std::min(std::max(p, 0), in_size - 1);
+                w[k] = wk;
+                sum += wk;
+            }
+            if ((antialias || exclude_outside) && sum != 0.0) {
+                for (int k = 0; k < count; ++k) w[k] /= sum;
+            }
+        }
     }
 
-    return Y;
+    resize_detect_integer_ratio(t, in_size, out_size);
+
+    // Tables that map every output to the same input position are skipped
+    t.identity = (in_size == out_size);
+    for (int o = 0; o < out_size && t.identity; ++o) {
+        if (t.outside[o]) t.identity = false;
+        for (int k = 0; k < t.taps && t.identity; ++k) {
+            double w = t.weight[static_cast<long>(o) * t.taps + k];
+            int i = t.index[static_cast<long>(o) * t.taps + k];
+            if (w != 0.0 && (i != o || w != 1.0)) t.identity = false;
+        }
+    }
+
+    return t;
+}
+
+/**
+ * Helper function: 1軸分のリサイズ (整数倍 nearest)
+ *
+ * 出力位置 o は入力位置 o / ratio の単純な複製になる。
+ */
+inline void resize_axis_replicate(const double* in, double* out,
+                                  long outer, int in_n, int ratio, long inner) {
+    const long out_n = static_cast<long>(in_n) * ratio;
+    for (long n = 0; n < outer; ++n) {
+        const double* src = in + n * in_n * inner;
+        double* dst = out + n * out_n * inner;
+
+        if (inner == 1) {
+            if (ratio == 2) {
+                for (int i = 0; i < in_n; ++i) {
+                    dst[2 * i] = src[i];
+                    dst[2 * i + 1] = src[i];
+                }
+            } else {
+                for (int i = 0; i < in_n; ++i) {
+                    std::fill(dst + static_cast<long>(i) * ratio, dst + static_cast<long>(i + 1) * ratio, src[i]);
+                }
+            }
+        } else {
+            for (int i = 0; i < in_n; ++i) {
+                for (int r = 0; r < ratio; ++r) {
+                    std::copy(src + i * inner, src + (i + 1) * inner,
+                              dst + (static_cast<long>(i) * ratio + r) * inner);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Helper function: 1軸分のリサイズ (整数倍 linear / cubic)
+ *
+ * 出力位置 o = i * ratio + r は位相 r ごとに固定された重みのステンシル。
+ * Inputs whose taps all fall inside the axis run without index tables or
+ * clamping; only the few border positions fall back to the table.
+ */
+inline void resize_axis_stencil(const double* in, double* out,
+                                long outer, int in_n, long inner,
+                                const ResizeAxisTable& t) {
+    const int k = t.ratio;
+    const int taps = t.taps;
+    const long out_n = static_cast<long>(in_n) * k;
+
+    const int min_off = *std::min_element(t.phase_offset.begin(), t.phase_offset.end());
+    const int max_off = *std::max_element(t.phase_offset.begin(), t.phase_offset.end());
+    const int i_lo = std::min(in_n, std::max(0, -min_off));
+    const int i_hi = std::max(i_lo, std::min(in_n, in_n - max_off));
+
+    for (long n = 0; n < outer; ++n) {
+        const double* src = in + n * in_n * inner;
+        double* dst = out + n * out_n * inner;
+
+        auto border = [&](int i) {
+            for (int r = 0; r < k; ++r) {
+                long o = static_cast<long>(i) * k + r;
+                const int* idx = t.index.data() + o * taps;
+                const double* w = t.weight.data() + o * taps;
+                if (inner == 1) {
+                    double v = 0.0;
+                    for (int j = 0; j < taps; ++j) v += w[j] * src[idx[j]];
+                    dst[o] = v;
+                } else {
+                    Eigen::Map<Eigen::ArrayXd> row(dst + o * inner, inner);
+                    row.setZero();
+                    for (int j = 0; j < taps; ++j) {
+                        row += w[j] * Eigen::Map<const Eigen::ArrayXd>(src + idx[j] * inner, inner);
+                    }
+                }
+            }
+        };
+
+        for (int i = 0; i < i_lo; ++i) border(i);
+
+        for (int r = 0; r < k; ++r) {
+            const int* off = t.phase_offset.data() + r * taps;
+            const double* w = t.phase_weight.data() + r * taps;
+
+            if (inner == 1) {
+                if (taps == 2) {
+                    const double w0 = w[0], w1 = w[1];
+                    const int o0 = off[0], o1 = off[1];
+                    for (int i = i_lo; i < i_hi; ++i) {
+                        dst[static_cast<long>(i) * k + r] = w0 * src[i + o0] + w1 * src[i + o1];
+                    }
+                } else {
+                    for (int i = i_lo; i < i_hi; ++i) {
+                        double v = 0.0;
+                        for (int j = 0; j < taps; ++j) v += w[j] * src[i + off[j]];
+                        dst[static_cast<long>(i) * k + r] = v;
+                    }
+                }
+            } else {
+                for (int i = i_lo; i < i_hi; ++i) {
+                    Eigen::Map<Eigen::ArrayXd> row(dst + (static_cast<long>(i) * k + r) * inner, inner);
+                    row = w[0] * Eigen::Map<const Eigen::ArrayXd>(src + (i + off[0]) * inner, inner);
+                    for (int j = 1; j < taps; ++j) {
+                        if (w[j] == 0.0) continue;
+                        row += w[j] * Eigen::Map<const Eigen::ArrayXd>(src + (i + off[j]) * inner, inner);
+                    }
+                }
+            }
+        }
+
+        for (int i = i_hi; i < in_n; ++i) border(i);
+    }
+}
+
+/**
+ * Helper function: 1軸分のリサイズ
+ *
+ * in: (outer, in_n, inner) row-major, out: (outer, out_n, inner) row-major.
+ * For inner == 1 each output is a short dot product over the taps;
+ * otherwise each output row is a weighted sum of contiguous input rows.
+ * Integer upsampling ratios are dispatched to resize_axis_replicate()
+ * and resize_axis_stencil().
+ */
+inline void resize_axis(const double* in, double* out,
+                        long outer, int in_n, int out_n, long inner,
+                        const ResizeAxisTable& t, double extrapolation_value) {
+    if (t.replicate) {
+        resize_axis_replicate(in, out, outer, in_n, t.ratio, inner);
+        return;
+    }
+    if (t.stencil) {
+        resize_axis_stencil(in, out, outer, in_n, inner, t);
+        return;
+    }
+
+    const int taps = t.taps;
+
+    for (long n = 0; n < outer; ++n) {
+        const double* src = in + n * in_n * inner;
+        double* dst = out + n * out_n * inner;
+
+        if (inner == 1) {
+            for (int o = 0; o < out_n; ++o) {
+                const int* idx = t.index.data() + static_cast<long>(o) * taps;
+                const double* w = t.weight.data() + static_cast<long>(o) * taps;
+                double v = 0.0;
+                for (int k = 0; k < taps; ++k) v += w[k] * src[idx[k]];
+                dst[o] = t.outside[o] ? extrapolation_value : v;
+            }
+        } else {
+            for (int o = 0; o < out_n; ++o) {
+                Eigen::Map<Eigen::ArrayXd> row(dst + o * inner, inner);
+                if (t.outside[o]) {
+                    row.setConstant(extrapolation_value);
+                    continue;
+                }
+                const int* idx = t.index.data() + static_cast<long>(o) * taps;
+                const double* w = t.weight.data() + static_cast<long>(o) * taps;
+                row = w[0] * Eigen::Map<const Eigen::ArrayXd>(src + idx[0] * inner, inner);
+                for (int k = 1; k < taps; ++k) {
+                    if (w[k] == 0.0) continue;
+                    row += w[k] * Eigen::Map<const Eigen::ArrayXd>(src + idx[k] * inner, inner);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Resize (N-D) を呼び出し側のバッファに書き込む
+ *
+ * Separable implementation: a per-axis index/weight table is built once,
+ * then the axes are resized one at a time from the innermost (contiguous)
+ * axis outward. Axes whose table is the identity are skipped. The first
+ * pass reads X directly and the last pass writes output; passes in between
+ * ping-pong between two buffers in the thread's scratch arena.
+ *
+ * @param output 出力 (prod(sizes) 要素、呼び出し側で確保、X と重ならないこと)
+ * @param X 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param sizes 出力テンソルの形状
+ * @param scales 各軸のスケール係数 (座標変換に使用)
+ * @param mode 補間モード ("nearest", "linear", "cubic")
+ * @param coordinate_transformation_mode 座標変換モード (デフォルト: "half_pixel")
+ * @param nearest_mode nearest の丸め方 (デフォルト: "round_prefer_floor")
+ * @param cubic_coeff_a cubic 補間の係数 (デフォルト: -0.75)
+ * @param antialias 縮小時にアンチエイリアスフィルタを使用するか
+ * @param exclude_outside 入力範囲外のタップの重みを 0 にするか
+ * @param extrapolation_value tf_crop_and_resize で範囲外の出力に使う値
+ * @param roi 各軸の [start..., end...] (tf_crop_and_resize 用) - optional
+ */
+inline void resize_into(Eigen::Ref<Eigen::VectorXd> output,
+                        const Eigen::VectorXd& X,
+                        const std::vector<int>& shape,
+                        const std::vector<int>& sizes,
+                        const std::vector<double>& scales,
+                        const std::string& mode = "nearest",
+                        const std::string& coordinate_transformation_mode = "half_pixel",
+                        const std::string& nearest_mode = "round_prefer_floor",
+                        double cubic_coeff_a = -0.75,
+                        bool antialias = false,
+                        bool exclude_outside = false,
+                        double extrapolation_value = 0.0,
+                        const std::vector<double>* roi = nullptr) {
+    const int rank = shape.size();
+
+    // Tables of the axes that change, innermost first
+    std::vector<int> axes;
+    std::vector<ResizeAxisTable> tables;
+    for (int a = rank - 1; a >= 0; --a) {
+        double roi_start = (roi != nullptr) ? (*roi)[a] : 0.0;
+        double roi_end = (roi != nullptr) ? (*roi)[rank + a] : 1.0;
+        ResizeAxisTable t = resize_axis_table(shape[a], sizes[a], scales[a], mode,
+                                              coordinate_transformation_mode, nearest_mode,
+                                              cubic_coeff_a, antialias, exclude_outside,
+                                              roi_start, roi_end);
+        if (t.identity) continue;
+        axes.push_back(a);
+        tables.push_back(std::move(t));
+    }
+
+    if (axes.empty()) {
+        output = X;
+        return;
+    }
+
+    // Size of the largest intermediate result
+    std::vector<int> cur(shape);
+    long scratch_size = 0;
+    for (size_t i = 0; i + 1 < axes.size(); ++i) {
+        cur[axes[i]] = sizes[axes[i]];
+        long n = 1;
+        for (int d : cur) n *= d;
+        scratch_size = std::max(scratch_size, n);
+    }
+
+    runtime::ArenaScope scratch;
+    double* buffers[2] = {nullptr, nullptr};
+    if (axes.size() > 1) buffers[0] = scratch.vector(scratch_size).data();
+    if (axes.size() > 2) buffers[1] = scratch.vector(scratch_size).data();
+
+    cur = shape;
+    const double* src = X.data();
+    for (size_t i = 0; i < axes.size(); ++i) {
+        const int a = axes[i];
+        long outer = 1, inner = 1;
+        for (int d = 0; d < a; ++d) outer *= cur[d];
+        for (int d = a + 1; d < rank; ++d) inner *= cur[d];
+
+        double* dst = (i + 1 == axes.size()) ? output.data() : buffers[i % 2];
+        resize_axis(src, dst, outer, cur[a], sizes[a], inner, tables[i], extrapolation_value);
+        src = dst;
+        cur[a] = sizes[a];
+    }
+}
+
+/**
+ * ONNX Resize operator (N-D)
+ *
+ * テンソルをリサイズする。
+ * 出力を確保して resize_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param sizes 出力テンソルの形状
+ * @param scales 各軸のスケール係数 (座標変換に使用)
+ * @param mode 補間モード ("nearest", "linear", "cubic")
+ * @param coordinate_transformation_mode 座標変換モード (デフォルト: "half_pixel")
+ * @param nearest_mode nearest の丸め方 (デフォルト: "round_prefer_floor")
+ * @param cubic_coeff_a cubic 補間の係数 (デフォルト: -0.75)
+ * @param antialias 縮小時にアンチエイリアスフィルタを使用するか
+ * @param exclude_outside 入力範囲外のタップの重みを 0 にするか
+ * @param extrapolation_value tf_crop_and_resize で範囲外の出力に使う値
+ * @param roi 各軸の [start..., end...] (tf_crop_and_resize 用) - optional
+ * @return Y: リサイズされたテンソル (flattened, row-major)
+ */
+inline Eigen::VectorXd resize_with_sizes(const Eigen::VectorXd& X,
+                                         const std::vector<int>& shape,
+                                         const std::vector<int>& sizes,
+                                         const std::vector<double>& scales,
+                                         const std::string& mode = "nearest",
+                                         const std::string& coordinate_transformation_mode = "half_pixel",
+                                         const std::string& nearest_mode = "round_prefer_floor",
+                                         double cubic_coeff_a = -0.75,
+                                         bool antialias = false,
+                                         bool exclude_outside = false,
+                                         double extrapolation_value = 0.0,
+                                         const std::vector<double>* roi = nullptr) {
+    long size = 1;
+    for (int n : sizes) size *= n;
+
+    Eigen::VectorXd result(size);
+    resize_into(result, X, shape, sizes, scales, mode, coordinate_transformation_mode, nearest_mode,
+                cubic_coeff_a, antialias, exclude_outside, extrapolation_value, roi);
+    return result;
+}
+
+/**
+ * ONNX Resize operator (N-D, scales)
+ *
+ * テンソルをリサイズする。
+ * 出力形状は floor(shape[i] * scales[i]) (tf_crop_and_resize では roi の幅も掛ける)。
+ * 他のパラメータは resize_with_sizes() と同じ。
+ *
+ * @param X 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param scales 各軸のスケール係数
+ * @return Y: リサイズされたテンソル (flattened, row-major)
+ */
+inline Eigen::VectorXd resize(const Eigen::VectorXd& X,
+                              const std::vector<int>& shape,
+                              const std::vector<double>& scales,
+                              const std::string& mode = "nearest",
+                              const std::string& coordinate_transformation_mode = "half_pixel",
+                              const std::string& nearest_mode = "round_prefer_floor",
+                              double cubic_coeff_a = -0.75,
+                              bool antialias = false,
+                              bool exclude_outside = false,
+                              double extrapolation_value = 0.0,
+                              const std::vector<double>* roi = nullptr) {
+    const int rank = shape.size();
+    const bool crop = (coordinate_transformation_mode == "tf_crop_and_resize");
+
+    std::vector<int> sizes(rank);
+    for (int a = 0; a < rank; ++a) {
+        double extent = (crop && roi != nullptr) ? (*roi)[rank + a] - (*roi)[a] : 1.0;
+        sizes[a] = static_cast<int>(std::floor(shape[a] * extent * scales[a]));
+    }
+
+    return resize_with_sizes(X, shape, sizes, scales, mode, coordinate_transformation_mode,
+                             nearest_mode, cubic_coeff_a, antialias, exclude_outside,
+                             extrapolation_value, roi);
+}
+
+/**
+ * Helper function: 2D リサイズの共通部分
+ *
+ * 列優先の (rows, cols) 行列は行優先の (cols, rows) テンソルとして扱い、
+ * 連続する行方向を先に、列方向を後に処理する。
+ */
+inline Eigen::MatrixXd resize_2d(const Eigen::MatrixXd& X,
+                                 int output_rows, int output_cols,
+                                 double scale_row, double scale_col,
+                                 const std::string& mode,
+                                 const std::string& coordinate_transformation_mode,
+                                 const std::string& nearest_mode,
+                                 double cubic_coeff_a,
+                                 bool antialias,
+                                 bool exclude_outside) {
+    std::vector<double> scales = {scale_col, scale_row};
+    Eigen::VectorXd flat = Eigen::Map<const Eigen::VectorXd>(X.data(), X.size());
+    Eigen::VectorXd Y = resize_with_sizes(flat, {static_cast<int>(X.cols()), static_cast<int>(X.rows())},
+                                          {output_cols, output_rows}, scales, mode,
+                                          coordinate_transformation_mode, nearest_mode,
+                                          cubic_coeff_a, antialias, exclude_outside);
+    return Eigen::Map<Eigen::MatrixXd>(Y.data(), output_rows, output_cols);
+}
+
+/**
+ * ONNX Resize operator
+ *
+ * テンソルをリサイズする。
+ * nearest neighbor、linear (bilinear)、cubic (bicubic) 補間をサポート。
+ * 出力サイズは floor(入力サイズ * スケール)。
+ *
+ * @param X 入力テンソル
+ * @param scale_row 行方向のスケール係数
+ * @param scale_col 列方向のスケール係数
+ * @param mode 補間モード ("nearest", "linear", "cubic")
+ * @param coordinate_transformation_mode 座標変換モード (デフォルト: "half_pixel")
+ * @param nearest_mode nearest の丸め方 (デフォルト: "round_prefer_floor")
+ * @param cubic_coeff_a cubic 補間の係数 (デフォルト: -0.75)
+ * @param antialias 縮小時にアンチエイリアスフィルタを使用するか
+ * @param exclude_outside 入力範囲外のタップの重みを 0 にするか
+ * @return Y: リサイズされたテンソル
+ */
+template<typename Derived>
+Eigen::MatrixXd resize(const Eigen::MatrixBase<Derived>& X,
+                       double scale_row,
+                       double scale_col,
+                       const std::string& mode = "nearest",
+                       const std::string& coordinate_transformation_mode = "half_pixel",
+                       const std::string& nearest_mode = "round_prefer_floor",
+                       double cubic_coeff_a = -0.75,
+                       bool antialias = false,
+                       bool exclude_outside = false) {
+    int output_rows = static_cast<int>(std::floor(X.rows() * scale_row));
+    int output_cols = static_cast<int>(std::floor(X.cols() * scale_col));
+
+    return resize_2d(X.eval(), output_rows, output_cols, scale_row, scale_col, mode,
+                     coordinate_transformation_mode, nearest_mode, cubic_coeff_a,
+                     antialias, exclude_outside);
 }
 
 /**
@@ -90,17 +633,65 @@ Eigen::MatrixXd resize(const Eigen::MatrixBase<Derived>& X,
  * @param target_rows 出力の行数
  * @param target_cols 出力の列数
  * @param mode 補間モード
+ * @param coordinate_transformation_mode 座標変換モード
+ * @param nearest_mode nearest の丸め方
+ * @param cubic_coeff_a cubic 補間の係数
+ * @param antialias 縮小時にアンチエイリアスフィルタを使用するか
+ * @param exclude_outside 入力範囲外のタップの重みを 0 にするか
  * @return Y: リサイズされたテンソル
  */
 template<typename Derived>
 Eigen::MatrixXd resize(const Eigen::MatrixBase<Derived>& X,
                        int target_rows,
                        int target_cols,
-                       const std::string& mode = "nearest") {
+                       const std::string& mode = "nearest",
+                       const std::string& coordinate_transformation_mode = "half_pixel",
+                       const std::string& nearest_mode = "round_prefer_floor",
+                       double cubic_coeff_a = -0.75,
+                       bool antialias = false,
+                       bool exclude_outside = false) {
     double scale_row = static_cast<double>(target_rows) / X.rows();
     double scale_col = static_cast<double>(target_cols) / X.cols();
 
-    return resize(X, scale_row, scale_col, mode);
+    return resize_2d(X.eval(), target_rows, target_cols, scale_row, scale_col, mode,
+                     coordinate_transformation_mode, nearest_mode, cubic_coeff_a,
+                     antialias, exclude_outside);
+}
+
+/**
+ * ONNX Resize operator (NHWC)
+ *
+ * テンソルをリサイズする。
+ * 2D implementation for (1, H, W, C) channel-last input, using the same
+ * tables as resize(). The width pass and the height pass both operate on
+ * contiguous channel vectors.
+ *
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param C チャネル数
+ * @param scale_h 高さ方向のスケール係数
+ * @param scale_w 幅方向のスケール係数
+ * @param mode 補間モード ("nearest", "linear", "cubic")
+ * @param coordinate_transformation_mode 座標変換モード (デフォルト: "half_pixel")
+ * @param nearest_mode nearest の丸め方 (デフォルト: "round_prefer_floor")
+ * @param cubic_coeff_a cubic 補間の係数 (デフォルト: -0.75)
+ * @param antialias 縮小時にアンチエイリアスフィルタを使用するか
+ * @param exclude_outside 入力範囲外のタップの重みを 0 にするか
+ * @return Y: リサイズされたテンソル (flattened (out_h, out_w, C), row-major)
+ */
+inline Eigen::VectorXd resize_nhwc(const Eigen::VectorXd& X,
+                                   int H, int W, int C,
+                                   double scale_h,
+                                   double scale_w,
+                                   const std::string& mode = "nearest",
+                                   const std::string& coordinate_transformation_mode = "half_pixel",
+                                   const std::string& nearest_mode = "round_prefer_floor",
+                                   double cubic_coeff_a = -0.75,
+                                   bool antialias = false,
+                                   bool exclude_outside = false) {
+    return resize(X, {H, W, C}, {scale_h, scale_w, 1.0}, mode, coordinate_transformation_mode,
+                  nearest_mode, cubic_coeff_a, antialias, exclude_outside);
 }
 
 } // namespace onnx
@@ -0,0 +1,163 @@
+#ifndef ONNX_02_SCATTERELEMENTS_HPP
+#define ONNX_02_SCATTERELEMENTS_HPP
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace onnx {
+
+/**
+ * Helper function: 部分形状の各位置に対応する出力バッファ上のオフセット
+ *
+ * shape[begin:end] の全ての位置 (行優先) について、
+ * 出力テンソルのストライド strides[begin:end] でのオフセットを並べる。
+ */
+inline std::vector<long> scatterelements_offsets(const std::vector<int>& shape,
+                                                 const std::vector<long>& strides,
+                                                 int begin, int end) {
+    std::vector<long> offsets(1, 0);
+    for (int d = begin; d < end; ++d) {
+        std::vector<long> next;
+        next.reserve(offsets.size() * shape[d]);
+        for (long base : offsets) {
+            for (int i = 0; i < shape[d]; ++i) next.push_back(base + i * strides[d]);
+        }
+        offsets.swap(next);
+    }
+    return offsets;
+}
+
+/**
+ * ONNX ScatterElements operator (in-place)
+ *
+ * data を直接書き換えて、インデックステンソルの各要素が指す位置に更新値を散布する。
+ * output[..., indices[i_0, ..., i_{r-1}], ...] = updates[i_0, ..., i_{r-1}]
+ * Two updates can only collide when they differ in the axis coordinate
+ * alone, so the (outer, inner) positions are distributed over threads and
+ * each one walks its updates along the axis in order: no atomics, and
+ * duplicate indices are reduced in update order.
+ *
+ * @param data 入力テンソル (flattened, row-major)。結果で上書きされる
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major, 負の値は末尾から数える)
+ * @param indices_shape インデックスの形状 (data と同じランク)
+ * @param updates 更新値 (flattened, indices_shape, row-major)
+ * @param axis 散布する軸 (負の値は末尾から数える)
+ * @param reduction 集約方法 ("none", "add", "mul", "max", "min")
+ */
+template<typename IndexT>
+void scatterelements_inplace(Eigen::Ref<Eigen::VectorXd> data,
+                             const std::vector<int>& shape,
+                             const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                             const std::vector<int>& indices_shape,
+                             const Eigen::VectorXd& updates,
+                             int axis = 0,
+                             const std::string& reduction = "none") {
+    const int rank = shape.size();
+    if (axis < 0) axis += rank;
+
+    std::vector<long> strides(rank, 1);
+    for (int d = rank - 2; d >= 0; --d) strides[d] = strides[d + 1] * shape[d + 1];
+
+    const std::vector<long> outer_offsets = scatterelements_offsets(indices_shape, strides, 0, axis);
+    const std::vector<long> inner_offsets = scatterelements_offsets(indices_shape, strides, axis + 1, rank);
+    const long outer = outer_offsets.size();
+    const long inner = inner_offsets.size();
+    const long n = indices_shape[axis];
+    const long dim = shape[axis];
+    const long axis_stride = strides[axis];
+
+    const bool add = (reduction == "add");
+    const bool mul = (reduction == "mul");
+    const bool max = (reduction == "max");
+    const bool min = (reduction == "min");
+
+    double* dst = data.data();
+    const double* src = updates.data();
+    const IndexT* idx = indices.data();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long p = 0; p < outer * inner; ++p) {
+        const long o = p / inner;
+        const long i = p % inner;
+        double* base = dst + outer_offsets[o] + inner_offsets[i];
+
+        for (long j = 0; j < n; ++j) {
+            const long pos = (o * n + j) * inner + i;
+            long k = static_cast<long>(idx[pos]);
+            if (k < 0) k += dim;
+            double& y = base[k * axis_stride];
+            const double v = src[pos];
+
+            if (add) y += v;
+            else if (mul) y *= v;
+            else if (max) y = std::max(y, v);
+            else if (min) y = std::min(y, v);
+            else y = v;
+        }
+    }
+}
+
+/**
+ * ScatterElements を呼び出し側のバッファに書き込む
+ *
+ * data を output にコピーしてから scatterelements_inplace() を適用する。
+ * output に data 自身を渡すとコピーは省略される。
+ *
+ * @param output 出力 (data と同じ要素数、呼び出し側で確保)
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major)
+ * @param indices_shape インデックスの形状
+ * @param updates 更新値 (flattened, row-major)
+ * @param axis 散布する軸 (負の値は末尾から数える)
+ * @param reduction 集約方法 ("none", "add", "mul", "max", "min")
+ */
+template<typename IndexT>
+void scatterelements_into(Eigen::Ref<Eigen::VectorXd> output,
+                          const Eigen::VectorXd& data,
+                          const std::vector<int>& shape,
+                          const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                          const std::vector<int>& indices_shape,
+                          const Eigen::VectorXd& updates,
+                          int axis = 0,
+                          const std::string& reduction = "none") {
+    if (output.data() != data.data()) output = data;
+    scatterelements_inplace(output, shape, indices, indices_shape, updates, axis, reduction);
+}
+
+/**
+ * ONNX ScatterElements operator
+ *
+ * インデックステンソルの各要素が指す位置に更新値を散布する。
+ * data をコピーしてから scatterelements_inplace() を適用する。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major)
+ * @param indices_shape インデックスの形状
+ * @param updates 更新値 (flattened, indices_shape, row-major)
+ * @param axis 散布する軸 (負の値は末尾から数える)
+ * @param reduction 集約方法 ("none", "add", "mul", "max", "min")
+ * @return output: 更新されたテンソル (flattened, row-major)
+ */
+template<typename IndexT>
+Eigen::VectorXd scatterelements(const Eigen::VectorXd& data,
+                                const std::vector<int>& shape,
+                                const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                                const std::vector<int>& indices_shape,
+                                const Eigen::VectorXd& updates,
+                                int axis = 0,
+                                const std::string& reduction = "none") {
+    Eigen::VectorXd output = data;
+    scatterelements_inplace(output, shape, indices, indices_shape, updates, axis, reduction);
+    return output;
+}
+
+} // namespace onnx
+
+#endif // ONNX_02_SCATTERELEMENTS_HPP
@@ -2,8 +2,14 @@
 #define ONNX_02_SCATTERND_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <string>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace onnx {
 
 /**
@@ -63,6 +69,163 @@ Eigen::MatrixXd scatternd(const Eigen::MatrixBase<Derived>& data,
     return output;
 }
 
+/**
+ * Helper function: reduction 属性を内部コードに変換する
+ *
+ * "none" -> 0, "add" -> 1, "mul" -> 2, "max" -> 3, "min" -> 4
+ */
+inline int scatternd_reduction_code(const std::string& reduction) {
+    if (reduction == "add") return 1;
+    if (reduction == "mul") return 2;
+    if (reduction == "max") return 3;
+    if (reduction == "min") return 4;
+    return 0;
+}
+
+/**
+ * Helper function: 更新値の区間を出力に書き込む (reduction 付き)
+ */
+inline void scatternd_apply(double* dst, const double* src, long n, int reduction) {
+    switch (reduction) {
+    case 1: for (long i = 0; i < n; ++i) dst[i] += src[i]; break;
+    case 2: for (long i = 0; i < n; ++i) dst[i] *= src[i]; break;
+    case 3: for (long i = 0; i < n; ++i) dst[i] = std::max(dst[i], src[i]); break;
+    case 4: for (long i = 0; i < n; ++i) dst[i] = std::min(dst[i], src[i]); break;
+    default: std::copy(src, src + n, dst); break;
+    }
+}
+
+/**
+ * ONNX ScatterND operator (N-D, in-place)
+ *
+ * data を直接書き換えて、インデックスで指定された部分テンソルに更新値を散布する。
+ * 入力バッファが以降使われない場合 (例: KV キャッシュの更新) はコピーを省略できる。
+ * With k = indices_shape.back(), each index tuple addresses one contiguous
+ * slab of prod(shape[k:]) elements. Under OpenMP the work is partitioned by
+ * destination so that no two threads touch the same element: by slab (the
+ * owner of a slab applies all of its updates in order) when there are at
+ * least as many updates as threads, otherwise by column range within the
+ * slabs. No atomics are needed and duplicate indices are applied in order.
+ *
+ * @param data 入力テンソル (flattened, row-major)。結果で上書きされる
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major, 負の値は末尾から数える)
+ * @param indices_shape インデックスの形状
+ * @param updates 更新値 (flattened indices_shape[:-1] + shape[k:], row-major)
+ * @param reduction 集約方法 ("none", "add", "mul", "max", "min")
+ */
+template<typename IndexT>
+void scatternd_inplace(Eigen::Ref<Eigen::VectorXd> data,
+                       const std::vector<int>& shape,
+                       const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                       const std::vector<int>& indices_shape,
+                       const Eigen::VectorXd& updates,
+                       const std::string& reduction = "none") {
+    const int rank = shape.size();
+    const int k = indices_shape.back();
+    const int code = scatternd_reduction_code(reduction);
+
+    std::vector<long> strides(rank, 1);
+    for (int d = rank - 2; d >= 0; --d) strides[d] = strides[d + 1] * shape[d + 1];
+
+    long slab = 1;
+    for (int d = k; d < rank; ++d) slab *= shape[d];
+    long n = 1;
+    for (size_t d = 0; d + 1 < indices_shape.size(); ++d) n *= indices_shape[d];
+
+    // Destination offset of every update slab
+    std::vector<long> offsets(n);
+    const IndexT* idx = indices.data();
+    for (long u = 0; u < n; ++u) {
+        long offset = 0;
+        for (int j = 0; j < k; ++j) {
+            long i = static_cast<long>(idx[u * k + j]);
+            if (i < 0) i += shape[j];
+            offset += i * strides[j];
+        }
+        offsets[u] = offset;
+    }
+
+    double* dst = data.data();
+    const double* src = updates.data();
+
+#ifdef _OPENMP
+#pragma omp parallel
+    {
+        const int t = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+        if (n >= nt) {
+            for (long u = 0; u < n; ++u) {
+                if ((offsets[u] / std::max(slab, 1L)) % nt != t) continue;
+                scatternd_apply(dst + offsets[u], src + u * slab, slab, code);
+            }
+        } else {
+            const long c0 = slab * t / nt;
+            const long c1 = slab * (t + 1) / nt;
+            for (long u = 0; u < n; ++u) {
+                scatternd_apply(dst + offsets[u] + c0, src + u * slab + c0, c1 - c0, code);
+            }
+        }
+    }
+#else
+    for (long u = 0; u < n; ++u) {
+        scatternd_apply(dst + offsets[u], src + u * slab, slab, code);
+    }
+#endif
+}
+
+/**
+ * ScatterND を呼び出し側のバッファに書き込む
+ *
+ * data を output にコピーしてから scatternd_inplace() を適用する。
+ * output に data 自身を渡すとコピーは省略される。
+ *
+ * @param output 出力 (data と同じ要素数、呼び出し側で確保)
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major)
+ * @param indices_shape インデックスの形状
+ * @param updates 更新値 (flattened, row-major)
+ * @param reduction 集約方法 ("none", "add", "mul", "max", "min")
+ */
+template<typename IndexT>
+void scatternd_into(Eigen::Ref<Eigen::VectorXd> output,
+                    const Eigen::VectorXd& data,
+                    const std::vector<int>& shape,
+                    const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                    const std::vector<int>& indices_shape,
+                    const Eigen::VectorXd& updates,
+                    const std::string& reduction = "none") {
+    if (output.data() != data.data()) output = data;
+    scatternd_inplace(output, shape, indices, indices_shape, updates, reduction);
+}
+
+/**
+ * ONNX ScatterND operator (N-D)
+ *
+ * インデックスで指定された部分テンソルに更新値を散布する。
+ * data をコピーしてから scatternd_inplace() を適用する。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param indices インデックス (int32 / int64, flattened, row-major)
+ * @param indices_shape インデックスの形状
+ * @param updates 更新値 (flattened, row-major)
+ * @param reduction 集約方法 ("none", "add", "mul", "max", "min")
+ * @return output: 更新されたテンソル (flattened, row-major)
+ */
+template<typename IndexT>
+Eigen::VectorXd scatternd(const Eigen::VectorXd& data,
+                          const std::vector<int>& shape,
+                          const Eigen::Matrix<IndexT, Eigen::Dynamic, 1>& indices,
+                          const std::vector<int>& indices_shape,
+                          const Eigen::VectorXd& updates,
+                          const std::string& reduction = "none") {
+    Eigen::VectorXd output = data;
+    scatternd_inplace(output, shape, indices, indices_shape, updates, reduction);
+    return output;
+}
+
 } // namespace onnx
 
 #endif // ONNX_02_SCATTERND_HPP
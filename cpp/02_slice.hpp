@@ -2,14 +2,45 @@
 #define ONNX_02_SLICE_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <vector>
 
 namespace onnx {
 
+/**
+ * Helper function: 1軸分の開始位置と要素数を計算する
+ *
+ * ONNX の規則に従い、負の start / end に dim を加えてから範囲内に丸める。
+ * step > 0 では [0, dim]、step < 0 では start を [0, dim-1]、end を [-1, dim-1] に丸める。
+ *
+ * @param dim 軸のサイズ
+ * @param start 開始インデックス
+ * @param end 終了インデックス (含まない)
+ * @param step ステップ (0 以外)
+ * @param first 最初に取り出す要素の位置 (output)
+ * @param count 取り出す要素数 (output)
+ */
+inline void slice_clamp_range(int dim, long start, long end, long step, int& first, int& count) {
+    if (start < 0) start += dim;
+    if (end < 0) end += dim;
+
+    if (step > 0) {
+        start = std::max(0L, std::min(start, static_cast<long>(dim)));
+        end = std::max(0L, std::min(end, static_cast<long>(dim)));
+        count = (end > start) ? static_cast<int>((end - start + step - 1) / step) : 0;
+    } else {
+        start = std::max(0L, std::min(start, static_cast<long>(dim) - 1));
+        end = std::max(-1L, std::min(end, static_cast<long>(dim) - 1));
+        count = (start > end) ? static_cast<int>((start - end - step - 1) / -step) : 0;
+    }
+    first = static_cast<int>(start);
+}
+
 /**
  * ONNX Slice operator
  *
  * テンソルの一部を切り出す。
+ * 負の starts / ends / steps は ONNX と同じ規則で扱う。
  *
  * @param data 入力テンソル
  * @param starts 各軸の開始インデックスのリスト [row_start, col_start]
@@ -22,30 +53,18 @@ Eigen::MatrixXd slice_op(const Eigen::MatrixBase<Derived>& data,
                          const std::vector<int>& starts,
                          const std::vector<int>& ends,
                          const std::vector<int>& steps = {1, 1}) {
-    int row_start = starts[0];
-    int col_start = starts.size() > 1 ? starts[1] : 0;
-    int row_end = ends[0];
-    int col_end = ends.size() > 1 ? ends[1] : data.cols();
     int row_step = steps[0];
     int col_step = steps.size() > 1 ? steps[1] : 1;
 
-    // 計算結果のサイズ
-    int result_rows = (row_end - row_start + row_step - 1) / row_step;
-    int result_cols = (col_end - col_start + col_step - 1) / col_step;
-
-    Eigen::MatrixXd result(result_rows, result_cols);
+    int row_first, row_count, col_first, col_count;
+    slice_clamp_range(data.rows(), starts[0], ends[0], row_step, row_first, row_count);
+    slice_clamp_range(data.cols(),
+                      starts.size() > 1 ? starts[1] : 0,
+                      ends.size() > 1 ? ends[1] : data.cols(),
+                      col_step, col_first, col_count);
 
-    int out_row = 0;
-    for (int i = row_start; i < row_end; i += row_step) {
-        int out_col = 0;
-        for (int j = col_start; j < col_end; j += col_step) {
-            result(out_row, out_col) = data(i, j);
-            out_col++;
-        }
-        out_row++;
-    }
-
-    return result;
+    return data.derived()(Eigen::seqN(row_first, row_count, row_step),
+                          Eigen::seqN(col_first, col_count, col_step));
 }
 
 /**
@@ -64,29 +83,270 @@ Eigen::MatrixXd slice_op(const Eigen::MatrixBase<Derived>& data,
                          int end,
                          int axis = 0,
                          int step = 1) {
+    int first, count;
     if (axis == 0) {
         // 行方向のスライス
-        int result_rows = (end - start + step - 1) / step;
-        Eigen::MatrixXd result(result_rows, data.cols());
-
-        int out_row = 0;
-        for (int i = start; i < end; i += step) {
-            result.row(out_row) = data.row(i);
-            out_row++;
-        }
-        return result;
+        slice_clamp_range(data.rows(), start, end, step, first, count);
+        return data.derived()(Eigen::seqN(first, count, step), Eigen::all);
     } else {
         // 列方向のスライス
-        int result_cols = (end - start + step - 1) / step;
-        Eigen::MatrixXd result(data.rows(), result_cols);
+        slice_clamp_range(data.cols(), start, end, step, first, count);
+        return data.derived()(Eigen::all, Eigen::seqN(first, count, step));
+    }
+}
+
+/**
+ * Slice の結果を親バッファ上のストライド付きビューとして表したもの
+ *
+ * 出力要素 (i_0, ..., i_{r-1}) は data[offset + sum(i_k * strides[k])] に対応する。
+ */
+struct SliceLayout {
+    long offset;
+    std::vector<int> shape;
+    std::vector<long> strides;
+};
+
+/**
+ * Helper function: Slice の出力レイアウトを計算する
+ *
+ * @param shape 入力テンソルの形状
+ * @param starts 開始インデックス
+ * @param ends 終了インデックス (含まない)
+ * @param axes 操作する軸 - optional (省略時は 0, 1, ...)。負の値は末尾から数える
+ * @param steps ステップ - optional (省略時は1)
+ * @return 入力バッファ上のオフセット、出力形状、ストライド
+ */
+inline SliceLayout slice_layout(const std::vector<int>& shape,
+                                const std::vector<long>& starts,
+                                const std::vector<long>& ends,
+                                const std::vector<int>* axes = nullptr,
+                                const std::vector<long>* steps = nullptr) {
+    const int rank = shape.size();
+
+    SliceLayout layout;
+    layout.offset = 0;
+    layout.shape = shape;
+    layout.strides.assign(rank, 1);
+    for (int d = rank - 2; d >= 0; --d) layout.strides[d] = layout.strides[d + 1] * shape[d + 1];
+
+    for (size_t i = 0; i < starts.size(); ++i) {
+        int axis = (axes != nullptr) ? (*axes)[i] : static_cast<int>(i);
+        if (axis < 0) axis += rank;
+        long step = (steps != nullptr) ? (*steps)[i] : 1;
+
+        int first, count;
+        slice_clamp_range(shape[axis], starts[i], ends[i], step, first, count);
+
+        layout.offset += first * layout.strides[axis];
+        layout.shape[axis] = count;
+        layout.strides[axis] *= step;
+    }
+    return layout;
+}
+
+/**
+ * Helper function: ストライド付きビューの軸を簡約する
+ *
+ * サイズ1の軸を取り除き、メモリ上で連続する隣接軸を1つに結合する。
+ */
+inline void slice_reduce_layout(const SliceLayout& layout,
+                                std::vector<int>& shape,
+                                std::vector<long>& strides) {
+    shape.clear();
+    strides.clear();
+    for (size_t d = 0; d < layout.shape.size(); ++d) {
+        if (layout.shape[d] == 1) continue;
+        if (!shape.empty() && strides.back() == layout.strides[d] * layout.shape[d]) {
+            shape.back() *= layout.shape[d];
+            strides.back() = layout.strides[d];
+        } else {
+            shape.push_back(layout.shape[d]);
+            strides.push_back(layout.strides[d]);
+        }
+    }
+}
+
+/**
+ * Slice の結果が入力バッファの連続した区間かどうか
+ *
+ * @param layout slice_layout() の結果
+ * @return コピーせずに入力を参照できる場合 true
+ */
+inline bool slice_is_view(const SliceLayout& layout) {
+    for (int n : layout.shape) {
+        if (n == 0) return true;
+    }
+    std::vector<int> shape;
+    std::vector<long> strides;
+    slice_reduce_layout(layout, shape, strides);
+    return shape.empty() || (shape.size() == 1 && strides[0] == 1);
+}
+
+/**
+ * Slice の結果が2次元のストライド付きビューで表せるかどうか
+ *
+ * 簡約後の軸が2つ以下で、ストライドが全て正の場合 true。
+ * 例えば (B, S, 3*H*D) の最後の軸から Q / K / V を切り出す場合がこれに当たる。
+ */
+inline bool slice_is_strided_view(const SliceLayout& layout) {
+    std::vector<int> shape;
+    std::vector<long> strides;
+    slice_reduce_layout(layout, shape, strides);
+    if (shape.size() > 2) return false;
+    for (long s : strides) {
+        if (s <= 0) return false;
+    }
+    return true;
+}
+
+/**
+ * Zero-copy strided Slice (2D)
+ *
+ * slice_is_strided_view() が true のレイアウトを、入力バッファを参照する
+ * 行優先の (rows x cols) ビューとして返す。rows * cols は出力要素数に等しい。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param layout slice_layout() の結果
+ * @return 出力テンソルを参照するストライド付きビュー
+ */
+inline Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
+                  0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>
+slice_strided_view(const Eigen::VectorXd& data, const SliceLayout& layout) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+    typedef Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> DynStride;
+
+    std::vector<int> shape;
+    std::vector<long> strides;
+    slice_reduce_layout(layout, shape, strides);
+    while (shape.size() < 2) {
+        shape.insert(shape.begin(), 1);
+        strides.insert(strides.begin(), strides.empty() ? 1 : strides[0] * shape[1]);
+    }
+    return Eigen::Map<const RowMatrix, 0, DynStride>(data.data() + layout.offset, shape[0], shape[1],
+                                                     DynStride(strides[0], strides[1]));
+}
+
+/**
+ * Slice (N-D) を呼び出し側のバッファに書き込む
+ *
+ * The layout is reduced first (size-1 axes dropped, contiguous axes merged),
+ * then the innermost run is copied with std::copy when its stride is 1 and
+ * by a strided loop otherwise (negative steps included).
+ *
+ * @param output 出力 (prod(layout.shape) 要素、呼び出し側で確保、data と重ならないこと)
+ * @param data 入力テンソル (flattened, row-major)
+ * @param layout slice_layout() の結果
+ */
+inline void slice_into(Eigen::Ref<Eigen::VectorXd> output,
+                       const Eigen::VectorXd& data,
+                       const SliceLayout& layout) {
+    long total = 1;
+    for (int n : layout.shape) total *= n;
+    if (total == 0) return;
+
+    std::vector<int> rshape;
+    std::vector<long> rstrides;
+    slice_reduce_layout(layout, rshape, rstrides);
+    if (rshape.empty()) {
+        rshape.push_back(1);
+        rstrides.push_back(1);
+    }
+
+    const int rank = rshape.size();
+    const int inner = rshape[rank - 1];
+    const long inner_stride = rstrides[rank - 1];
+    const long rows = total / inner;
+
+    std::vector<int> idx(rank - 1, 0);
+    const double* src = data.data() + layout.offset;
+    double* dst = output.data();
 
-        int out_col = 0;
-        for (int j = start; j < end; j += step) {
-            result.col(out_col) = data.col(j);
-            out_col++;
+    for (long r = 0; r < rows; ++r, dst += inner) {
+        if (inner_stride == 1) {
+            std::copy(src, src + inner, dst);
+        } else {
+            for (int j = 0; j < inner; ++j) dst[j] = src[j * inner_stride];
         }
-        return result;
+
+        // Advance odometer
+        for (int d = rank - 2; d >= 0; --d) {
+            src += rstrides[d];
+            if (++idx[d] < rshape[d]) break;
+            src -= rstrides[d] * rshape[d];
+            idx[d] = 0;
+        }
+    }
+}
+
+/**
+ * ONNX Slice operator (N-D)
+ *
+ * テンソルの一部を切り出す。
+ * 出力を確保して slice_into() を呼ぶ。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param starts 開始インデックス
+ * @param ends 終了インデックス (含まない)
+ * @param axes 操作する軸 - optional
+ * @param steps ステップ - optional
+ * @param output_shape 出力テンソルの形状 - optional output
+ * @return output: スライスされたテンソル (flattened, row-major)
+ */
+inline Eigen::VectorXd slice(const Eigen::VectorXd& data,
+                             const std::vector<int>& shape,
+                             const std::vector<long>& starts,
+                             const std::vector<long>& ends,
+                             const std::vector<int>* axes = nullptr,
+                             const std::vector<long>* steps = nullptr,
+                             std::vector<int>* output_shape = nullptr) {
+    SliceLayout layout = slice_layout(shape, starts, ends, axes, steps);
+    if (output_shape != nullptr) *output_shape = layout.shape;
+
+    long total = 1;
+    for (int n : layout.shape) total *= n;
+    Eigen::VectorXd result(total);
+    slice_into(result, data, layout);
+    return result;
+}
+
+/**
+ * Zero-copy Slice (N-D)
+ *
+ * 結果が入力バッファの連続した区間であれば、その区間を参照するビューを返す。
+ * それ以外の場合は storage に切り出した結果を書き込み、そのビューを返す。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param starts 開始インデックス
+ * @param ends 終了インデックス (含まない)
+ * @param axes 操作する軸 - optional
+ * @param steps ステップ - optional
+ * @param output_shape 出力テンソルの形状 (output)
+ * @param storage コピーが必要な場合の書き込み先
+ * @return 出力テンソルを参照するビュー
+ */
+inline Eigen::Map<const Eigen::VectorXd> slice_view(const Eigen::VectorXd& data,
+                                                    const std::vector<int>& shape,
+                                                    const std::vector<long>& starts,
+                                                    const std::vector<long>& ends,
+                                                    const std::vector<int>* axes,
+                                                    const std::vector<long>* steps,
+                                                    std::vector<int>& output_shape,
+                                                    Eigen::VectorXd& storage) {
+    SliceLayout layout = slice_layout(shape, starts, ends, axes, steps);
+    output_shape = layout.shape;
+
+    if (slice_is_view(layout)) {
+        long total = 1;
+        for (int n : layout.shape) total *= n;
+        return Eigen::Map<const Eigen::VectorXd>(data.data() + (total > 0 ? layout.offset : 0), total);
     }
+    long total = 1;
+    for (int n : layout.shape) total *= n;
+    storage.resize(total);
+    slice_into(storage, data, layout);
+    return Eigen::Map<const Eigen::VectorXd>(storage.data(), storage.size());
 }
 
 } // namespace onnx
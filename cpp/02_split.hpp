@@ -2,6 +2,7 @@
 #define ONNX_02_SPLIT_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <vector>
 
 namespace onnx {
@@ -84,6 +85,145 @@ std::vector<Eigen::MatrixXd> split(const Eigen::MatrixBase<Derived>& input_tenso
     return outputs;
 }
 
+/**
+ * Helper function: Split の各出力の軸方向サイズを計算する
+ *
+ * split が指定されていればそれを使い、なければ num_outputs 個に分割する。
+ * 割り切れない場合は ONNX (opset 18) と同様に ceil(dim / num_outputs) ずつ取り、
+ * 最後の出力を小さくする。
+ */
+inline std::vector<int> split_output_sizes(int dim, int num_outputs,
+                                           const std::vector<int>* split = nullptr) {
+    if (split != nullptr) return *split;
+
+    std::vector<int> sizes;
+    const int chunk = (dim + num_outputs - 1) / num_outputs;
+    for (int start = 0; start < dim; start += chunk) {
+        sizes.push_back(std::min(chunk, dim - start));
+    }
+    return sizes;
+}
+
+/**
+ * Zero-copy Split (N-D)
+ *
+ * テンソルを指定された軸に沿って分割し、各出力を入力バッファへのビューとして返す。
+ * With outer = prod(shape[:axis]) and inner = prod(shape[axis+1:]), output k
+ * is the row-major (outer x sizes[k] * inner) block starting at column
+ * offset_k * inner, with row stride shape[axis] * inner. When axis is the
+ * outermost non-unit axis the views are contiguous.
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param axis 分割する軸 (負の値は末尾から数える)
+ * @param sizes 各出力の軸方向サイズ (split_output_sizes() を参照)
+ * @param output_shapes 各出力の形状 (output)
+ * @return 各出力を参照するストライド付きビューのリスト
+ */
+inline std::vector<Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>,
+                              0, Eigen::OuterStride<>>>
+split_view(const Eigen::VectorXd& data,
+           const std::vector<int>& shape,
+           int axis,
+           const std::vector<int>& sizes,
+           std::vector<std::vector<int>>& output_shapes) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+    typedef Eigen::Map<const RowMatrix, 0, Eigen::OuterStride<>> View;
+
+    const int rank = shape.size();
+    if (axis < 0) axis += rank;
+
+    long outer = 1, inner = 1;
+    for (int d = 0; d < axis; ++d) outer *= shape[d];
+    for (int d = axis + 1; d < rank; ++d) inner *= shape[d];
+    const long row_stride = shape[axis] * inner;
+
+    std::vector<View> views;
+    output_shapes.clear();
+    long offset = 0;
+    for (int size : sizes) {
+        views.emplace_back(data.data() + offset, outer, size * inner,
+                           Eigen::OuterStride<>(std::max(row_stride, 1L)));
+        output_shapes.push_back(shape);
+        output_shapes.back()[axis] = size;
+        offset += size * inner;
+    }
+    return views;
+}
+
+/**
+ * Split (N-D) を呼び出し側のバッファに書き込む
+ *
+ * 各出力を split_view() から1回のブロックコピーで書き込む。
+ * outputs[k] が nullptr の出力は書き込まない (ビューのまま使う場合など)。
+ *
+ * @param outputs 各出力 (outer * sizes[k] * inner 要素、呼び出し側で確保)。nullptr は省略
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param axis 分割する軸 (負の値は末尾から数える)
+ * @param sizes 各出力の軸方向サイズ
+ */
+inline void split_into(const std::vector<Eigen::VectorXd*>& outputs,
+                       const Eigen::VectorXd& data,
+                       const std::vector<int>& shape,
+                       int axis,
+                       const std::vector<int>& sizes) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+
+    std::vector<std::vector<int>> shapes;
+    auto views = split_view(data, shape, axis, sizes, shapes);
+
+    for (size_t k = 0; k < views.size(); ++k) {
+        if (outputs[k] == nullptr) continue;
+        Eigen::Map<RowMatrix>(outputs[k]->data(), views[k].rows(), views[k].cols()) = views[k];
+    }
+}
+
+/**
+ * ONNX Split operator (N-D)
+ *
+ * テンソルを指定された軸に沿って分割する。
+ * 出力を確保して split_into() を呼ぶ。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param axis 分割する軸 (負の値は末尾から数える)
+ * @param sizes 各出力の軸方向サイズ
+ * @param output_shapes 各出力の形状 - optional output
+ * @return outputs: 分割されたテンソルのリスト (flattened, row-major)
+ */
+inline std::vector<Eigen::VectorXd> split(const Eigen::VectorXd& data,
+                                          const std::vector<int>& shape,
+                                          int axis,
+                                          const std::vector<int>& sizes,
+                                          std::vector<std::vector<int>>* output_shapes = nullptr) {
+    const int rank = shape.size();
+    const int a = (axis < 0) ? axis + rank : axis;
+
+    long outer_inner = 1;
+    for (int d = 0; d < rank; ++d) {
+        if (d != a) outer_inner *= shape[d];
+    }
+
+    std::vector<Eigen::VectorXd> outputs;
+    std::vector<Eigen::VectorXd*> slots;
+    outputs.reserve(sizes.size());
+    for (int size : sizes) {
+        outputs.emplace_back(outer_inner * size);
+        slots.push_back(&outputs.back());
+    }
+    split_into(slots, data, shape, axis, sizes);
+
+    if (output_shapes != nullptr) {
+        output_shapes->clear();
+        for (int size : sizes) {
+            output_shapes->push_back(shape);
+            output_shapes->back()[a] = size;
+        }
+    }
+    return outputs;
+}
+
 } // namespace onnx
 
 #endif // ONNX_02_SPLIT_HPP
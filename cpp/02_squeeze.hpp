@@ -29,11 +29,7 @@ Eigen::MatrixXd squeeze(const Eigen::MatrixBase<Derived>& data, int axis = -1) {
             return data.eval();
         } else if (rows == 1) {
             // (1, n) -> (n, 1)
-            Eigen::MatrixXd result(cols, 1);
-            for (int i = 0; i < cols; ++i) {
-                result(i, 0) = data(0, i);
-            }
-            return result;
+            return data.transpose().eval();
         } else if (cols == 1) {
             // (n, 1) -> そのまま (既に列ベクトル)
             return data.eval();
@@ -44,11 +40,7 @@ Eigen::MatrixXd squeeze(const Eigen::MatrixBase<Derived>& data, int axis = -1) {
     } else if (axis == 0) {
         // 軸0を削除 (行が1の場合)
         if (rows == 1) {
-            Eigen::MatrixXd result(cols, 1);
-            for (int i = 0; i < cols; ++i) {
-                result(i, 0) = data(0, i);
-            }
-            return result;
+            return data.transpose().eval();
         } else {
             return data.eval();
         }
@@ -65,6 +57,49 @@ Eigen::MatrixXd squeeze(const Eigen::MatrixBase<Derived>& data, int axis = -1) {
     return data.eval();
 }
 
+/**
+ * Helper function: Squeeze の出力形状を計算する
+ *
+ * axes が指定されていればその軸 (サイズ1) を、なければサイズ1の全ての軸を削除する。
+ * 負の軸は末尾から数える。
+ */
+inline std::vector<int> squeeze_output_shape(const std::vector<int>& shape,
+                                             const std::vector<int>* axes = nullptr) {
+    const int rank = shape.size();
+    std::vector<char> drop(rank, 0);
+    if (axes != nullptr) {
+        for (int a : *axes) drop[a < 0 ? a + rank : a] = 1;
+    } else {
+        for (int d = 0; d < rank; ++d) drop[d] = (shape[d] == 1);
+    }
+
+    std::vector<int> out;
+    for (int d = 0; d < rank; ++d) {
+        if (!drop[d]) out.push_back(shape[d]);
+    }
+    return out;
+}
+
+/**
+ * Zero-copy Squeeze (N-D)
+ *
+ * ONNX Squeeze をメタデータのみの操作として行う。
+ * サイズ1の軸の削除はデータの並びを変えないため、入力をそのまま参照する。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param axes 削除する軸 - optional (省略時はサイズ1の全ての軸)
+ * @param output_shape 出力テンソルの形状 (output)
+ * @return 出力テンソルを参照するビュー
+ */
+inline Eigen::Map<const Eigen::VectorXd> squeeze_view(const Eigen::VectorXd& data,
+                                                      const std::vector<int>& shape,
+                                                      const std::vector<int>* axes,
+                                                      std::vector<int>& output_shape) {
+    output_shape = squeeze_output_shape(shape, axes);
+    return Eigen::Map<const Eigen::VectorXd>(data.data(), data.size());
+}
+
 } // namespace onnx
 
 #endif // ONNX_02_SQUEEZE_HPP
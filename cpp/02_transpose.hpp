@@ -2,6 +2,8 @@
 #define ONNX_02_TRANSPOSE_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <vector>
 
 namespace onnx {
 
@@ -19,6 +21,340 @@ auto transpose(const Eigen::MatrixBase<Derived>& data) {
     return data.transpose().eval();
 }
 
+/**
+ * Helper function: 置換を簡約する
+ *
+ * サイズ1の軸を取り除き、置換後も隣接したままの軸を1つに結合する。
+ * 空の perm は ONNX の既定値 (軸の逆順) として扱う。
+ *
+ * @param shape 入力テンソルの形状
+ * @param perm 軸の置換
+ * @param reduced_shape 簡約後の入力形状 (output)
+ * @param reduced_perm 簡約後の置換 (output)
+ */
+inline void transpose_reduce(const std::vector<int>& shape,
+                             const std::vector<int>& perm,
+                             std::vector<int>& reduced_shape,
+                             std::vector<int>& reduced_perm) {
+    const int rank = shape.size();
+
+    std::vector<int> p(perm);
+    if (p.empty()) {
+        for (int d = rank - 1; d >= 0; --d) p.push_back(d);
+    }
+
+    // Drop size-1 axes and renumber the remaining ones
+    std::vector<int> new_index(rank, -1);
+    std::vector<int> kept_shape;
+    for (int d = 0; d < rank; ++d) {
+        if (shape[d] != 1) {
+            new_index[d] = kept_shape.size();
+            kept_shape.push_back(shape[d]);
+        }
+    }
+    std::vector<int> kept_perm;
+    for (int k = 0; k < rank; ++k) {
+        if (new_index[p[k]] >= 0) kept_perm.push_back(new_index[p[k]]);
+    }
+
+    // Merge runs that are consecutive in both input and output order
+    std::vector<int> group_of(kept_shape.size(), -1);
+    std::vector<int> group_start;
+    for (size_t k = 0; k < kept_perm.size(); ++k) {
+        if (k > 0 && kept_perm[k] == kept_perm[k - 1] + 1) {
+            group_of[kept_perm[k]] = group_of[kept_perm[k - 1]];
+        } else {
+            group_of[kept_perm[k]] = group_start.size();
+            group_start.push_back(kept_perm[k]);
+        }
+    }
+
+    // Number groups in input order
+    std::vector<int> group_rank(group_start.size());
+    std::vector<int> order(group_start.size());
+    for (size_t g = 0; g < order.size(); ++g) order[g] = g;
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b) { return group_start[a] < group_start[b]; });
+    for (size_t i = 0; i < order.size(); ++i) group_rank[order[i]] = i;
+
+    reduced_shape.assign(group_start.size(), 1);
+    for (size_t d = 0; d < kept_shape.size(); ++d) {
+        reduced_shape[group_rank[group_of[d]]] *= kept_shape[d];
+    }
+    reduced_perm.clear();
+    for (size_t g = 0; g < group_start.size(); ++g) {
+        reduced_perm.push_back(group_rank[g]);
+    }
+}
+
+/**
+ * Helper function: キャッシュブロッキングした2D転置
+ *
+ * dst[c * ldd + r] = src[r * lds + c] を 32x32 のタイル単位で行う。
+ * タイル内部は 4x4 の固定サイズブロックで転置し、レジスタ上で入れ替える。
+ */
+inline void transpose_2d_blocked(const double* src, long lds,
+                                 double* dst, long ldd,
+                                 int rows, int cols) {
+    typedef Eigen::Matrix<double, 4, 4, Eigen::RowMajor> Tile;
+    const int block = 32;
+
+    for (int r0 = 0; r0 < rows; r0 += block) {
+        const int r1 = std::min(r0 + block, rows);
+        for (int c0 = 0; c0 < cols; c0 += block) {
+            const int c1 = std::min(c0 + block, cols);
+
+            int r = r0;
+            for (; r + 4 <= r1; r += 4) {
+                int c = c0;
+                for (; c + 4 <= c1; c += 4) {
+                    Eigen::Map<const Tile, 0, Eigen::OuterStride<>> s(
+                        src + r * lds + c, Eigen::OuterStride<>(lds));
+                    Eigen::Map<Tile, 0, Eigen::OuterStride<>> d(
+                        dst + c * ldd + r, Eigen::OuterStride<>(ldd));
+                    d = s.transpose();
+                }
+                for (; c < c1; ++c) {
+                    for (int rr = r; rr < r + 4; ++rr) {
+                        dst[c * ldd + rr] = src[rr * lds + c];
+                    }
+                }
+            }
+            for (; r < r1; ++r) {
+                for (int c = c0; c < c1; ++c) {
+                    dst[c * ldd + r] = src[r * lds + c];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * 置換がメモリ上の並びを変えないかどうか
+ *
+ * サイズ1の軸の移動のみ、または恒等置換の場合は true。
+ * このときデータをコピーせずに形状だけを変えればよい。
+ *
+ * @param shape 入力テンソルの形状
+ * @param perm 軸の置換 (空の場合は逆順)
+ * @return 転置がメタデータのみで済む場合 true
+ */
+inline bool transpose_is_view(const std::vector<int>& shape, const std::vector<int>& perm) {
+    std::vector<int> reduced_shape, reduced_perm;
+    transpose_reduce(shape, perm, reduced_shape, reduced_perm);
+    return reduced_perm.size() <= 1;
+}
+
+/**
+ * Transpose (N-D) を呼び出し側のバッファに書き込む
+ *
+ * Adjacent axes are merged first; the kernel then either copies contiguous
+ * rows (innermost axis unchanged) or runs a cache-blocked 2D transpose over
+ * the input-innermost and output-innermost axes.
+ *
+ * @param output 出力 (data と同じ要素数、呼び出し側で確保、data と重ならないこと)
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param perm 軸の置換 (空の場合は逆順)。出力形状は shape[perm[k]]
+ */
+inline void transpose_into(Eigen::Ref<Eigen::VectorXd> output,
+                           const Eigen::VectorXd& data,
+                           const std::vector<int>& shape,
+                           const std::vector<int>& perm) {
+    std::vector<int> in_shape, p;
+    transpose_reduce(shape, perm, in_shape, p);
+
+    const int rank = in_shape.size();
+    if (rank <= 1) {
+        output = data;
+        return;
+    }
+
+    // Strides of the reduced input (row-major)
+    std::vector<long> in_stride(rank);
+    in_stride[rank - 1] = 1;
+    for (int d = rank - 2; d >= 0; --d) in_stride[d] = in_stride[d + 1] * in_shape[d + 1];
+
+    // Output shape / strides in output axis order
+    std::vector<int> out_shape(rank);
+    std::vector<long> out_stride(rank);
+    for (int k = 0; k < rank; ++k) out_shape[k] = in_shape[p[k]];
+    out_stride[rank - 1] = 1;
+    for (int k = rank - 2; k >= 0; --k) out_stride[k] = out_stride[k + 1] * out_shape[k + 1];
+
+    // Position of the input-innermost axis in the output
+    int qa = 0;
+    while (p[qa] != rank - 1) ++qa;
+    const int b = p[rank - 1];
+
+    // Remaining output axes iterated by an odometer
+    std::vector<int> outer_axes;
+    for (int k = 0; k < rank - 1; ++k) {
+        if (k != qa) outer_axes.push_back(k);
+    }
+    long outer_count = 1;
+    for (int k : outer_axes) outer_count *= out_shape[k];
+
+    std::vector<int> idx(outer_axes.size(), 0);
+    long in_base = 0;
+    long out_base = 0;
+
+    for (long n = 0; n < outer_count; ++n) {
+        if (b == rank - 1) {
+            // Innermost axis unchanged: contiguous row copy
+            std::copy(data.data() + in_base, data.data() + in_base + in_shape[b],
+                      output.data() + out_base);
+        } else {
+            transpose_2d_blocked(data.data() + in_base, in_stride[b],
+                                 output.data() + out_base, out_stride[qa],
+                                 in_shape[b], in_shape[rank - 1]);
+        }
+
+        // Advance odometer
+        for (int i = static_cast<int>(outer_axes.size()) - 1; i >= 0; --i) {
+            const int k = outer_axes[i];
+            in_base += in_stride[p[k]];
+            out_base += out_stride[k];
+            if (++idx[i] < out_shape[k]) break;
+            in_base -= in_stride[p[k]] * out_shape[k];
+            out_base -= out_stride[k] * out_shape[k];
+            idx[i] = 0;
+        }
+    }
+}
+
+/**
+ * ONNX Transpose operator (N-D)
+ *
+ * テンソルの次元を perm に従って入れ替える。
+ * 出力を確保して transpose_into() を呼ぶ。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param perm 軸の置換 (空の場合は逆順)。出力形状は shape[perm[k]]
+ * @return transposed: 転置されたテンソル (flattened, row-major)
+ */
+inline Eigen::VectorXd transpose(const Eigen::VectorXd& data,
+                                 const std::vector<int>& shape,
+                                 const std::vector<int>& perm) {
+    Eigen::VectorXd result(data.size());
+    transpose_into(result, data, shape, perm);
+    return result;
+}
+
+/**
+ * Zero-copy Transpose
+ *
+ * メモリ配置が変わらない置換では入力をそのまま参照するビューを返す。
+ * それ以外の場合は storage に転置結果を書き込み、そのビューを返す。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param perm 軸の置換 (空の場合は逆順)
+ * @param storage 転置が必要な場合の書き込み先
+ * @return 出力テンソルを参照するビュー
+ */
+inline Eigen::Map<const Eigen::VectorXd> transpose_view(const Eigen::VectorXd& data,
+                                                        const std::vector<int>& shape,
+                                                        const std::vector<int>& perm,
+                                                        Eigen::VectorXd& storage) {
+    if (transpose_is_view(shape, perm)) {
+        return Eigen::Map<const Eigen::VectorXd>(data.data(), data.size());
+    }
+    storage.resize(data.size());
+    transpose_into(storage, data, shape, perm);
+    return Eigen::Map<const Eigen::VectorXd>(storage.data(), storage.size());
+}
+
+/**
+ * NCHW -> NCHWc レイアウト変換 (呼び出し側のバッファに書き込む)
+ *
+ * チャネルを block 個ずつにまとめ、各ブロックを (H, W, block) として並べる。
+ * C が block の倍数でない場合、末尾のチャネルは 0 で埋める。
+ *
+ * @param output 出力 (ceil(C/block) * H * W * block 要素、呼び出し側で確保)
+ * @param data 入力テンソル (flattened (C, H, W), row-major)
+ * @param C チャネル数
+ * @param H 高さ
+ * @param W 幅
+ * @param block チャネルブロックサイズ
+ */
+inline void nchw_to_nchwc_into(Eigen::Ref<Eigen::VectorXd> output,
+                               const Eigen::VectorXd& data, int C, int H, int W, int block) {
+    const int blocks = (C + block - 1) / block;
+    const long hw = static_cast<long>(H) * W;
+
+    if (C % block != 0) output.setZero();
+    for (int cb = 0; cb < blocks; ++cb) {
+        int valid = std::min(block, C - cb * block);
+        transpose_2d_blocked(data.data() + cb * block * hw, hw,
+                             output.data() + cb * hw * block, block,
+                             valid, hw);
+    }
+}
+
+/**
+ * NCHW -> NCHWc レイアウト変換
+ *
+ * nchw_to_nchwc_into() の出力を確保して返す。
+ *
+ * @param data 入力テンソル (flattened (C, H, W), row-major)
+ * @param C チャネル数
+ * @param H 高さ
+ * @param W 幅
+ * @param block チャネルブロックサイズ
+ * @return 変換後のテンソル (flattened (ceil(C/block), H, W, block), row-major)
+ */
+inline Eigen::VectorXd nchw_to_nchwc(const Eigen::VectorXd& data, int C, int H, int W, int block) {
+    const int blocks = (C + block - 1) / block;
+    Eigen::VectorXd result(static_cast<long>(blocks) * H * W * block);
+    nchw_to_nchwc_into(result, data, C, H, W, block);
+    return result;
+}
+
+/**
+ * NCHWc -> NCHW レイアウト変換 (呼び出し側のバッファに書き込む)
+ *
+ * nchw_to_nchwc() の逆変換。埋め草のチャネルは捨てる。
+ *
+ * @param output 出力 (C * H * W 要素、呼び出し側で確保)
+ * @param data 入力テンソル (flattened (ceil(C/block), H, W, block), row-major)
+ * @param C チャネル数
+ * @param H 高さ
+ * @param W 幅
+ * @param block チャネルブロックサイズ
+ */
+inline void nchwc_to_nchw_into(Eigen::Ref<Eigen::VectorXd> output,
+                               const Eigen::VectorXd& data, int C, int H, int W, int block) {
+    const int blocks = (C + block - 1) / block;
+    const long hw = static_cast<long>(H) * W;
+
+    for (int cb = 0; cb < blocks; ++cb) {
+        int valid = std::min(block, C - cb * block);
+        transpose_2d_blocked(data.data() + cb * hw * block, block,
+                             output.data() + cb * block * hw, hw,
+                             hw, valid);
+    }
+}
+
+/**
+ * NCHWc -> NCHW レイアウト変換
+ *
+ * nchwc_to_nchw_into() の出力を確保して返す。
+ *
+ * @param data 入力テンソル (flattened (ceil(C/block), H, W, block), row-major)
+ * @param C チャネル数
+ * @param H 高さ
+ * @param W 幅
+ * @param block チャネルブロックサイズ
+ * @return 変換後のテンソル (flattened (C, H, W), row-major)
+ */
+inline Eigen::VectorXd nchwc_to_nchw(const Eigen::VectorXd& data, int C, int H, int W, int block) {
+    Eigen::VectorXd result(static_cast<long>(C) * H * W);
+    nchwc_to_nchw_into(result, data, C, H, W, block);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_02_TRANSPOSE_HPP
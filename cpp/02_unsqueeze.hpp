@@ -2,6 +2,7 @@
 #define ONNX_02_UNSQUEEZE_HPP
 
 #include <Eigen/Dense>
+#include <vector>
 
 namespace onnx {
 
@@ -17,26 +18,15 @@ namespace onnx {
  */
 template<typename Derived>
 Eigen::MatrixXd unsqueeze(const Eigen::MatrixBase<Derived>& data, int axis) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+
     int rows = data.rows();
     int cols = data.cols();
 
-    if (axis == 0) {
-        // 軸0に次元追加: (n, m) -> (1, n*m)
-        Eigen::MatrixXd result(1, rows * cols);
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result(0, i * cols + j) = data(i, j);
-            }
-        }
-        return result;
-    } else if (axis == 2 || axis == -1) {
-        // 軸2に次元追加: (n, m) -> (n*m, 1)
-        Eigen::MatrixXd result(rows * cols, 1);
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                result(i * cols + j, 0) = data(i, j);
-            }
-        }
+    if (axis == 0 || axis == 2 || axis == -1) {
+        // 軸0に次元追加: (n, m) -> (1, n*m)、軸2に次元追加: (n, m) -> (n*m, 1)
+        Eigen::MatrixXd result = (axis == 0) ? Eigen::MatrixXd(1, rows * cols) : Eigen::MatrixXd(rows * cols, 1);
+        Eigen::Map<RowMatrix>(result.data(), rows, cols) = data;
         return result;
     } else {
         // axis == 1 or default: そのまま返す（2D行列として既に2次元）
@@ -44,6 +34,45 @@ Eigen::MatrixXd unsqueeze(const Eigen::MatrixBase<Derived>& data, int axis) {
     }
 }
 
+/**
+ * Helper function: Unsqueeze の出力形状を計算する
+ *
+ * axes は出力テンソルの軸番号 (負の値は出力の末尾から数える)。
+ */
+inline std::vector<int> unsqueeze_output_shape(const std::vector<int>& shape,
+                                               const std::vector<int>& axes) {
+    const int out_rank = shape.size() + axes.size();
+    std::vector<char> inserted(out_rank, 0);
+    for (int a : axes) inserted[a < 0 ? a + out_rank : a] = 1;
+
+    std::vector<int> out(out_rank);
+    int k = 0;
+    for (int d = 0; d < out_rank; ++d) {
+        out[d] = inserted[d] ? 1 : shape[k++];
+    }
+    return out;
+}
+
+/**
+ * Zero-copy Unsqueeze (N-D)
+ *
+ * ONNX Unsqueeze をメタデータのみの操作として行う。
+ * サイズ1の軸の追加はデータの並びを変えないため、入力をそのまま参照する。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param axes 追加する軸 (出力テンソルでの位置)
+ * @param output_shape 出力テンソルの形状 (output)
+ * @return 出力テンソルを参照するビュー
+ */
+inline Eigen::Map<const Eigen::VectorXd> unsqueeze_view(const Eigen::VectorXd& data,
+                                                        const std::vector<int>& shape,
+                                                        const std::vector<int>& axes,
+                                                        std::vector<int>& output_shape) {
+    output_shape = unsqueeze_output_shape(shape, axes);
+    return Eigen::Map<const Eigen::VectorXd>(data.data(), data.size());
+}
+
 } // namespace onnx
 
 #endif // ONNX_02_UNSQUEEZE_HPP
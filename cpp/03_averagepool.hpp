@@ -2,16 +2,102 @@
 #define ONNX_03_AVERAGEPOOL_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <vector>
+#include "03_maxpool.hpp"  // maxpool_output_size (MaxPool と同じ出力サイズ)
 
 namespace onnx {
 
 /**
- * ONNX AveragePool operator
+ * Helper function: 1軸ごとの除数
+ *
+ * count_include_pad の場合はパディング領域 [-pad_begin, n + pad_end) 内の
+ * タップ数、そうでなければ入力 [0, n) 内のタップ数を返す。
+ * 2D の除数は各軸の除数の積になる。
+ */
+inline std::vector<int> averagepool_counts(int n, int out_n, int kernel, int stride, int dilation,
+                                           int pad_begin, int pad_end, bool count_include_pad) {
+    int lo = count_include_pad ? -pad_begin : 0;
+    int hi = count_include_pad ? n + pad_end : n;
+
+    std::vector<int> counts(out_n);
+    for (int o = 0; o < out_n; ++o) {
+        int start = o * stride - pad_begin;
+        int count = 0;
+        for (int j = 0; j < kernel; ++j) {
+            int i = start + j * dilation;
+            count += (i >= lo && i < hi) ? 1 : 0;
+        }
+        counts[o] = count;
+    }
+    return counts;
+}
+
+/**
+ * Helper function: 1次元スライディングウィンドウ総和
+ *
+ * out[o] = sum_j in[o * stride - pad_begin + j * dilation] (入力範囲内のみ)。
+ * Dense overlapping windows keep a running sum, adding the entering and
+ * subtracting the leaving elements, so each output costs O(1). Otherwise
+ * windows fully inside the input run without bounds checks and only the
+ * border outputs clip their window.
+ */
+inline void averagepool_1d(const double* in, long in_stride, int n,
+                           double* out, long out_stride, int out_n,
+                           int kernel, int stride, int dilation, int pad_begin) {
+    if (dilation == 1 && kernel >= 4 && stride < kernel) {
+        // Running sum over [ws, we)
+        double sum = 0.0;
+        int ws = 0, we = 0;
+        for (int o = 0; o < out_n; ++o) {
+            int start = o * stride - pad_begin;
+            int new_ws = std::max(0, start);
+            int new_we = std::min(n, start + kernel);
+            for (; we < new_we; ++we) sum += in[we * in_stride];
+            for (; ws < new_ws; ++ws) sum -= in[ws * in_stride];
+            out[o * out_stride] = (new_we > new_ws) ? sum : 0.0;
+        }
+        return;
+    }
+
+    const int extent = (kernel - 1) * dilation;
+
+    // Interior outputs: start >= 0 and start + extent < n
+    int o_lo = std::min(out_n, (pad_begin + stride - 1) / stride);
+    int o_hi = (n - 1 - extent + pad_begin < 0) ? 0 : (n - 1 - extent + pad_begin) / stride + 1;
+    o_hi = std::max(o_lo, std::min(out_n, o_hi));
+
+    auto border = [&](int o) {
+        int start = o * stride - pad_begin;
+        double sum = 0.0;
+        for (int j = 0; j < kernel; ++j) {
+            int i = start + j * dilation;
+            if (i >= 0 && i < n) sum += in[i * in_stride];
+        }
+        out[o * out_stride] = sum;
+    };
+
+    for (int o = 0; o < o_lo; ++o) border(o);
+    for (int o = o_lo; o < o_hi; ++o) {
+        const double* w = in + static_cast<long>(o * stride - pad_begin) * in_stride;
+        double sum = 0.0;
+        for (int j = 0; j < kernel; ++j) {
+            sum += w[j * dilation * in_stride];
+        }
+        out[o * out_stride] = sum;
+    }
+    for (int o = o_hi; o < out_n; ++o) border(o);
+}
+
+/**
+ * AveragePool を呼び出し側のバッファに書き込む
  *
- * 平均値プーリング演算を行う。
  * Simplified 2D implementation for (1, C, H, W) input.
+ * Pooling is separable: a row pass sums each input row into out_w values,
+ * a column pass sums those into out_h rows, and the result is divided by
+ * the product of the per-axis counts.
  *
+ * @param out 出力 (C x (out_h * out_w))、呼び出し側で確保。X と重ならないこと
  * @param X 入力テンソル (flattened from N=1, C, H, W)
  * @param C チャネル数
  * @param H 入力高さ
@@ -24,53 +110,358 @@ namespace onnx {
  * @param pad_left 左パディング
  * @param pad_bottom 下パディング
  * @param pad_right 右パディング
- * @return 出力テンソル (flattened)
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param count_include_pad パディング領域を除数に含めるか (ONNX既定: false)
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
  */
-inline Eigen::MatrixXd averagepool(
+inline void averagepool_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
     const Eigen::MatrixXd& X,
     int C, int H, int W,
     int kernel_h, int kernel_w,
     int stride_h = -1, int stride_w = -1,
     int pad_top = 0, int pad_left = 0,
-    int pad_bottom = 0, int pad_right = 0) {
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    bool count_include_pad = false,
+    int dilation_h = 1, int dilation_w = 1) {
 
     // Default strides to kernel size
     if (stride_h == -1) stride_h = kernel_h;
     if (stride_w == -1) stride_w = kernel_w;
 
     // Calculate output dimensions
-    int out_h = (H + pad_top + pad_bottom - kernel_h) / stride_h + 1;
-    int out_w = (W + pad_left + pad_right - kernel_w) / stride_w + 1;
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
 
-    Eigen::MatrixXd result(C, out_h * out_w);
+    std::vector<int> count_h = averagepool_counts(H, out_h, kernel_h, stride_h, dilation_h,
+                                                  pad_top, pad_bottom, count_include_pad);
+    std::vector<int> count_w = averagepool_counts(W, out_w, kernel_w, stride_w, dilation_w,
+                                                  pad_left, pad_right, count_include_pad);
+
+    const long ld = out.outerStride();
+    std::vector<double> rows(static_cast<long>(H) * out_w);
 
     for (int c = 0; c < C; ++c) {
-        for (int h = 0; h < out_h; ++h) {
-            for (int w = 0; w < out_w; ++w) {
-                int h_start = h * stride_h;
-                int w_start = w * stride_w;
-
-                double sum = 0.0;
-                int count = 0;
-
-                for (int kh = 0; kh < kernel_h; ++kh) {
-                    for (int kw = 0; kw < kernel_w; ++kw) {
-                        int h_idx = h_start + kh - pad_top;
-                        int w_idx = w_start + kw - pad_left;
-
-                        // Check bounds (padding areas are counted as 0)
-                        if (h_idx >= 0 && h_idx < H && w_idx >= 0 && w_idx < W) {
-                            sum += X(c, h_idx * W + w_idx);
-                        }
-                        count++;
-                    }
-                }
+        // Row pass: (H, W) -> (H, out_w)
+        for (int h = 0; h < H; ++h) {
+            averagepool_1d(X.data() + c + static_cast<long>(h) * W * C, C, W,
+                           rows.data() + static_cast<long>(h) * out_w, 1, out_w,
+                           kernel_w, stride_w, dilation_w, pad_left);
+        }
+        // Column pass: (H, out_w) -> (out_h, out_w)
+        for (int ow = 0; ow < out_w; ++ow) {
+            averagepool_1d(rows.data() + ow, out_w, H,
+                           out.data() + c + ow * ld, out_w * ld, out_h,
+                           kernel_h, stride_h, dilation_h, pad_top);
+        }
+    }
+
+    // Divide by the window size
+    for (int oh = 0; oh < out_h; ++oh) {
+        for (int ow = 0; ow < out_w; ++ow) {
+            int count = count_h[oh] * count_w[ow];
+            out.col(oh * out_w + ow) /= (count > 0 ? count : 1);
+        }
+    }
+}
 
-                result(c, h * out_w + w) = sum / count;
+/**
+ * ONNX AveragePool operator
+ *
+ * 平均値プーリング演算を行う。
+ * 出力を確保して averagepool_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened from N=1, C, H, W)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param count_include_pad パディング領域を除数に含めるか (ONNX既定: false)
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @return 出力テンソル (flattened)
+ */
+inline Eigen::MatrixXd averagepool(
+    const Eigen::MatrixXd& X,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    bool count_include_pad = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+
+    Eigen::MatrixXd result(C, out_h * out_w);
+    averagepool_into(result, X, C, H, W, kernel_h, kernel_w, stride_h, stride_w,
+                     pad_top, pad_left, pad_bottom, pad_right, ceil_mode,
+                     count_include_pad, dilation_h, dilation_w);
+    return result;
+}
+
+/**
+ * Helper function: NHWC AveragePool kernel
+ *
+ * x: (H, W, C) row-major, y: (out_h, out_w, C) row-major.
+ * count_h / count_w are the per-axis divisors from averagepool_counts(),
+ * so count_include_pad behaves as in averagepool().
+ */
+inline void averagepool_nhwc_kernel(
+    const double* x, double* y,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h, int stride_w,
+    int pad_top, int pad_left,
+    int dilation_h, int dilation_w,
+    const int* count_h, const int* count_w,
+    int out_h, int out_w) {
+
+    for (int oh = 0; oh < out_h; ++oh) {
+        int h_start = oh * stride_h - pad_top;
+        int kh_lo, kh_hi;
+        pool_tap_range(h_start, H, kernel_h, dilation_h, kh_lo, kh_hi);
+
+        for (int ow = 0; ow < out_w; ++ow) {
+            int w_start = ow * stride_w - pad_left;
+            int kw_lo, kw_hi;
+            pool_tap_range(w_start, W, kernel_w, dilation_w, kw_lo, kw_hi);
+
+            Eigen::Map<Eigen::ArrayXd> out(y + (static_cast<long>(oh) * out_w + ow) * C, C);
+            out.setZero();
+
+            for (int kh = kh_lo; kh < kh_hi; ++kh) {
+                for (int kw = kw_lo; kw < kw_hi; ++kw) {
+                    long src = (static_cast<long>(h_start + kh * dilation_h) * W + (w_start + kw * dilation_w)) * C;
+                    out += Eigen::Map<const Eigen::ArrayXd>(x + src, C);
+                }
             }
+            int count = count_h[oh] * count_w[ow];
+            out /= (count > 0 ? count : 1);
         }
     }
+}
+
+/**
+ * AveragePool (NHWC) を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation for (1, H, W, C) channel-last input. Parameters and
+ * the output size (maxpool_output_size()) follow averagepool().
+ *
+ * @param output 出力 (長さ out_h * out_w * C)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param count_include_pad パディング領域を除数に含めるか (ONNX既定: false)
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ */
+inline void averagepool_nhwc_into(
+    Eigen::Ref<Eigen::VectorXd> output,
+    const Eigen::VectorXd& X,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    bool count_include_pad = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+
+    std::vector<int> count_h = averagepool_counts(H, out_h, kernel_h, stride_h, dilation_h,
+                                                  pad_top, pad_bottom, count_include_pad);
+    std::vector<int> count_w = averagepool_counts(W, out_w, kernel_w, stride_w, dilation_w,
+                                                  pad_left, pad_right, count_include_pad);
+
+    averagepool_nhwc_kernel(X.data(), output.data(), C, H, W, kernel_h, kernel_w,
+                            stride_h, stride_w, pad_top, pad_left, dilation_h, dilation_w,
+                            count_h.data(), count_w.data(), out_h, out_w);
+}
+
+/**
+ * ONNX AveragePool operator (NHWC)
+ *
+ * 平均値プーリング演算を行う。
+ * 出力を確保して averagepool_nhwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param count_include_pad パディング領域を除数に含めるか (ONNX既定: false)
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @return 出力テンソル (flattened (out_h, out_w, C), row-major)
+ */
+inline Eigen::VectorXd averagepool_nhwc(
+    const Eigen::VectorXd& X,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    bool count_include_pad = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+
+    Eigen::VectorXd result(static_cast<long>(out_h) * out_w * C);
+    averagepool_nhwc_into(result, X, C, H, W, kernel_h, kernel_w, stride_h, stride_w,
+                          pad_top, pad_left, pad_bottom, pad_right, ceil_mode,
+                          count_include_pad, dilation_h, dilation_w);
+    return result;
+}
+
+/**
+ * AveragePool (NCHWc) を呼び出し側のバッファに書き込む
+ *
+ * Channel-blocked input: each block of `block` channels is stored as an
+ * (H, W, block) slab and pooled independently. Parameters follow
+ * averagepool().
+ *
+ * @param output 出力 (長さ ceil(C/block) * out_h * out_w * block)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (ceil(C/block), H, W, block), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param block チャネルブロックサイズ
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param count_include_pad パディング領域を除数に含めるか (ONNX既定: false)
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ */
+inline void averagepool_nchwc_into(
+    Eigen::Ref<Eigen::VectorXd> output,
+    const Eigen::VectorXd& X,
+    int C, int H, int W, int block,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    bool count_include_pad = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+    int blocks = (C + block - 1) / block;
+
+    std::vector<int> count_h = averagepool_counts(H, out_h, kernel_h, stride_h, dilation_h,
+                                                  pad_top, pad_bottom, count_include_pad);
+    std::vector<int> count_w = averagepool_counts(W, out_w, kernel_w, stride_w, dilation_w,
+                                                  pad_left, pad_right, count_include_pad);
+
+    long in_slab = static_cast<long>(H) * W * block;
+    long out_slab = static_cast<long>(out_h) * out_w * block;
+
+    for (int cb = 0; cb < blocks; ++cb) {
+        averagepool_nhwc_kernel(X.data() + cb * in_slab, output.data() + cb * out_slab,
+                                block, H, W, kernel_h, kernel_w,
+                                stride_h, stride_w, pad_top, pad_left, dilation_h, dilation_w,
+                                count_h.data(), count_w.data(), out_h, out_w);
+    }
+}
+
+/**
+ * ONNX AveragePool operator (NCHWc)
+ *
+ * 平均値プーリング演算を行う。
+ * 出力を確保して averagepool_nchwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (ceil(C/block), H, W, block), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param block チャネルブロックサイズ
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param count_include_pad パディング領域を除数に含めるか (ONNX既定: false)
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @return 出力テンソル (flattened (ceil(C/block), out_h, out_w, block), row-major)
+ */
+inline Eigen::VectorXd averagepool_nchwc(
+    const Eigen::VectorXd& X,
+    int C, int H, int W, int block,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    bool count_include_pad = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+    int blocks = (C + block - 1) / block;
 
+    Eigen::VectorXd result(static_cast<long>(blocks) * out_h * out_w * block);
+    averagepool_nchwc_into(result, X, C, H, W, block, kernel_h, kernel_w, stride_h, stride_w,
+                           pad_top, pad_left, pad_bottom, pad_right, ceil_mode,
+                           count_include_pad, dilation_h, dilation_w);
     return result;
 }
 
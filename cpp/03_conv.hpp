@@ -2,16 +2,21 @@
 #define ONNX_03_CONV_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <string>
 #include <vector>
+#include "08_pad.hpp"  // pad_source_table (Pad と同じ座標対応)
 
 namespace onnx {
 
 /**
- * ONNX Conv operator
+ * Conv を呼び出し側のバッファに書き込む
  *
- * 畳み込み演算を行う。
  * Simplified 2D implementation for (1, C_in, H, W) input, group=1.
+ * A preceding Pad can be folded in through pad_fold_into_consumer()
+ * (08_pad.hpp), so no padded copy of X is materialized.
  *
+ * @param out 出力 (M x (out_h * out_w))、呼び出し側で確保。X と重ならないこと
  * @param X 入力テンソル (C_in x (H*W))
  * @param W 重みテンソル (M x (C_in * kH * kW))
  * @param B バイアス (M x 1) - optional
@@ -27,22 +32,27 @@ namespace onnx {
  * @param pad_left 左パディング
  * @param pad_bottom 下パディング
  * @param pad_right 右パディング
- * @return 出力テンソル (M x (out_h * out_w))
+ * @param pad_mode パディングの値 ("constant": 0, "reflect", "edge", "wrap")。
+ *                 パディング済みのコピーは作らず、入力位置の対応表で参照する
  */
-inline Eigen::MatrixXd conv(
+inline void conv_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
     const Eigen::MatrixXd& X,
     const Eigen::MatrixXd& W,
     const Eigen::VectorXd* B,
     int C_in, int H, int W_dim, int M, int kH, int kW,
     int stride_h = 1, int stride_w = 1,
     int pad_top = 0, int pad_left = 0,
-    int pad_bottom = 0, int pad_right = 0) {
+    int pad_bottom = 0, int pad_right = 0,
+    const std::string& pad_mode = "constant") {
 
     // Calculate output dimensions
     int out_h = (H + pad_top + pad_bottom - kH) / stride_h + 1;
     int out_w = (W_dim + pad_left + pad_right - kW) / stride_w + 1;
 
-    Eigen::MatrixXd result = Eigen::MatrixXd::Zero(M, out_h * out_w);
+    // Padded coordinate -> input coordinate (-1: zero padding)
+    std::vector<int> h_src = pad_source_table(H, pad_top, pad_bottom, pad_mode);
+    std::vector<int> w_src = pad_source_table(W_dim, pad_left, pad_right, pad_mode);
 
     // For each output channel
     for (int m = 0; m < M; ++m) {
@@ -57,11 +67,11 @@ inline Eigen::MatrixXd conv(
                 for (int c = 0; c < C_in; ++c) {
                     for (int kh = 0; kh < kH; ++kh) {
                         for (int kw = 0; kw < kW; ++kw) {
-                            int h_idx = h_start + kh - pad_top;
-                            int w_idx = w_start + kw - pad_left;
+                            int h_idx = h_src[h_start + kh];
+                            int w_idx = w_src[w_start + kw];
 
-                            // Check bounds
-                            if (h_idx >= 0 && h_idx < H && w_idx >= 0 && w_idx < W_dim) {
+                            // Skip zero padding
+                            if (h_idx >= 0 && w_idx >= 0) {
                                 double x_val = X(c, h_idx * W_dim + w_idx);
                                 double w_val = W(m, c * kH * kW + kh * kW + kw);
                                 sum += x_val * w_val;
@@ -75,11 +85,359 @@ inline Eigen::MatrixXd conv(
                     sum += (*B)(m);
                 }
 
-                result(m, oh * out_w + ow) = sum;
+                out(m, oh * out_w + ow) = sum;
+            }
+        }
+    }
+}
+
+/**
+ * ONNX Conv operator
+ *
+ * 畳み込み演算を行う。
+ * 出力を確保して conv_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (C_in x (H*W))
+ * @param W 重みテンソル (M x (C_in * kH * kW))
+ * @param B バイアス (M x 1) - optional
+ * @param C_in 入力チャネル数
+ * @param H 入力高さ
+ * @param W_dim 入力幅
+ * @param M 出力チャネル数
+ * @param kH カーネル高さ
+ * @param kW カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param pad_mode パディングの値 ("constant": 0, "reflect", "edge", "wrap")
+ * @return 出力テンソル (M x (out_h * out_w))
+ */
+inline Eigen::MatrixXd conv(
+    const Eigen::MatrixXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int kH, int kW,
+    int stride_h = 1, int stride_w = 1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    const std::string& pad_mode = "constant") {
+    int out_h = (H + pad_top + pad_bottom - kH) / stride_h + 1;
+    int out_w = (W_dim + pad_left + pad_right - kW) / stride_w + 1;
+    Eigen::MatrixXd result(M, out_h * out_w);
+    conv_into(result, X, W, B, C_in, H, W_dim, M, kH, kW,
+              stride_h, stride_w, pad_top, pad_left, pad_bottom, pad_right, pad_mode);
+    return result;
+}
+
+/**
+ * Helper function: カーネル位置 k に対して入力範囲内に収まる出力位置の範囲
+ *
+ * in_idx = out_idx * stride + offset (offset = k - pad) が [0, in_size) に入る
+ * out_idx の範囲 [lo, hi) を計算する。
+ */
+inline void conv_valid_range(int in_size, int out_size, int stride, int offset,
+                             int& lo, int& hi) {
+    lo = (offset >= 0) ? 0 : (-offset + stride - 1) / stride;
+    int last = in_size - 1 - offset;
+    hi = (last < 0) ? 0 : std::min(out_size, last / stride + 1);
+    if (lo > hi) lo = hi;
+}
+
+/**
+ * Conv (NHWC) を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation for (1, H, W, C_in) channel-last input.
+ * For each kernel tap, a strided row of input pixels is multiplied by the
+ * (C_in x M) tap matrix, so the inner product runs over contiguous channels.
+ * Padding is handled by clipping the output range per tap (no padded copy).
+ *
+ * @param output 出力 (長さ out_h * out_w * M)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (H, W, C_in), row-major)
+ * @param W 重みテンソル (M x (C_in/group * kH * kW)), Conv と同じ配置
+ * @param B バイアス (M x 1) - optional
+ * @param C_in 入力チャネル数
+ * @param H 入力高さ
+ * @param W_dim 入力幅
+ * @param M 出力チャネル数
+ * @param kH カーネル高さ
+ * @param kW カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param group グループ数 (C_in == M == group でdepthwise)
+ */
+inline void conv_nhwc_into(
+    Eigen::Ref<Eigen::VectorXd> output,
+    const Eigen::VectorXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int kH, int kW,
+    int stride_h = 1, int stride_w = 1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    int group = 1) {
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+
+    int out_h = (H + pad_top + pad_bottom - kH) / stride_h + 1;
+    int out_w = (W_dim + pad_left + pad_right - kW) / stride_w + 1;
+
+    const int Cg = C_in / group;
+    const int Mg = M / group;
+    const int taps = kH * kW;
+
+    // Repack weights per kernel tap: taps x (Cg x M)
+    std::vector<Eigen::MatrixXd> w_tap(taps, Eigen::MatrixXd(Cg, M));
+    for (int m = 0; m < M; ++m) {
+        for (int c = 0; c < Cg; ++c) {
+            for (int t = 0; t < taps; ++t) {
+                w_tap[t](c, m) = W(m, c * taps + t);
+            }
+        }
+    }
+
+    Eigen::Map<RowMatrix> Y(output.data(), out_h * out_w, M);
+    if (B != nullptr) {
+        Y.rowwise() = B->transpose();
+    } else {
+        Y.setZero();
+    }
+
+    for (int oh = 0; oh < out_h; ++oh) {
+        for (int kh = 0; kh < kH; ++kh) {
+            int h = oh * stride_h + kh - pad_top;
+            if (h < 0 || h >= H) continue;
+
+            for (int kw = 0; kw < kW; ++kw) {
+                int ow_lo, ow_hi;
+                conv_valid_range(W_dim, out_w, stride_w, kw - pad_left, ow_lo, ow_hi);
+                int n = ow_hi - ow_lo;
+                if (n <= 0) continue;
+
+                int w0 = ow_lo * stride_w + kw - pad_left;
+                Eigen::Map<const RowMatrix, 0, Eigen::OuterStride<>> Xs(
+                    X.data() + (static_cast<long>(h) * W_dim + w0) * C_in, n, C_in,
+                    Eigen::OuterStride<>(static_cast<long>(stride_w) * C_in));
+                auto Ys = Y.middleRows(oh * out_w + ow_lo, n);
+                const Eigen::MatrixXd& wt = w_tap[kh * kW + kw];
+
+                if (group == 1) {
+                    Ys.noalias() += Xs * wt;
+                } else if (Cg == 1 && Mg == 1) {
+                    // Depthwise: per-channel scaling of the pixel row
+                    Ys.array() += Xs.array().rowwise() * wt.row(0).array();
+                } else {
+                    for (int g = 0; g < group; ++g) {
+                        Ys.middleCols(g * Mg, Mg).noalias() +=
+                            Xs.middleCols(g * Cg, Cg) * wt.middleCols(g * Mg, Mg);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * ONNX Conv operator (NHWC)
+ *
+ * 畳み込み演算を行う。
+ * 出力を確保して conv_nhwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (H, W, C_in), row-major)
+ * @param W 重みテンソル (M x (C_in/group * kH * kW)), Conv と同じ配置
+ * @param B バイアス (M x 1) - optional
+ * @param C_in 入力チャネル数
+ * @param H 入力高さ
+ * @param W_dim 入力幅
+ * @param M 出力チャネル数
+ * @param kH カーネル高さ
+ * @param kW カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param group グループ数 (C_in == M == group でdepthwise)
+ * @return 出力テンソル (flattened (out_h, out_w, M), row-major)
+ */
+inline Eigen::VectorXd conv_nhwc(
+    const Eigen::VectorXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int kH, int kW,
+    int stride_h = 1, int stride_w = 1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    int group = 1) {
+    int out_h = (H + pad_top + pad_bottom - kH) / stride_h + 1;
+    int out_w = (W_dim + pad_left + pad_right - kW) / stride_w + 1;
+    Eigen::VectorXd result(static_cast<long>(out_h) * out_w * M);
+    conv_nhwc_into(result, X, W, B, C_in, H, W_dim, M, kH, kW,
+                   stride_h, stride_w, pad_top, pad_left, pad_bottom, pad_right, group);
+    return result;
+}
+
+/**
+ * Conv (NCHWc) を呼び出し側のバッファに書き込む
+ *
+ * Channel-blocked input and output: each block of `block` channels is
+ * stored as an (H, W, block) slab, as for maxpool_nchwc(). Per kernel tap,
+ * the weights form a (C_in x M) matrix cut into (block x block) tiles, and
+ * each input slab row is multiplied into each output slab row as in
+ * conv_nhwc_into(). Tiles that connect no channels of a common group are
+ * skipped. Tail channels of the last output block are written as zero;
+ * tail channels of the last input block are multiplied by zero weights.
+ *
+ * @param output 出力 (長さ ceil(M/block) * out_h * out_w * block)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (ceil(C_in/block), H, W, block), row-major)
+ * @param W 重みテンソル (M x (C_in/group * kH * kW)), Conv と同じ配置
+ * @param B バイアス (M x 1) - optional
+ * @param C_in 入力チャネル数
+ * @param H 入力高さ
+ * @param W_dim 入力幅
+ * @param M 出力チャネル数
+ * @param block チャネルブロックサイズ
+ * @param kH カーネル高さ
+ * @param kW カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param group グループ数 (C_in == M == group でdepthwise)
+ */
+inline void conv_nchwc_into(
+    Eigen::Ref<Eigen::VectorXd> output,
+    const Eigen::VectorXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int block, int kH, int kW,
+    int stride_h = 1, int stride_w = 1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    int group = 1) {
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+
+    int out_h = (H + pad_top + pad_bottom - kH) / stride_h + 1;
+    int out_w = (W_dim + pad_left + pad_right - kW) / stride_w + 1;
+
+    const int Cg = C_in / group;
+    const int Mg = M / group;
+    const int taps = kH * kW;
+    const int in_blocks = (C_in + block - 1) / block;
+    const int out_blocks = (M + block - 1) / block;
+    const bool depthwise = (group > 1 && Cg == 1 && Mg == 1);
+
+    // Repack weights per kernel tap: taps x (padded C_in x padded M), block-diagonal over groups
+    std::vector<Eigen::MatrixXd> w_tap(taps, Eigen::MatrixXd::Zero(in_blocks * block, out_blocks * block));
+    std::vector<char> active(static_cast<size_t>(in_blocks) * out_blocks, 0);
+    for (int m = 0; m < M; ++m) {
+        const int g = m / Mg;
+        for (int c = 0; c < Cg; ++c) {
+            const int ci = g * Cg + c;
+            active[static_cast<size_t>(ci / block) * out_blocks + m / block] = 1;
+            for (int t = 0; t < taps; ++t) {
+                w_tap[t](ci, m) = W(m, c * taps + t);
+            }
+        }
+    }
+
+    const long in_slab = static_cast<long>(H) * W_dim * block;
+    const long out_slab = static_cast<long>(out_h) * out_w * block;
+
+    for (int mb = 0; mb < out_blocks; ++mb) {
+        Eigen::Map<RowMatrix> Y(output.data() + mb * out_slab, out_h * out_w, block);
+        Y.setZero();
+        if (B != nullptr) {
+            const int valid = std::min(block, M - mb * block);
+            Y.leftCols(valid).rowwise() = B->segment(mb * block, valid).transpose();
+        }
+
+        for (int oh = 0; oh < out_h; ++oh) {
+            for (int kh = 0; kh < kH; ++kh) {
+                int h = oh * stride_h + kh - pad_top;
+                if (h < 0 || h >= H) continue;
+
+                for (int kw = 0; kw < kW; ++kw) {
+                    int ow_lo, ow_hi;
+                    conv_valid_range(W_dim, out_w, stride_w, kw - pad_left, ow_lo, ow_hi);
+                    int n = ow_hi - ow_lo;
+                    if (n <= 0) continue;
+
+                    int w0 = ow_lo * stride_w + kw - pad_left;
+                    auto Ys = Y.middleRows(oh * out_w + ow_lo, n);
+                    const Eigen::MatrixXd& wt = w_tap[kh * kW + kw];
+
+                    for (int cb = 0; cb < in_blocks; ++cb) {
+                        if (!active[static_cast<size_t>(cb) * out_blocks + mb]) continue;
+
+                        Eigen::Map<const RowMatrix, 0, Eigen::OuterStride<>> Xs(
+                            X.data() + cb * in_slab + (static_cast<long>(h) * W_dim + w0) * block, n, block,
+                            Eigen::OuterStride<>(static_cast<long>(stride_w) * block));
+                        auto wb = wt.block(cb * block, mb * block, block, block);
+
+                        if (depthwise) {
+                            // Depthwise: per-channel scaling of the pixel row
+                            Ys.array() += Xs.array().rowwise() * wb.diagonal().transpose().array();
+                        } else {
+                            Ys.noalias() += Xs * wb;
+                        }
+                    }
+                }
             }
         }
     }
+}
 
+/**
+ * ONNX Conv operator (NCHWc)
+ *
+ * 畳み込み演算を行う。
+ * 出力を確保して conv_nchwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (ceil(C_in/block), H, W, block), row-major)
+ * @param W 重みテンソル (M x (C_in/group * kH * kW)), Conv と同じ配置
+ * @param B バイアス (M x 1) - optional
+ * @param C_in 入力チャネル数
+ * @param H 入力高さ
+ * @param W_dim 入力幅
+ * @param M 出力チャネル数
+ * @param block チャネルブロックサイズ
+ * @param kH カーネル高さ
+ * @param kW カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param group グループ数 (C_in == M == group でdepthwise)
+ * @return 出力テンソル (flattened (ceil(M/block), out_h, out_w, block), row-major)
+ */
+inline Eigen::VectorXd conv_nchwc(
+    const Eigen::VectorXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int block, int kH, int kW,
+    int stride_h = 1, int stride_w = 1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    int group = 1) {
+    int out_h = (H + pad_top + pad_bottom - kH) / stride_h + 1;
+    int out_w = (W_dim + pad_left + pad_right - kW) / stride_w + 1;
+    int out_blocks = (M + block - 1) / block;
+    Eigen::VectorXd result(static_cast<long>(out_blocks) * out_h * out_w * block);
+    conv_nchwc_into(result, X, W, B, C_in, H, W_dim, M, block, kH, kW,
+                    stride_h, stride_w, pad_top, pad_left, pad_bottom, pad_right, group);
     return result;
 }
 
@@ -2,18 +2,322 @@
 #define ONNX_03_CONVTRANSPOSE_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <vector>
 
 namespace onnx {
 
+/**
+ * Helper function: 入力位置の有効範囲
+ *
+ * out_idx = in_idx * stride + offset が [0, out_size) に入る
+ * in_idx の範囲 [lo, hi) を計算する。
+ */
+inline void convtranspose_valid_range(int in_size, int out_size, int stride, int offset,
+                                      int& lo, int& hi) {
+    lo = (offset >= 0) ? 0 : (-offset + stride - 1) / stride;
+    int last = out_size - 1 - offset;
+    hi = (last < 0) ? 0 : std::min(in_size, last / stride + 1);
+    if (lo > hi) lo = hi;
+}
+
+/**
+ * ConvTranspose: GEMM + col2im
+ *
+ * 転置畳み込みを GEMM と col2im で計算する。
+ * cols = X_g^T * W_g gives, for every (m, kh, kw), one contiguous column
+ * over input pixels; col2im then accumulates each column into a row-major
+ * output plane along contiguous (strided by stride_w) runs. The planes are
+ * accumulated row-major and copied into out at the end.
+ * Parameters are the same as convtranspose_into().
+ */
+inline void convtranspose_col2im_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
+    const Eigen::MatrixXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int kH, int kW,
+    int stride_h, int stride_w,
+    int pad_top, int pad_left,
+    int pad_bottom, int pad_right,
+    int output_padding_h, int output_padding_w,
+    int dilation_h, int dilation_w,
+    int group) {
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+
+    int out_h = (H - 1) * stride_h + output_padding_h + (kH - 1) * dilation_h + 1 - pad_top - pad_bottom;
+    int out_w = (W_dim - 1) * stride_w + output_padding_w + (kW - 1) * dilation_w + 1 - pad_left - pad_right;
+
+    const int Cg = C_in / group;
+    const int Mg = M / group;
+    const int kk = kH * kW;
+
+    RowMatrix acc = RowMatrix::Zero(M, out_h * out_w);
+
+    for (int g = 0; g < group; ++g) {
+        // (H*W) x (Mg*kH*kW)
+        Eigen::MatrixXd cols = X.middleRows(g * Cg, Cg).transpose() * W.middleRows(g * Cg, Cg);
+
+        for (int m = 0; m < Mg; ++m) {
+            double* plane = acc.row(g * Mg + m).data();
+
+            for (int kh = 0; kh < kH; ++kh) {
+                int ih_lo, ih_hi;
+                convtranspose_valid_range(H, out_h, stride_h, kh * dilation_h - pad_top, ih_lo, ih_hi);
+
+                for (int kw = 0; kw < kW; ++kw) {
+                    int w_offset = kw * dilation_w - pad_left;
+                    int iw_lo, iw_hi;
+                    convtranspose_valid_range(W_dim, out_w, stride_w, w_offset, iw_lo, iw_hi);
+
+                    const double* col = cols.col(m * kk + kh * kW + kw).data();
+
+                    for (int ih = ih_lo; ih < ih_hi; ++ih) {
+                        int oh = ih * stride_h + kh * dilation_h - pad_top;
+                        double* dst = plane + static_cast<long>(oh) * out_w + w_offset;
+                        const double* src = col + static_cast<long>(ih) * W_dim;
+                        for (int iw = iw_lo; iw < iw_hi; ++iw) {
+                            dst[iw * stride_w] += src[iw];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    out = acc;
+    if (B != nullptr) {
+        out.colwise() += *B;
+    }
+}
+
+/**
+ * ConvTranspose: GEMM + col2im
+ *
+ * 出力を確保して convtranspose_col2im_into() を呼ぶ。
+ * Parameters are the same as convtranspose().
+ */
+inline Eigen::MatrixXd convtranspose_col2im(
+    const Eigen::MatrixXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int kH, int kW,
+    int stride_h, int stride_w,
+    int pad_top, int pad_left,
+    int pad_bottom, int pad_right,
+    int output_padding_h, int output_padding_w,
+    int dilation_h, int dilation_w,
+    int group) {
+
+    int out_h = (H - 1) * stride_h + output_padding_h + (kH - 1) * dilation_h + 1 - pad_top - pad_bottom;
+    int out_w = (W_dim - 1) * stride_w + output_padding_w + (kW - 1) * dilation_w + 1 - pad_left - pad_right;
+    Eigen::MatrixXd result(M, out_h * out_w);
+    convtranspose_col2im_into(result, X, W, B, C_in, H, W_dim, M, kH, kW,
+                              stride_h, stride_w, pad_top, pad_left, pad_bottom, pad_right,
+                              output_padding_h, output_padding_w,
+                              dilation_h, dilation_w, group);
+    return result;
+}
+
+/**
+ * ConvTranspose: stride-decomposed (sub-pixel) gather
+ *
+ * 転置畳み込みをストライドの位相ごとの畳み込みに分解して計算する。
+ * Output positions with the same (oh % stride_h, ow % stride_w) phase are
+ * reached by a fixed subset of kernel taps, so each phase is a stride-1
+ * correlation: an im2col gather of the input followed by one GEMM. Every
+ * output value is written exactly once, directly into out.
+ * Parameters are the same as convtranspose_into().
+ */
+inline void convtranspose_subpixel_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
+    const Eigen::MatrixXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int kH, int kW,
+    int stride_h, int stride_w,
+    int pad_top, int pad_left,
+    int pad_bottom, int pad_right,
+    int output_padding_h, int output_padding_w,
+    int dilation_h, int dilation_w,
+    int group) {
+
+    int out_h = (H - 1) * stride_h + output_padding_h + (kH - 1) * dilation_h + 1 - pad_top - pad_bottom;
+    int out_w = (W_dim - 1) * stride_w + output_padding_w + (kW - 1) * dilation_w + 1 - pad_left - pad_right;
+
+    const int Cg = C_in / group;
+    const int Mg = M / group;
+    const int kk = kH * kW;
+
+    // Taps contributing to a phase r, with input offset (r + pad - k * d) / stride
+    auto phase_taps = [](int r, int k_size, int stride, int pad, int dilation,
+                         std::vector<int>& taps, std::vector<int>& offsets) {
+        taps.clear();
+        offsets.clear();
+        for (int k = 0; k < k_size; ++k) {
+            int t = r + pad - k * dilation;
+            int rem = ((t % stride) + stride) % stride;
+            if (rem == 0) {
+                taps.push_back(k);
+                offsets.push_back((t - rem) / stride);
+            }
+        }
+    };
+
+    std::vector<int> taps_h, off_h, taps_w, off_w;
+
+    for (int rh = 0; rh < std::min(stride_h, out_h); ++rh) {
+        int nh = (out_h - rh + stride_h - 1) / stride_h;
+        phase_taps(rh, kH, stride_h, pad_top, dilation_h, taps_h, off_h);
+
+        for (int rw = 0; rw < std::min(stride_w, out_w); ++rw) {
+            int nw = (out_w - rw + stride_w - 1) / stride_w;
+            phase_taps(rw, kW, stride_w, pad_left, dilation_w, taps_w, off_w);
+
+            const int T = taps_h.size() * taps_w.size();
+
+            // Gather input patches: (C_in * T) x (nh * nw)
+            Eigen::MatrixXd patches = Eigen::MatrixXd::Zero(C_in * T, nh * nw);
+            for (int j = 0; j < nh; ++j) {
+                for (int i = 0; i < nw; ++i) {
+                    int q = j * nw + i;
+                    int t = 0;
+                    for (size_t a = 0; a < taps_h.size(); ++a) {
+                        int ih = j + off_h[a];
+                        for (size_t b = 0; b < taps_w.size(); ++b, ++t) {
+                            int iw = i + off_w[b];
+                            if (ih < 0 || ih >= H || iw < 0 || iw >= W_dim) continue;
+                            for (int c = 0; c < C_in; ++c) {
+                                patches(c * T + t, q) = X(c, ih * W_dim + iw);
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (int g = 0; g < group; ++g) {
+                // Phase weights: Mg x (Cg * T)
+                Eigen::MatrixXd w_phase(Mg, Cg * T);
+                for (int c = 0; c < Cg; ++c) {
+                    int t = 0;
+                    for (int kh : taps_h) {
+                        for (int kw : taps_w) {
+                            for (int m = 0; m < Mg; ++m) {
+                                w_phase(m, c * T + t) = W(g * Cg + c, m * kk + kh * kW + kw);
+                            }
+                            ++t;
+                        }
+                    }
+                }
+
+                Eigen::MatrixXd y_phase = w_phase * patches.middleRows(g * Cg * T, Cg * T);
+
+                for (int j = 0; j < nh; ++j) {
+                    for (int i = 0; i < nw; ++i) {
+                        int p = (rh + j * stride_h) * out_w + (rw + i * stride_w);
+                        out.col(p).segment(g * Mg, Mg) = y_phase.col(j * nw + i);
+                    }
+                }
+            }
+        }
+    }
+
+    if (B != nullptr) {
+        out.colwise() += *B;
+    }
+}
+
+/**
+ * ConvTranspose: stride-decomposed (sub-pixel) gather
+ *
+ * 出力を確保して convtranspose_subpixel_into() を呼ぶ。
+ * Parameters are the same as convtranspose().
+ */
+inline Eigen::MatrixXd convtranspose_subpixel(
+    const Eigen::MatrixXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int kH, int kW,
+    int stride_h, int stride_w,
+    int pad_top, int pad_left,
+    int pad_bottom, int pad_right,
+    int output_padding_h, int output_padding_w,
+    int dilation_h, int dilation_w,
+    int group) {
+
+    int out_h = (H - 1) * stride_h + output_padding_h + (kH - 1) * dilation_h + 1 - pad_top - pad_bottom;
+    int out_w = (W_dim - 1) * stride_w + output_padding_w + (kW - 1) * dilation_w + 1 - pad_left - pad_right;
+    Eigen::MatrixXd result(M, out_h * out_w);
+    convtranspose_subpixel_into(result, X, W, B, C_in, H, W_dim, M, kH, kW,
+                                stride_h, stride_w, pad_top, pad_left, pad_bottom, pad_right,
+                                output_padding_h, output_padding_w,
+                                dilation_h, dilation_w, group);
+    return result;
+}
+
+/**
+ * ConvTranspose を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation for (1, C_in, H, W) input. stride 1 uses GEMM + col2im;
+ * stride > 1 uses the stride-decomposed sub-pixel formulation.
+ *
+ * @param out 出力 (M x (out_h * out_w))、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (C_in x (H*W))
+ * @param W 重みテンソル (C_in x (M/group * kH * kW))
+ * @param B バイアス (M x 1) - optional
+ * @param C_in 入力チャネル数
+ * @param H 入力高さ
+ * @param W_dim 入力幅
+ * @param M 出力チャネル数
+ * @param kH カーネル高さ
+ * @param kW カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param output_padding_h 出力の下側に追加するサイズ
+ * @param output_padding_w 出力の右側に追加するサイズ
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @param group グループ数
+ */
+inline void convtranspose_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
+    const Eigen::MatrixXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::VectorXd* B,
+    int C_in, int H, int W_dim, int M, int kH, int kW,
+    int stride_h = 1, int stride_w = 1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    int output_padding_h = 0, int output_padding_w = 0,
+    int dilation_h = 1, int dilation_w = 1,
+    int group = 1) {
+
+    if (stride_h == 1 && stride_w == 1) {
+        convtranspose_col2im_into(out, X, W, B, C_in, H, W_dim, M, kH, kW,
+                                  stride_h, stride_w, pad_top, pad_left, pad_bottom, pad_right,
+                                  output_padding_h, output_padding_w,
+                                  dilation_h, dilation_w, group);
+    } else {
+        convtranspose_subpixel_into(out, X, W, B, C_in, H, W_dim, M, kH, kW,
+                                    stride_h, stride_w, pad_top, pad_left, pad_bottom, pad_right,
+                                    output_padding_h, output_padding_w,
+                                    dilation_h, dilation_w, group);
+    }
+}
+
 /**
  * ONNX ConvTranspose operator
  *
  * 転置畳み込み（逆畳み込み）演算を行う。
- * Simplified 2D implementation for (1, C_in, H, W) input.
+ * 出力を確保して convtranspose_into() を呼ぶ。
  *
  * @param X 入力テンソル (C_in x (H*W))
- * @param W 重みテンソル (C_in x (M * kH * kW))
+ * @param W 重みテンソル (C_in x (M/group * kH * kW))
  * @param B バイアス (M x 1) - optional
  * @param C_in 入力チャネル数
  * @param H 入力高さ
@@ -27,6 +331,11 @@ namespace onnx {
  * @param pad_left 左パディング
  * @param pad_bottom 下パディング
  * @param pad_right 右パディング
+ * @param output_padding_h 出力の下側に追加するサイズ
+ * @param output_padding_w 出力の右側に追加するサイズ
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @param group グループ数
  * @return 出力テンソル (M x (out_h * out_w))
  */
 inline Eigen::MatrixXd convtranspose(
@@ -36,49 +345,17 @@ inline Eigen::MatrixXd convtranspose(
     int C_in, int H, int W_dim, int M, int kH, int kW,
     int stride_h = 1, int stride_w = 1,
     int pad_top = 0, int pad_left = 0,
-    int pad_bottom = 0, int pad_right = 0) {
-
-    // Calculate output dimensions
-    int out_h = (H - 1) * stride_h - pad_top - pad_bottom + kH;
-    int out_w = (W_dim - 1) * stride_w - pad_left - pad_right + kW;
-
-    Eigen::MatrixXd result = Eigen::MatrixXd::Zero(M, out_h * out_w);
-
-    // For each input position
-    for (int c = 0; c < C_in; ++c) {
-        for (int h = 0; h < H; ++h) {
-            for (int w = 0; w < W_dim; ++w) {
-                double x_val = X(c, h * W_dim + w);
-
-                // For each output channel
-                for (int m = 0; m < M; ++m) {
-                    // Apply kernel
-                    for (int kh = 0; kh < kH; ++kh) {
-                        for (int kw = 0; kw < kW; ++kw) {
-                            int h_out = h * stride_h + kh - pad_top;
-                            int w_out = w * stride_w + kw - pad_left;
-
-                            // Check bounds
-                            if (h_out >= 0 && h_out < out_h && w_out >= 0 && w_out < out_w) {
-                                double w_val = W(c, m * kH * kW + kh * kW + kw);
-                                result(m, h_out * out_w + w_out) += x_val * w_val;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // Add bias if provided
-    if (B != nullptr) {
-        for (int m = 0; m < M; ++m) {
-            for (int i = 0; i < out_h * out_w; ++i) {
-                result(m, i) += (*B)(m);
-            }
-        }
-    }
-
+    int pad_bottom = 0, int pad_right = 0,
+    int output_padding_h = 0, int output_padding_w = 0,
+    int dilation_h = 1, int dilation_w = 1,
+    int group = 1) {
+    int out_h = (H - 1) * stride_h + output_padding_h + (kH - 1) * dilation_h + 1 - pad_top - pad_bottom;
+    int out_w = (W_dim - 1) * stride_w + output_padding_w + (kW - 1) * dilation_w + 1 - pad_left - pad_right;
+    Eigen::MatrixXd result(M, out_h * out_w);
+    convtranspose_into(result, X, W, B, C_in, H, W_dim, M, kH, kW,
+                       stride_h, stride_w, pad_top, pad_left, pad_bottom, pad_right,
+                       output_padding_h, output_padding_w,
+                       dilation_h, dilation_w, group);
     return result;
 }
 
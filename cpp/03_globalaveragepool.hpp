@@ -6,21 +6,19 @@
 namespace onnx {
 
 /**
- * ONNX GlobalAveragePool operator
+ * GlobalAveragePool を呼び出し側のバッファに書き込む
  *
- * 各チャネルの空間次元全体にわたる平均値プーリングを行う。
  * Simplified 2D implementation for (1, C, H, W) input.
  *
+ * @param out 出力 (C x 1)、呼び出し側で確保
  * @param X 入力テンソル (C x (H*W))
  * @param C チャネル数
  * @param H 入力高さ
  * @param W 入力幅
- * @return 出力テンソル (C x 1) - each channel's global average
  */
 template<typename Derived>
-auto globalaveragepool(const Eigen::MatrixBase<Derived>& X, int C, int H, int W) {
-    Eigen::MatrixXd result(C, 1);
-
+void globalaveragepool_into(Eigen::Ref<Eigen::MatrixXd> out,
+                            const Eigen::MatrixBase<Derived>& X, int C, int H, int W) {
     int spatial_size = H * W;
 
     for (int c = 0; c < C; ++c) {
@@ -28,9 +26,104 @@ auto globalaveragepool(const Eigen::MatrixBase<Derived>& X, int C, int H, int W)
         for (int i = 0; i < spatial_size; ++i) {
             sum += X(c, i);
         }
-        result(c, 0) = sum / spatial_size;
+        out(c, 0) = sum / spatial_size;
+    }
+}
+
+/**
+ * ONNX GlobalAveragePool operator
+ *
+ * 各チャネルの空間次元全体にわたる平均値プーリングを行う。
+ * 出力を確保して globalaveragepool_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (C x (H*W))
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @return 出力テンソル (C x 1) - each channel's global average
+ */
+template<typename Derived>
+auto globalaveragepool(const Eigen::MatrixBase<Derived>& X, int C, int H, int W) {
+    Eigen::MatrixXd result(C, 1);
+    globalaveragepool_into(result, X, C, H, W);
+    return result;
+}
+
+/**
+ * GlobalAveragePool (NHWC) を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation for (1, H, W, C) channel-last input: pixels are summed
+ * as contiguous channel vectors.
+ *
+ * @param output 出力 (長さ C)、呼び出し側で確保
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ */
+inline void globalaveragepool_nhwc_into(Eigen::Ref<Eigen::VectorXd> output,
+                                        const Eigen::VectorXd& X, int C, int H, int W) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+    Eigen::Map<const RowMatrix> pixels(X.data(), H * W, C);
+    output = pixels.colwise().mean().transpose();
+}
+
+/**
+ * ONNX GlobalAveragePool operator (NHWC)
+ *
+ * 各チャネルの空間次元全体にわたる平均値プーリングを行う。
+ * 出力を確保して globalaveragepool_nhwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @return 出力テンソル (C) - each channel's global average
+ */
+inline Eigen::VectorXd globalaveragepool_nhwc(const Eigen::VectorXd& X, int C, int H, int W) {
+    Eigen::VectorXd result(C);
+    globalaveragepool_nhwc_into(result, X, C, H, W);
+    return result;
+}
+
+/**
+ * GlobalAveragePool (NCHWc) を呼び出し側のバッファに書き込む
+ *
+ * @param output 出力 (長さ ceil(C/block) * block)、呼び出し側で確保
+ * @param X 入力テンソル (flattened (ceil(C/block), H, W, block), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param block チャネルブロックサイズ
+ */
+inline void globalaveragepool_nchwc_into(Eigen::Ref<Eigen::VectorXd> output,
+                                         const Eigen::VectorXd& X, int C, int H, int W, int block) {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+    int blocks = (C + block - 1) / block;
+    long slab = static_cast<long>(H) * W * block;
+
+    for (int cb = 0; cb < blocks; ++cb) {
+        Eigen::Map<const RowMatrix> pixels(X.data() + cb * slab, H * W, block);
+        output.segment(cb * block, block) = pixels.colwise().mean().transpose();
     }
+}
 
+/**
+ * ONNX GlobalAveragePool operator (NCHWc)
+ *
+ * 各チャネルの空間次元全体にわたる平均値プーリングを行う。
+ * 出力を確保して globalaveragepool_nchwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (ceil(C/block), H, W, block), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param block チャネルブロックサイズ
+ * @return 出力テンソル (ceil(C/block) * block) - padded channels included
+ */
+inline Eigen::VectorXd globalaveragepool_nchwc(const Eigen::VectorXd& X, int C, int H, int W, int block) {
+    Eigen::VectorXd result(static_cast<long>((C + block - 1) / block) * block);
+    globalaveragepool_nchwc_into(result, X, C, H, W, block);
     return result;
 }
 
@@ -4,6 +4,9 @@
 #include <Eigen/Dense>
 #include <cmath>
 #include <tuple>
+#include <utility>
+
+#include "runtime/arena.hpp"
 
 namespace onnx {
 
@@ -22,22 +25,26 @@ inline double gru_tanh(double x) {
 }
 
 /**
- * ONNX GRU operator
+ * GRU を呼び出し側のバッファに書き込む
  *
- * GRUセルの順伝播を行う。
  * Simplified implementation for single direction, batch_size=1.
+ * The input contributions W * x_t of every timestep are computed up front
+ * as one GEMM; they and the per-step hidden contributions live in the
+ * calling thread's scratch arena (runtime/arena.hpp). The hidden state is
+ * carried in Y_h.
  *
+ * @param Y 出力 (seq_length x hidden_size)、呼び出し側で確保
+ * @param Y_h 最終隠れ状態 (hidden_size)、呼び出し側で確保。initial_h と同じでもよい
  * @param X 入力テンソル (seq_length x input_size)
  * @param W 入力重み (3*hidden_size x input_size)
  * @param R リカレント重み (3*hidden_size x hidden_size)
  * @param Wb 入力バイアス (3*hidden_size) - optional
  * @param Rb リカレントバイアス (3*hidden_size) - optional
  * @param initial_h 初期隠れ状態 (hidden_size) - optional
- * @return tuple of (Y, Y_h) where:
- *         Y: 出力テンソル (seq_length x hidden_size)
- *         Y_h: 最終隠れ状態 (hidden_size)
  */
-inline std::tuple<Eigen::MatrixXd, Eigen::VectorXd> gru(
+inline void gru_into(
+    Eigen::Ref<Eigen::MatrixXd> Y,
+    Eigen::Ref<Eigen::VectorXd> Y_h,
     const Eigen::MatrixXd& X,
     const Eigen::MatrixXd& W,
     const Eigen::MatrixXd& R,
@@ -46,49 +53,79 @@ inline std::tuple<Eigen::MatrixXd, Eigen::VectorXd> gru(
     const Eigen::VectorXd* initial_h = nullptr) {
 
     int seq_length = X.rows();
-    int input_size = X.cols();
     int hidden_size = R.cols();
 
     // Initialize hidden state
-    Eigen::VectorXd h = (initial_h != nullptr) ? *initial_h : Eigen::VectorXd::Zero(hidden_size);
+    if (initial_h != nullptr) {
+        Y_h = *initial_h;
+    } else {
+        Y_h.setZero();
+    }
 
-    // Initialize biases
-    Eigen::VectorXd wb = (Wb != nullptr) ? *Wb : Eigen::VectorXd::Zero(3 * hidden_size);
-    Eigen::VectorXd rb = (Rb != nullptr) ? *Rb : Eigen::VectorXd::Zero(3 * hidden_size);
+    // 作業領域はスレッドのアリーナから確保する (タイムステップごとの malloc なし)
+    runtime::ArenaScope scratch;
 
-    Eigen::MatrixXd Y(seq_length, hidden_size);
+    // Input contributions for all timesteps in one GEMM: XW.col(t) = W * x_t + wb
+    runtime::ScratchMatrix XW = scratch.matrix(3 * hidden_size, seq_length);
+    XW.noalias() = W * X.transpose();
+    if (Wb != nullptr) XW.colwise() += *Wb;
+
+    runtime::ScratchVector gates_hidden = scratch.vector(3 * hidden_size);
 
     // Process each timestep
     for (int t = 0; t < seq_length; ++t) {
-        Eigen::VectorXd x_t = X.row(t);
+        // Compute hidden contributions
+        gates_hidden.noalias() = R * Y_h;
+        if (Rb != nullptr) gates_hidden += *Rb;
 
-        // Compute input and hidden contributions
-        Eigen::VectorXd gates_input = W * x_t + wb;
-        Eigen::VectorXd gates_hidden = R * h + rb;
+        // Gates: [update, reset, candidate]
+        for (int j = 0; j < hidden_size; ++j) {
+            const double z_gate = gru_sigmoid(XW(j, t) + gates_hidden(j));  // update gate
+            const double r_gate = gru_sigmoid(XW(hidden_size + j, t) + gates_hidden(hidden_size + j));  // reset gate
 
-        // Extract gates: [update, reset, candidate]
-        Eigen::VectorXd z_gate(hidden_size);  // update gate
-        Eigen::VectorXd r_gate(hidden_size);  // reset gate
-        Eigen::VectorXd h_tilde(hidden_size); // candidate hidden state
+            // Candidate hidden state with reset gate
+            const double h_tilde = gru_tanh(XW(2 * hidden_size + j, t) +
+                                            r_gate * gates_hidden(2 * hidden_size + j));
 
-        for (int j = 0; j < hidden_size; ++j) {
-            z_gate(j) = gru_sigmoid(gates_input(j) + gates_hidden(j));
-            r_gate(j) = gru_sigmoid(gates_input(hidden_size + j) + gates_hidden(hidden_size + j));
+            // Update hidden state
+            Y_h(j) = (1.0 - z_gate) * h_tilde + z_gate * Y_h(j);
         }
 
-        // Compute candidate hidden state with reset gate
-        for (int j = 0; j < hidden_size; ++j) {
-            h_tilde(j) = gru_tanh(gates_input(2 * hidden_size + j) +
-                                  r_gate(j) * gates_hidden(2 * hidden_size + j));
-        }
+        Y.row(t) = Y_h;
+    }
+}
 
-        // Update hidden state
-        h = (1.0 - z_gate.array()) * h_tilde.array() + z_gate.array() * h.array();
+/**
+ * ONNX GRU operator
+ *
+ * GRUセルの順伝播を行う。
+ * 出力を確保して gru_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (seq_length x input_size)
+ * @param W 入力重み (3*hidden_size x input_size)
+ * @param R リカレント重み (3*hidden_size x hidden_size)
+ * @param Wb 入力バイアス (3*hidden_size) - optional
+ * @param Rb リカレントバイアス (3*hidden_size) - optional
+ * @param initial_h 初期隠れ状態 (hidden_size) - optional
+ * @return tuple of (Y, Y_h) where:
+ *         Y: 出力テンソル (seq_length x hidden_size)
+ *         Y_h: 最終隠れ状態 (hidden_size)
+ */
+inline std::tuple<Eigen::MatrixXd, Eigen::VectorXd> gru(
+    const Eigen::MatrixXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::MatrixXd& R,
+    const Eigen::VectorXd* Wb = nullptr,
+    const Eigen::VectorXd* Rb = nullptr,
+    const Eigen::VectorXd* initial_h = nullptr) {
 
-        Y.row(t) = h;
-    }
+    int seq_length = X.rows();
+    int hidden_size = R.cols();
 
-    return std::make_tuple(Y, h);
+    Eigen::MatrixXd Y(seq_length, hidden_size);
+    Eigen::VectorXd Y_h(hidden_size);
+    gru_into(Y, Y_h, X, W, R, Wb, Rb, initial_h);
+    return std::make_tuple(std::move(Y), std::move(Y_h));
 }
 
 } // namespace onnx
@@ -3,19 +3,102 @@
 
 #include <Eigen/Dense>
 #include <cmath>
+#include <vector>
 
 namespace onnx {
 
+/**
+ * Helper function: 1行分の統計量を1回の読み出しで計算する
+ *
+ * 先頭要素をシフト値とした sum / sumsq で平均と分散を求める。
+ * シフトにより平均が大きい入力でも桁落ちを抑えられる。
+ */
+inline void layernorm_row_stats(const double* x, int n, double epsilon,
+                                double& mean, double& inv_std_dev) {
+    const double shift = x[0];
+    double sum = 0.0;
+    double sumsq = 0.0;
+    for (int j = 0; j < n; ++j) {
+        double d = x[j] - shift;
+        sum += d;
+        sumsq += d * d;
+    }
+    double shifted_mean = sum / n;
+    double variance = sumsq / n - shifted_mean * shifted_mean;
+    if (variance < 0.0) variance = 0.0;
+
+    mean = shift + shifted_mean;
+    inv_std_dev = 1.0 / std::sqrt(variance + epsilon);
+}
+
+/**
+ * LayerNormalization を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation: each row is normalized over the last axis.
+ * Statistics for all rows are accumulated column by column in one read
+ * of X, so the column-major storage is traversed contiguously.
+ * out is written only after the statistics pass, so out may be X.
+ *
+ * @param out 出力 (X と同じ形状)、呼び出し側で確保
+ * @param X 入力テンソル
+ * @param scale スケールパラメータ (gamma)
+ * @param bias バイアスパラメータ (beta)
+ * @param epsilon 数値安定性のための小さな値
+ * @param mean 各行の平均 (rows) - optional output
+ * @param inv_std_dev 各行の標準偏差の逆数 (rows) - optional output
+ */
+template<typename Derived1, typename Derived2, typename Derived3>
+void layernormalization_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
+    const Eigen::MatrixBase<Derived1>& X,
+    const Eigen::MatrixBase<Derived2>& scale,
+    const Eigen::MatrixBase<Derived3>& bias,
+    double epsilon = 1e-5,
+    Eigen::VectorXd* mean = nullptr,
+    Eigen::VectorXd* inv_std_dev = nullptr) {
+
+    const int rows = X.rows();
+    const int cols = X.cols();
+
+    // Single statistics pass, shifted by the first column
+    const Eigen::ArrayXd shift = X.col(0).array();
+    Eigen::ArrayXd sum = Eigen::ArrayXd::Zero(rows);
+    Eigen::ArrayXd sumsq = Eigen::ArrayXd::Zero(rows);
+    for (int j = 0; j < cols; ++j) {
+        // One read of the column feeds both accumulators
+        for (int i = 0; i < rows; ++i) {
+            const double d = X(i, j) - shift(i);
+            sum(i) += d;
+            sumsq(i) += d * d;
+        }
+    }
+
+    Eigen::ArrayXd shifted_mean = sum / cols;
+    Eigen::ArrayXd variance = (sumsq / cols - shifted_mean.square()).max(0.0);
+    Eigen::ArrayXd row_mean = shift + shifted_mean;
+    Eigen::ArrayXd row_inv_std = (variance + epsilon).rsqrt();
+
+    // Normalize and apply scale/bias
+    for (int j = 0; j < cols; ++j) {
+        out.col(j) = ((X.col(j).array() - row_mean) * row_inv_std * scale(j) + bias(j)).matrix();
+    }
+
+    if (mean != nullptr) *mean = row_mean.matrix();
+    if (inv_std_dev != nullptr) *inv_std_dev = row_inv_std.matrix();
+}
+
 /**
  * ONNX LayerNormalization operator
  *
  * レイヤー正規化を行う。
- * Simplified implementation for last axis normalization.
+ * 出力を確保して layernormalization_into() を呼ぶ。
  *
  * @param X 入力テンソル
  * @param scale スケールパラメータ (gamma)
  * @param bias バイアスパラメータ (beta)
  * @param epsilon 数値安定性のための小さな値
+ * @param mean 各行の平均 (rows) - optional output
+ * @param inv_std_dev 各行の標準偏差の逆数 (rows) - optional output
  * @return 正規化されたテンソル
  */
 template<typename Derived1, typename Derived2, typename Derived3>
@@ -23,31 +106,201 @@ auto layernormalization(
     const Eigen::MatrixBase<Derived1>& X,
     const Eigen::MatrixBase<Derived2>& scale,
     const Eigen::MatrixBase<Derived3>& bias,
-    double epsilon = 1e-5) {
+    double epsilon = 1e-5,
+    Eigen::VectorXd* mean = nullptr,
+    Eigen::VectorXd* inv_std_dev = nullptr) {
 
     Eigen::MatrixXd result(X.rows(), X.cols());
+    layernormalization_into(result, X, scale, bias, epsilon, mean, inv_std_dev);
+    return result;
+}
+
+/**
+ * LayerNormalization (N-D) を呼び出し側のバッファに書き込む
+ *
+ * X is a flattened (row-major) tensor of the given shape. Normalization is
+ * performed over dimensions [axis, rank); scale and bias have the
+ * flattened size of those dimensions.
+ *
+ * @param output 出力 (X と同じ長さ)、呼び出し側で確保。output に X を渡すと in-place で正規化する
+ * @param X 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param scale スケールパラメータ (gamma)
+ * @param bias バイアスパラメータ (beta) - optional
+ * @param axis 正規化を開始する軸 (負の値は末尾から数える, デフォルト: -1)
+ * @param epsilon 数値安定性のための小さな値
+ * @param mean 平均 (prod(shape[:axis])) - optional output
+ * @param inv_std_dev 標準偏差の逆数 (prod(shape[:axis])) - optional output
+ */
+inline void layernormalization_into(
+    Eigen::Ref<Eigen::VectorXd> output,
+    const Eigen::VectorXd& X,
+    const std::vector<int>& shape,
+    const Eigen::VectorXd& scale,
+    const Eigen::VectorXd* bias,
+    int axis = -1,
+    double epsilon = 1e-5,
+    Eigen::VectorXd* mean = nullptr,
+    Eigen::VectorXd* inv_std_dev = nullptr) {
+
+    const int rank = shape.size();
+    if (axis < 0) axis += rank;
+
+    int outer = 1;
+    for (int d = 0; d < axis; ++d) outer *= shape[d];
+    int inner = 1;
+    for (int d = axis; d < rank; ++d) inner *= shape[d];
+
+    if (mean != nullptr) mean->resize(outer);
+    if (inv_std_dev != nullptr) inv_std_dev->resize(outer);
+
+    const double* gamma = scale.data();
+    const double* beta = (bias != nullptr) ? bias->data() : nullptr;
+
+    for (int i = 0; i < outer; ++i) {
+        const double* x = X.data() + static_cast<long>(i) * inner;
+        double* y = output.data() + static_cast<long>(i) * inner;
 
-    // Normalize each row independently
-    for (int i = 0; i < X.rows(); ++i) {
-        // Calculate mean
-        double mean = X.row(i).mean();
+        double m, inv_std;
+        layernorm_row_stats(x, inner, epsilon, m, inv_std);
 
-        // Calculate variance
-        double variance = 0.0;
-        for (int j = 0; j < X.cols(); ++j) {
-            double diff = X(i, j) - mean;
-            variance += diff * diff;
+        if (beta != nullptr) {
+            for (int j = 0; j < inner; ++j) {
+                y[j] = (x[j] - m) * inv_std * gamma[j] + beta[j];
+            }
+        } else {
+            for (int j = 0; j < inner; ++j) {
+                y[j] = (x[j] - m) * inv_std * gamma[j];
+            }
         }
-        variance /= X.cols();
 
-        // Normalize and apply scale/bias
-        double std_dev = std::sqrt(variance + epsilon);
-        for (int j = 0; j < X.cols(); ++j) {
-            double normalized = (X(i, j) - mean) / std_dev;
-            result(i, j) = scale(j) * normalized + bias(j);
+        if (mean != nullptr) (*mean)(i) = m;
+        if (inv_std_dev != nullptr) (*inv_std_dev)(i) = inv_std;
+    }
+}
+
+/**
+ * ONNX LayerNormalization operator (N-D)
+ *
+ * レイヤー正規化を行う。
+ * 出力を確保して layernormalization_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param scale スケールパラメータ (gamma)
+ * @param bias バイアスパラメータ (beta) - optional
+ * @param axis 正規化を開始する軸 (負の値は末尾から数える, デフォルト: -1)
+ * @param epsilon 数値安定性のための小さな値
+ * @param mean 平均 (prod(shape[:axis])) - optional output
+ * @param inv_std_dev 標準偏差の逆数 (prod(shape[:axis])) - optional output
+ * @return 正規化されたテンソル (flattened, row-major)
+ */
+inline Eigen::VectorXd layernormalization(
+    const Eigen::VectorXd& X,
+    const std::vector<int>& shape,
+    const Eigen::VectorXd& scale,
+    const Eigen::VectorXd* bias,
+    int axis = -1,
+    double epsilon = 1e-5,
+    Eigen::VectorXd* mean = nullptr,
+    Eigen::VectorXd* inv_std_dev = nullptr) {
+
+    Eigen::VectorXd result(X.size());
+    layernormalization_into(result, X, shape, scale, bias, axis, epsilon, mean, inv_std_dev);
+    return result;
+}
+
+/**
+ * SkipLayerNormalization を呼び出し側のバッファに書き込む
+ *
+ * Y = LayerNorm(X + skip) over the last axis. The sum is written once into
+ * out and normalized there, so X and skip are each read only once. out may
+ * be X or skip (e.g. to update a residual stream in place).
+ *
+ * @param out 出力 (X と同じ形状)、呼び出し側で確保
+ * @param X 入力テンソル
+ * @param skip 残差入力 (Xと同じ形状)
+ * @param scale スケールパラメータ (gamma)
+ * @param bias バイアスパラメータ (beta)
+ * @param epsilon 数値安定性のための小さな値
+ * @param sum_output X + skip (次のブロックの残差入力) - optional output
+ * @param mean 各行の平均 (rows) - optional output
+ * @param inv_std_dev 各行の標準偏差の逆数 (rows) - optional output
+ */
+template<typename Derived1, typename Derived2, typename Derived3, typename Derived4>
+void skiplayernormalization_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
+    const Eigen::MatrixBase<Derived1>& X,
+    const Eigen::MatrixBase<Derived2>& skip,
+    const Eigen::MatrixBase<Derived3>& scale,
+    const Eigen::MatrixBase<Derived4>& bias,
+    double epsilon = 1e-5,
+    Eigen::MatrixXd* sum_output = nullptr,
+    Eigen::VectorXd* mean = nullptr,
+    Eigen::VectorXd* inv_std_dev = nullptr) {
+
+    const int rows = X.rows();
+    const int cols = X.cols();
+
+    // Residual add fused with the statistics pass
+    const Eigen::ArrayXd shift = X.col(0).array() + skip.col(0).array();
+    Eigen::ArrayXd sum = Eigen::ArrayXd::Zero(rows);
+    Eigen::ArrayXd sumsq = Eigen::ArrayXd::Zero(rows);
+    for (int j = 0; j < cols; ++j) {
+        for (int i = 0; i < rows; ++i) {
+            const double v = X(i, j) + skip(i, j);
+            const double d = v - shift(i);
+            out(i, j) = v;
+            sum(i) += d;
+            sumsq(i) += d * d;
         }
     }
 
+    if (sum_output != nullptr) *sum_output = out;
+
+    Eigen::ArrayXd shifted_mean = sum / cols;
+    Eigen::ArrayXd variance = (sumsq / cols - shifted_mean.square()).max(0.0);
+    Eigen::ArrayXd row_mean = shift + shifted_mean;
+    Eigen::ArrayXd row_inv_std = (variance + epsilon).rsqrt();
+
+    // Normalize in place
+    for (int j = 0; j < cols; ++j) {
+        out.col(j) = ((out.col(j).array() - row_mean) * row_inv_std * scale(j) + bias(j)).matrix();
+    }
+
+    if (mean != nullptr) *mean = row_mean.matrix();
+    if (inv_std_dev != nullptr) *inv_std_dev = row_inv_std.matrix();
+}
+
+/**
+ * SkipLayerNormalization (residual add + LayerNormalization)
+ *
+ * 残差加算とレイヤー正規化を融合して行う。
+ * 出力を確保して skiplayernormalization_into() を呼ぶ。
+ *
+ * @param X 入力テンソル
+ * @param skip 残差入力 (Xと同じ形状)
+ * @param scale スケールパラメータ (gamma)
+ * @param bias バイアスパラメータ (beta)
+ * @param epsilon 数値安定性のための小さな値
+ * @param sum_output X + skip (次のブロックの残差入力) - optional output
+ * @param mean 各行の平均 (rows) - optional output
+ * @param inv_std_dev 各行の標準偏差の逆数 (rows) - optional output
+ * @return 正規化されたテンソル
+ */
+template<typename Derived1, typename Derived2, typename Derived3, typename Derived4>
+Eigen::MatrixXd skiplayernormalization(
+    const Eigen::MatrixBase<Derived1>& X,
+    const Eigen::MatrixBase<Derived2>& skip,
+    const Eigen::MatrixBase<Derived3>& scale,
+    const Eigen::MatrixBase<Derived4>& bias,
+    double epsilon = 1e-5,
+    Eigen::MatrixXd* sum_output = nullptr,
+    Eigen::VectorXd* mean = nullptr,
+    Eigen::VectorXd* inv_std_dev = nullptr) {
+
+    Eigen::MatrixXd result(X.rows(), X.cols());
+    skiplayernormalization_into(result, X, skip, scale, bias, epsilon, sum_output, mean, inv_std_dev);
     return result;
 }
 
@@ -4,6 +4,9 @@
 #include <Eigen/Dense>
 #include <cmath>
 #include <tuple>
+#include <utility>
+
+#include "runtime/arena.hpp"
 
 namespace onnx {
 
@@ -22,11 +25,18 @@ inline double tanh_activation(double x) {
 }
 
 /**
- * ONNX LSTM operator
+ * LSTM を呼び出し側のバッファに書き込む
  *
- * LSTMセルの順伝播を行う。
  * Simplified implementation for single direction, batch_size=1.
+ * The input projection W * x_t of every timestep is computed up front as
+ * one GEMM; the per-step gate buffer and the projection live in the
+ * calling thread's scratch arena (runtime/arena.hpp). The hidden and cell
+ * states are carried in Y_h and Y_c, so a run allocates nothing on the heap
+ * once the arena has grown.
  *
+ * @param Y 出力 (seq_length x hidden_size)、呼び出し側で確保
+ * @param Y_h 最終隠れ状態 (hidden_size)、呼び出し側で確保。initial_h と同じでもよい
+ * @param Y_c 最終セル状態 (hidden_size)、呼び出し側で確保。initial_c と同じでもよい
  * @param X 入力テンソル (seq_length x input_size)
  * @param W 入力重み (4*hidden_size x input_size)
  * @param R リカレント重み (4*hidden_size x hidden_size)
@@ -34,12 +44,11 @@ inline double tanh_activation(double x) {
  * @param Rb リカレントバイアス (4*hidden_size) - optional
  * @param initial_h 初期隠れ状態 (hidden_size) - optional
  * @param initial_c 初期セル状態 (hidden_size) - optional
- * @return tuple of (Y, Y_h, Y_c) where:
- *         Y: 出力テンソル (seq_length x hidden_size)
- *         Y_h: 最終隠れ状態 (hidden_size)
- *         Y_c: 最終セル状態 (hidden_size)
  */
-inline std::tuple<Eigen::MatrixXd, Eigen::VectorXd, Eigen::VectorXd> lstm(
+inline void lstm_into(
+    Eigen::Ref<Eigen::MatrixXd> Y,
+    Eigen::Ref<Eigen::VectorXd> Y_h,
+    Eigen::Ref<Eigen::VectorXd> Y_c,
     const Eigen::MatrixXd& X,
     const Eigen::MatrixXd& W,
     const Eigen::MatrixXd& R,
@@ -49,51 +58,91 @@ inline std::tuple<Eigen::MatrixXd, Eigen::VectorXd, Eigen::VectorXd> lstm(
     const Eigen::VectorXd* initial_c = nullptr) {
 
     int seq_length = X.rows();
-    int input_size = X.cols();
     int hidden_size = R.cols();
 
     // Initialize hidden and cell states
-    Eigen::VectorXd h = (initial_h != nullptr) ? *initial_h : Eigen::VectorXd::Zero(hidden_size);
-    Eigen::VectorXd c = (initial_c != nullptr) ? *initial_c : Eigen::VectorXd::Zero(hidden_size);
+    if (initial_h != nullptr) {
+        Y_h = *initial_h;
+    } else {
+        Y_h.setZero();
+    }
+    if (initial_c != nullptr) {
+        Y_c = *initial_c;
+    } else {
+        Y_c.setZero();
+    }
 
-    // Initialize biases
-    Eigen::VectorXd wb = (Wb != nullptr) ? *Wb : Eigen::VectorXd::Zero(4 * hidden_size);
-    Eigen::VectorXd rb = (Rb != nullptr) ? *Rb : Eigen::VectorXd::Zero(4 * hidden_size);
+    // 作業領域はスレッドのアリーナから確保する (タイムステップごとの malloc なし)
+    runtime::ArenaScope scratch;
 
-    Eigen::MatrixXd Y(seq_length, hidden_size);
+    // Input projection for all timesteps in one GEMM: XW.col(t) = W * x_t + wb + rb
+    runtime::ScratchVector bias = scratch.vector(4 * hidden_size);
+    bias.setZero();
+    if (Wb != nullptr) bias += *Wb;
+    if (Rb != nullptr) bias += *Rb;
+
+    runtime::ScratchMatrix XW = scratch.matrix(4 * hidden_size, seq_length);
+    XW.noalias() = W * X.transpose();
+    XW.colwise() += bias;
+
+    runtime::ScratchVector gates = scratch.vector(4 * hidden_size);
 
     // Process each timestep
     for (int t = 0; t < seq_length; ++t) {
-        Eigen::VectorXd x_t = X.row(t);
-
         // Compute gates: [input, forget, cell, output]
-        Eigen::VectorXd gates = W * x_t + R * h + wb + rb;
-
-        // Extract individual gates
-        Eigen::VectorXd i_gate(hidden_size);
-        Eigen::VectorXd f_gate(hidden_size);
-        Eigen::VectorXd g_gate(hidden_size);
-        Eigen::VectorXd o_gate(hidden_size);
+        gates = XW.col(t);
+        gates.noalias() += R * Y_h;
 
+        // Update cell and hidden states
         for (int j = 0; j < hidden_size; ++j) {
-            i_gate(j) = sigmoid(gates(j));                           // input gate
-            f_gate(j) = sigmoid(gates(hidden_size + j));            // forget gate
-            g_gate(j) = tanh_activation(gates(2 * hidden_size + j)); // cell gate
-            o_gate(j) = sigmoid(gates(3 * hidden_size + j));        // output gate
-        }
+            const double i_gate = sigmoid(gates(j));                           // input gate
+            const double f_gate = sigmoid(gates(hidden_size + j));            // forget gate
+            const double g_gate = tanh_activation(gates(2 * hidden_size + j)); // cell gate
+            const double o_gate = sigmoid(gates(3 * hidden_size + j));        // output gate
 
-        // Update cell state
-        c = f_gate.array() * c.array() + i_gate.array() * g_gate.array();
-
-        // Update hidden state
-        for (int j = 0; j < hidden_size; ++j) {
-            h(j) = o_gate(j) * tanh_activation(c(j));
+            Y_c(j) = f_gate * Y_c(j) + i_gate * g_gate;
+            Y_h(j) = o_gate * tanh_activation(Y_c(j));
         }
 
-        Y.row(t) = h;
+        Y.row(t) = Y_h;
     }
+}
 
-    return std::make_tuple(Y, h, c);
+/**
+ * ONNX LSTM operator
+ *
+ * LSTMセルの順伝播を行う。
+ * 出力を確保して lstm_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (seq_length x input_size)
+ * @param W 入力重み (4*hidden_size x input_size)
+ * @param R リカレント重み (4*hidden_size x hidden_size)
+ * @param Wb 入力バイアス (4*hidden_size) - optional
+ * @param Rb リカレントバイアス (4*hidden_size) - optional
+ * @param initial_h 初期隠れ状態 (hidden_size) - optional
+ * @param initial_c 初期セル状態 (hidden_size) - optional
+ * @return tuple of (Y, Y_h, Y_c) where:
+ *         Y: 出力テンソル (seq_length x hidden_size)
+ *         Y_h: 最終隠れ状態 (hidden_size)
+ *         Y_c: 最終セル状態 (hidden_size)
+ */
+inline std::tuple<Eigen::MatrixXd, Eigen::VectorXd, Eigen::VectorXd> lstm(
+    const Eigen::MatrixXd& X,
+    const Eigen::MatrixXd& W,
+    const Eigen::MatrixXd& R,
+    const Eigen::VectorXd* Wb = nullptr,
+    const Eigen::VectorXd* Rb = nullptr,
+    const Eigen::VectorXd* initial_h = nullptr,
+    const Eigen::VectorXd* initial_c = nullptr) {
+
+    int seq_length = X.rows();
+    int hidden_size = R.cols();
+
+    Eigen::MatrixXd Y(seq_length, hidden_size);
+    Eigen::VectorXd Y_h(hidden_size);
+    Eigen::VectorXd Y_c(hidden_size);
+    lstm_into(Y, Y_h, Y_c, X, W, R, Wb, Rb, initial_h, initial_c);
+    return std::make_tuple(std::move(Y), std::move(Y_h), std::move(Y_c));
 }
 
 } // namespace onnx
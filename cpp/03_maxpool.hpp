@@ -5,15 +5,133 @@
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <cstdint>
 
 namespace onnx {
 
 /**
- * ONNX MaxPool operator
+ * Helper function: MaxPool / AveragePool の出力サイズ
+ *
+ * ONNX の定義に従い、ceil_mode の場合は最後のウィンドウが
+ * 入力 (または先頭パディング) の内側から始まるように調整する。
+ */
+inline int maxpool_output_size(int in_size, int kernel, int stride, int dilation,
+                               int pad_begin, int pad_end, bool ceil_mode) {
+    int span = in_size + pad_begin + pad_end - ((kernel - 1) * dilation + 1);
+    int out = (ceil_mode ? (span + stride - 1) / stride : span / stride) + 1;
+    if (ceil_mode && (out - 1) * stride >= in_size + pad_begin) --out;
+    return out;
+}
+
+/**
+ * Helper function: ウィンドウ内で入力範囲に入るタップの範囲
+ *
+ * start + k * dilation が [0, n) に入る k の範囲 [lo, hi) を計算する。
+ */
+inline void pool_tap_range(int start, int n, int kernel, int dilation, int& lo, int& hi) {
+    lo = (start >= 0) ? 0 : (-start + dilation - 1) / dilation;
+    int last = n - 1 - start;
+    hi = (last < 0) ? 0 : std::min(kernel, last / dilation + 1);
+    if (lo > hi) lo = hi;
+}
+
+/**
+ * Helper function: 1次元スライディングウィンドウ最大値
+ *
+ * out[o] = max_j in[o * stride - pad_begin + j * dilation] (入力範囲内のみ)。
+ * Windows fully inside the input run without bounds checks; only the
+ * border outputs clip their window. For large dense kernels a monotonic
+ * deque gives O(1) amortized work per output.
+ * argmax (optional) receives the input position of the first maximum.
+ */
+inline void maxpool_1d(const double* in, long in_stride, int n,
+                       double* out, long out_stride, int out_n,
+                       int kernel, int stride, int dilation, int pad_begin,
+                       int* argmax = nullptr) {
+    const double lowest = -std::numeric_limits<double>::infinity();
+
+    if (dilation == 1 && kernel >= 8 && stride < kernel) {
+        // Monotonic deque of candidate indices (values non-increasing)
+        std::vector<int> dq(n > 0 ? n : 1);
+        int head = 0, tail = 0, next = 0;
+        for (int o = 0; o < out_n; ++o) {
+            int start = o * stride - pad_begin;
+            int ws = std::max(0, start);
+            int we = std::min(n, start + kernel);
+            for (; next < we; ++next) {
+                double v = in[next * in_stride];
+                while (tail > head && in[dq[tail - 1] * in_stride] < v) --tail;
+                dq[tail++] = next;
+            }
+            while (tail > head && dq[head] < ws) ++head;
+            out[o * out_stride] = (tail > head) ? in[dq[head] * in_stride] : lowest;
+            if (argmax != nullptr) argmax[o] = (tail > head) ? dq[head] : -1;
+        }
+        return;
+    }
+
+    const int extent = (kernel - 1) * dilation;
+
+    // Interior outputs: start >= 0 and start + extent < n
+    int o_lo = std::min(out_n, (pad_begin + stride - 1) / stride);
+    int o_hi = (n - 1 - extent + pad_begin < 0) ? 0 : (n - 1 - extent + pad_begin) / stride + 1;
+    o_hi = std::max(o_lo, std::min(out_n, o_hi));
+
+    auto border = [&](int o) {
+        int start = o * stride - pad_begin;
+        double m = lowest;
+        int arg = -1;
+        for (int j = 0; j < kernel; ++j) {
+            int i = start + j * dilation;
+            if (i >= 0 && i < n && in[i * in_stride] > m) {
+                m = in[i * in_stride];
+                arg = i;
+            }
+        }
+        out[o * out_stride] = m;
+        if (argmax != nullptr) argmax[o] = arg;
+    };
+
+    for (int o = 0; o < o_lo; ++o) border(o);
+    if (argmax == nullptr) {
+        for (int o = o_lo; o < o_hi; ++o) {
+            const double* w = in + static_cast<long>(o * stride - pad_begin) * in_stride;
+            double m = w[0];
+            for (int j = 1; j < kernel; ++j) {
+                m = std::max(m, w[j * dilation * in_stride]);
+            }
+            out[o * out_stride] = m;
+        }
+    } else {
+        for (int o = o_lo; o < o_hi; ++o) {
+            const double* w = in + static_cast<long>(o * stride - pad_begin) * in_stride;
+            double m = w[0];
+            int arg = 0;
+            for (int j = 1; j < kernel; ++j) {
+                double v = w[j * dilation * in_stride];
+                if (v > m) {
+                    m = v;
+                    arg = j;
+                }
+            }
+            out[o * out_stride] = m;
+            argmax[o] = o * stride - pad_begin + arg * dilation;
+        }
+    }
+    for (int o = o_hi; o < out_n; ++o) border(o);
+}
+
+/**
+ * MaxPool を呼び出し側のバッファに書き込む
  *
- * 最大値プーリング演算を行う。
  * Simplified 2D implementation for (1, C, H, W) input.
+ * Pooling is separable: a row pass reduces each input row to out_w
+ * values, and a column pass reduces those to out_h rows. When indices is
+ * given, the row pass also records the argmax column and the column pass
+ * the argmax row, so Indices come out of the same pass. Channels are
+ * processed in parallel when built with OpenMP.
  *
+ * @param out 出力 (C x (out_h * out_w))、呼び出し側で確保。X と重ならないこと
  * @param X 入力テンソル (flattened from N=1, C, H, W)
  * @param C チャネル数
  * @param H 入力高さ
@@ -26,56 +144,353 @@ namespace onnx {
  * @param pad_left 左パディング
  * @param pad_bottom 下パディング
  * @param pad_right 右パディング
- * @return 出力テンソル (flattened)
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @param indices 最大値の位置 (C x (out_h * out_w)) - optional output
+ * @param storage_order indices の並び (0: 行優先 c*H*W + h*W + w, 1: 列優先 c*H*W + w*H + h)
  */
-inline Eigen::MatrixXd maxpool(
+inline void maxpool_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
     const Eigen::MatrixXd& X,
     int C, int H, int W,
     int kernel_h, int kernel_w,
     int stride_h = -1, int stride_w = -1,
     int pad_top = 0, int pad_left = 0,
-    int pad_bottom = 0, int pad_right = 0) {
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    int dilation_h = 1, int dilation_w = 1,
+    Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic>* indices = nullptr,
+    int storage_order = 0) {
 
     // Default strides to kernel size
     if (stride_h == -1) stride_h = kernel_h;
     if (stride_w == -1) stride_w = kernel_w;
 
     // Calculate output dimensions
-    int out_h = (H + pad_top + pad_bottom - kernel_h) / stride_h + 1;
-    int out_w = (W + pad_left + pad_right - kernel_w) / stride_w + 1;
-
-    // Create padded input
-    int H_padded = H + pad_top + pad_bottom;
-    int W_padded = W + pad_left + pad_right;
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
 
-    Eigen::MatrixXd result(C, out_h * out_w);
+    const long ld = out.outerStride();
+    if (indices != nullptr) indices->resize(C, out_h * out_w);
 
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
     for (int c = 0; c < C; ++c) {
-        for (int h = 0; h < out_h; ++h) {
-            for (int w = 0; w < out_w; ++w) {
-                int h_start = h * stride_h;
-                int w_start = w * stride_w;
-
-                double max_val = -std::numeric_limits<double>::infinity();
-
-                for (int kh = 0; kh < kernel_h; ++kh) {
-                    for (int kw = 0; kw < kernel_w; ++kw) {
-                        int h_idx = h_start + kh - pad_top;
-                        int w_idx = w_start + kw - pad_left;
-
-                        // Check bounds
-                        if (h_idx >= 0 && h_idx < H && w_idx >= 0 && w_idx < W) {
-                            double val = X(c, h_idx * W + w_idx);
-                            max_val = std::max(max_val, val);
-                        }
+        std::vector<double> rows(static_cast<long>(H) * out_w);
+        std::vector<int> col_arg;
+        std::vector<int> row_arg;
+        if (indices != nullptr) {
+            col_arg.resize(static_cast<long>(H) * out_w);
+            row_arg.resize(out_h);
+        }
+
+        // Row pass: (H, W) -> (H, out_w)
+        for (int h = 0; h < H; ++h) {
+            maxpool_1d(X.data() + c + static_cast<long>(h) * W * C, C, W,
+                       rows.data() + static_cast<long>(h) * out_w, 1, out_w,
+                       kernel_w, stride_w, dilation_w, pad_left,
+                       indices != nullptr ? col_arg.data() + static_cast<long>(h) * out_w : nullptr);
+        }
+        // Column pass: (H, out_w) -> (out_h, out_w)
+        for (int ow = 0; ow < out_w; ++ow) {
+            maxpool_1d(rows.data() + ow, out_w, H,
+                       out.data() + c + ow * ld, out_w * ld, out_h,
+                       kernel_h, stride_h, dilation_h, pad_top,
+                       indices != nullptr ? row_arg.data() : nullptr);
+
+            if (indices != nullptr) {
+                for (int oh = 0; oh < out_h; ++oh) {
+                    int h = row_arg[oh];
+                    int w = (h >= 0) ? col_arg[static_cast<long>(h) * out_w + ow] : -1;
+                    if (w < 0) {
+                        // Window lies entirely in the padding
+                        (*indices)(c, oh * out_w + ow) = -1;
+                        continue;
                     }
+                    int64_t pos = (storage_order == 0) ? static_cast<int64_t>(h) * W + w
+                                                       : static_cast<int64_t>(w) * H + h;
+                    (*indices)(c, oh * out_w + ow) = static_cast<int64_t>(c) * H * W + pos;
                 }
+            }
+        }
+    }
+}
+
+/**
+ * ONNX MaxPool operator
+ *
+ * 最大値プーリング演算を行う。
+ * 出力を確保して maxpool_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened from N=1, C, H, W)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @param indices 最大値の位置 (C x (out_h * out_w)) - optional output
+ * @param storage_order indices の並び (0: 行優先 c*H*W + h*W + w, 1: 列優先 c*H*W + w*H + h)
+ * @return 出力テンソル (flattened)
+ */
+inline Eigen::MatrixXd maxpool(
+    const Eigen::MatrixXd& X,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    int dilation_h = 1, int dilation_w = 1,
+    Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic>* indices = nullptr,
+    int storage_order = 0) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+
+    Eigen::MatrixXd result(C, out_h * out_w);
+    maxpool_into(result, X, C, H, W, kernel_h, kernel_w, stride_h, stride_w,
+                 pad_top, pad_left, pad_bottom, pad_right, ceil_mode,
+                 dilation_h, dilation_w, indices, storage_order);
+    return result;
+}
+
+/**
+ * Helper function: NHWC MaxPool kernel
+ *
+ * x: (H, W, C) row-major, y: (out_h, out_w, C) row-major.
+ * The valid kernel taps are computed once per output position, and the
+ * max is taken over contiguous channel vectors. A window that lies
+ * entirely in the padding (possible with ceil_mode) gives -inf, as in
+ * maxpool().
+ */
+inline void maxpool_nhwc_kernel(
+    const double* x, double* y,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h, int stride_w,
+    int pad_top, int pad_left,
+    int dilation_h, int dilation_w,
+    int out_h, int out_w) {
 
-                result(c, h * out_w + w) = max_val;
+    for (int oh = 0; oh < out_h; ++oh) {
+        int h_start = oh * stride_h - pad_top;
+        int kh_lo, kh_hi;
+        pool_tap_range(h_start, H, kernel_h, dilation_h, kh_lo, kh_hi);
+
+        for (int ow = 0; ow < out_w; ++ow) {
+            int w_start = ow * stride_w - pad_left;
+            int kw_lo, kw_hi;
+            pool_tap_range(w_start, W, kernel_w, dilation_w, kw_lo, kw_hi);
+
+            Eigen::Map<Eigen::ArrayXd> out(y + (static_cast<long>(oh) * out_w + ow) * C, C);
+            out.setConstant(-std::numeric_limits<double>::infinity());
+
+            for (int kh = kh_lo; kh < kh_hi; ++kh) {
+                for (int kw = kw_lo; kw < kw_hi; ++kw) {
+                    long src = (static_cast<long>(h_start + kh * dilation_h) * W + (w_start + kw * dilation_w)) * C;
+                    out = out.max(Eigen::Map<const Eigen::ArrayXd>(x + src, C));
+                }
             }
         }
     }
+}
+
+/**
+ * MaxPool (NHWC) を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation for (1, H, W, C) channel-last input. The output size
+ * follows maxpool_output_size(), as in maxpool().
+ *
+ * @param output 出力 (長さ out_h * out_w * C)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ */
+inline void maxpool_nhwc_into(
+    Eigen::Ref<Eigen::VectorXd> output,
+    const Eigen::VectorXd& X,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+
+    maxpool_nhwc_kernel(X.data(), output.data(), C, H, W, kernel_h, kernel_w,
+                        stride_h, stride_w, pad_top, pad_left, dilation_h, dilation_w, out_h, out_w);
+}
+
+/**
+ * ONNX MaxPool operator (NHWC)
+ *
+ * 最大値プーリング演算を行う。
+ * 出力を確保して maxpool_nhwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @return 出力テンソル (flattened (out_h, out_w, C), row-major)
+ */
+inline Eigen::VectorXd maxpool_nhwc(
+    const Eigen::VectorXd& X,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+
+    Eigen::VectorXd result(static_cast<long>(out_h) * out_w * C);
+    maxpool_nhwc_into(result, X, C, H, W, kernel_h, kernel_w, stride_h, stride_w,
+                      pad_top, pad_left, pad_bottom, pad_right, ceil_mode, dilation_h, dilation_w);
+    return result;
+}
+
+/**
+ * MaxPool (NCHWc) を呼び出し側のバッファに書き込む
+ *
+ * Channel-blocked input: each block of `block` channels is stored as an
+ * (H, W, block) slab and pooled independently.
+ *
+ * @param output 出力 (長さ ceil(C/block) * out_h * out_w * block)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (ceil(C/block), H, W, block), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param block チャネルブロックサイズ
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ */
+inline void maxpool_nchwc_into(
+    Eigen::Ref<Eigen::VectorXd> output,
+    const Eigen::VectorXd& X,
+    int C, int H, int W, int block,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+    int blocks = (C + block - 1) / block;
+
+    long in_slab = static_cast<long>(H) * W * block;
+    long out_slab = static_cast<long>(out_h) * out_w * block;
+
+    for (int cb = 0; cb < blocks; ++cb) {
+        maxpool_nhwc_kernel(X.data() + cb * in_slab, output.data() + cb * out_slab,
+                            block, H, W, kernel_h, kernel_w,
+                            stride_h, stride_w, pad_top, pad_left, dilation_h, dilation_w, out_h, out_w);
+    }
+}
+
+/**
+ * ONNX MaxPool operator (NCHWc)
+ *
+ * 最大値プーリング演算を行う。
+ * 出力を確保して maxpool_nchwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (ceil(C/block), H, W, block), row-major)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param block チャネルブロックサイズ
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param ceil_mode 出力サイズを切り上げで計算するか
+ * @param dilation_h カーネルの膨張率 (高さ)
+ * @param dilation_w カーネルの膨張率 (幅)
+ * @return 出力テンソル (flattened (ceil(C/block), out_h, out_w, block), row-major)
+ */
+inline Eigen::VectorXd maxpool_nchwc(
+    const Eigen::VectorXd& X,
+    int C, int H, int W, int block,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    bool ceil_mode = false,
+    int dilation_h = 1, int dilation_w = 1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+    int out_h = maxpool_output_size(H, kernel_h, stride_h, dilation_h, pad_top, pad_bottom, ceil_mode);
+    int out_w = maxpool_output_size(W, kernel_w, stride_w, dilation_w, pad_left, pad_right, ceil_mode);
+    int blocks = (C + block - 1) / block;
 
+    Eigen::VectorXd result(static_cast<long>(blocks) * out_h * out_w * block);
+    maxpool_nchwc_into(result, X, C, H, W, block, kernel_h, kernel_w, stride_h, stride_w,
+                       pad_top, pad_left, pad_bottom, pad_right, ceil_mode, dilation_h, dilation_w);
     return result;
 }
 
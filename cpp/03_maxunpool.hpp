@@ -0,0 +1,121 @@
+#ifndef ONNX_03_MAXUNPOOL_HPP
+#define ONNX_03_MAXUNPOOL_HPP
+
+#include <Eigen/Dense>
+#include <cstdint>
+
+namespace onnx {
+
+/**
+ * MaxUnpool を呼び出し側のバッファに書き込む
+ *
+ * Each pooled value is scattered to the position recorded in I by
+ * maxpool(..., &indices); all other outputs are zero. Indices are flat
+ * positions c * out_H * out_W + h * out_W + w, i.e. MaxPool's
+ * storage_order 0; storage_order 1 indices are not supported. Since they
+ * are offsets into MaxPool's input, output_h / output_w must equal the H / W
+ * of the tensor that was pooled (pass them explicitly when the default
+ * formula does not give it back, e.g. for odd sizes). An index outside its
+ * own channel's plane is skipped, so channels never write into each other
+ * and are processed in parallel when built with OpenMP.
+ *
+ * @param out 出力 (C x (output_h * output_w))、呼び出し側で確保。X と重ならないこと
+ * @param X プーリング後の値 (C x (H * W))
+ * @param I MaxPool が出力したインデックス (C x (H * W), storage_order 0)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param output_h 出力高さ (MaxPool の入力高さ。-1 の場合はカーネルとストライドから計算)
+ * @param output_w 出力幅 (MaxPool の入力幅。-1 の場合はカーネルとストライドから計算)
+ */
+inline void maxunpool_into(
+    Eigen::Ref<Eigen::MatrixXd> out,
+    const Eigen::MatrixXd& X,
+    const Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic>& I,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    int output_h = -1, int output_w = -1) {
+
+    // Default strides to kernel size
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+
+    // Default output shape (ONNX: (in - 1) * stride + kernel - pads)
+    if (output_h == -1) output_h = (H - 1) * stride_h + kernel_h - pad_top - pad_bottom;
+    if (output_w == -1) output_w = (W - 1) * stride_w + kernel_w - pad_left - pad_right;
+
+    const int64_t plane = static_cast<int64_t>(output_h) * output_w;
+
+    out.setZero();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int c = 0; c < C; ++c) {
+        const int64_t base = static_cast<int64_t>(c) * plane;
+        for (int p = 0; p < H * W; ++p) {
+            const int64_t idx = I(c, p) - base;
+            if (idx < 0 || idx >= plane) continue;
+            out(c, idx) = X(c, p);
+        }
+    }
+}
+
+/**
+ * ONNX MaxUnpool operator
+ *
+ * MaxPool の逆操作を行う。
+ * 出力を確保して maxunpool_into() を呼ぶ。
+ *
+ * @param X プーリング後の値 (C x (H * W))
+ * @param I MaxPool が出力したインデックス (C x (H * W), storage_order 0)
+ * @param C チャネル数
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param kernel_h カーネル高さ
+ * @param kernel_w カーネル幅
+ * @param stride_h ストライド高さ
+ * @param stride_w ストライド幅
+ * @param pad_top 上パディング
+ * @param pad_left 左パディング
+ * @param pad_bottom 下パディング
+ * @param pad_right 右パディング
+ * @param output_h 出力高さ (MaxPool の入力高さ。-1 の場合はカーネルとストライドから計算)
+ * @param output_w 出力幅 (MaxPool の入力幅。-1 の場合はカーネルとストライドから計算)
+ * @return 出力テンソル (C x (output_h * output_w))
+ */
+inline Eigen::MatrixXd maxunpool(
+    const Eigen::MatrixXd& X,
+    const Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic>& I,
+    int C, int H, int W,
+    int kernel_h, int kernel_w,
+    int stride_h = -1, int stride_w = -1,
+    int pad_top = 0, int pad_left = 0,
+    int pad_bottom = 0, int pad_right = 0,
+    int output_h = -1, int output_w = -1) {
+
+    if (stride_h == -1) stride_h = kernel_h;
+    if (stride_w == -1) stride_w = kernel_w;
+    if (output_h == -1) output_h = (H - 1) * stride_h + kernel_h - pad_top - pad_bottom;
+    if (output_w == -1) output_w = (W - 1) * stride_w + kernel_w - pad_left - pad_right;
+
+    Eigen::MatrixXd result(C, static_cast<Eigen::Index>(output_h) * output_w);
+    maxunpool_into(result, X, I, C, H, W, kernel_h, kernel_w, stride_h, stride_w,
+                   pad_top, pad_left, pad_bottom, pad_right, output_h, output_w);
+    return result;
+}
+
+} // namespace onnx
+
+#endif // ONNX_03_MAXUNPOOL_HPP
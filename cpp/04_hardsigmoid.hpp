@@ -23,6 +23,24 @@ auto hardsigmoid(const Eigen::MatrixBase<Derived>& X,
     return (alpha * X.array() + beta).max(0.0).min(1.0).matrix();
 }
 
+/**
+ * HardSigmoid を呼び出し側のバッファに書き込む
+ *
+ * 活性化を out に直接書き込む (out に X を渡すと in-place)。
+ *
+ * @param out 出力 (X と同じ形状、呼び出し側で確保)
+ * @param X 入力テンソル
+ * @param alpha 傾き (デフォルト: 0.2)
+ * @param beta オフセット (デフォルト: 0.5)
+ */
+template<typename Derived>
+void hardsigmoid_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                      const Eigen::MatrixBase<Derived>& X,
+                      double alpha = 0.2,
+                      double beta = 0.5) {
+    out = hardsigmoid(X, alpha, beta);
+}
+
 } // namespace onnx
 
 #endif // ONNX_04_HARDSIGMOID_HPP
@@ -19,6 +19,20 @@ auto hardswish(const Eigen::MatrixBase<Derived>& X) {
     return (X.array() * ((X.array() + 3.0) / 6.0).max(0.0).min(1.0)).matrix();
 }
 
+/**
+ * HardSwish を呼び出し側のバッファに書き込む
+ *
+ * 活性化を out に直接書き込む (out に X を渡すと in-place)。
+ *
+ * @param out 出力 (X と同じ形状、呼び出し側で確保)
+ * @param X 入力テンソル
+ */
+template<typename Derived>
+void hardswish_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                    const Eigen::MatrixBase<Derived>& X) {
+    out = hardswish(X);
+}
+
 } // namespace onnx
 
 #endif // ONNX_04_HARDSWISH_HPP
@@ -20,6 +20,22 @@ auto leakyrelu(const Eigen::MatrixBase<Derived>& X, double alpha = 0.01) {
     return (X.array() >= 0.0).select(X.array(), alpha * X.array()).matrix();
 }
 
+/**
+ * LeakyRelu を呼び出し側のバッファに書き込む
+ *
+ * 活性化を out に直接書き込む (out に X を渡すと in-place)。
+ *
+ * @param out 出力 (X と同じ形状、呼び出し側で確保)
+ * @param X 入力テンソル
+ * @param alpha 負の入力に対する傾き (デフォルト: 0.01)
+ */
+template<typename Derived>
+void leakyrelu_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                    const Eigen::MatrixBase<Derived>& X,
+                    double alpha = 0.01) {
+    out = leakyrelu(X, alpha);
+}
+
 } // namespace onnx
 
 #endif // ONNX_04_LEAKYRELU_HPP
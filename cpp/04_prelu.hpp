@@ -6,27 +6,45 @@
 namespace onnx {
 
 /**
- * ONNX PRelu operator
+ * PRelu を呼び出し側のバッファに書き込む
  *
- * PReLU（Parametric ReLU）活性化関数。
- * f(x) = x if x >= 0 else slope * x
+ * out に X を渡すと in-place で適用する。
  *
+ * @param out 出力 (X と同じ形状、呼び出し側で確保)
  * @param X 入力テンソル
  * @param slope 負の入力に対する傾きパラメータ
- * @return Y: PReL uを適用した結果
  */
 template<typename Derived1, typename Derived2>
-auto prelu(const Eigen::MatrixBase<Derived1>& X,
-           const Eigen::MatrixBase<Derived2>& slope) {
+void prelu_into(Eigen::Ref<Eigen::MatrixXd> out,
+                const Eigen::MatrixBase<Derived1>& X,
+                const Eigen::MatrixBase<Derived2>& slope) {
     if (slope.size() == 1) {
         // Scalar slope
-        return (X.array() >= 0.0).select(X.array(), slope(0) * X.array()).matrix();
+        out = (X.array() >= 0.0).select(X.array(), slope(0) * X.array()).matrix();
     } else {
         // Element-wise or broadcasted slope
-        return (X.array() >= 0.0).select(X.array(), slope.array() * X.array()).matrix();
+        out = (X.array() >= 0.0).select(X.array(), slope.array() * X.array()).matrix();
     }
 }
 
+/**
+ * ONNX PRelu operator
+ *
+ * PReLU（Parametric ReLU）活性化関数。
+ * f(x) = x if x >= 0 else slope * x
+ *
+ * @param X 入力テンソル
+ * @param slope 負の入力に対する傾きパラメータ
+ * @return Y: PReL uを適用した結果
+ */
+template<typename Derived1, typename Derived2>
+Eigen::MatrixXd prelu(const Eigen::MatrixBase<Derived1>& X,
+                      const Eigen::MatrixBase<Derived2>& slope) {
+    Eigen::MatrixXd result(X.rows(), X.cols());
+    prelu_into(result, X, slope);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_04_PRELU_HPP
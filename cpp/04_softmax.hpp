@@ -6,38 +6,55 @@
 namespace onnx {
 
 /**
- * ONNX Softmax operator
+ * Softmax を呼び出し側のバッファに書き込む
  *
- * Softmax関数を適用する。
- * 数値安定性のため、最大値を引いてから計算する。
+ * 各行 (列) の最大値を先に求めてから書き込むので、out に X を渡してもよい
+ * (in-place)。exp is evaluated once per element, straight into out.
  *
+ * @param out 出力 (X と同じ形状、呼び出し側で確保)
  * @param X 入力テンソル
  * @param axis Softmaxを適用する軸 (0: 列方向, 1: 行方向, デフォルト: 1)
- * @return Y: Softmaxを適用した結果（確率分布）
  */
 template<typename Derived>
-auto softmax(const Eigen::MatrixBase<Derived>& X, int axis = 1) {
+void softmax_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                  const Eigen::MatrixBase<Derived>& X,
+                  int axis = 1) {
     typedef typename Derived::Scalar Scalar;
-    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> result = X;
 
     if (axis == 1) {
         // Row-wise softmax
         for (int i = 0; i < X.rows(); ++i) {
             Scalar max_val = X.row(i).maxCoeff();
-            auto shifted = (X.row(i).array() - max_val).exp();
-            Scalar sum = shifted.sum();
-            result.row(i) = shifted / sum;
+            out.row(i) = (X.row(i).array() - max_val).exp().matrix();
+            out.row(i) /= out.row(i).sum();
         }
     } else if (axis == 0) {
         // Column-wise softmax
         for (int j = 0; j < X.cols(); ++j) {
             Scalar max_val = X.col(j).maxCoeff();
-            auto shifted = (X.col(j).array() - max_val).exp();
-            Scalar sum = shifted.sum();
-            result.col(j) = shifted / sum;
+            out.col(j) = (X.col(j).array() - max_val).exp().matrix();
+            out.col(j) /= out.col(j).sum();
         }
+    } else {
+        out = X;
     }
+}
 
+/**
+ * ONNX Softmax operator
+ *
+ * Softmax関数を適用する。
+ * 数値安定性のため、最大値を引いてから計算する。
+ *
+ * @param X 入力テンソル
+ * @param axis Softmaxを適用する軸 (0: 列方向, 1: 行方向, デフォルト: 1)
+ * @return Y: Softmaxを適用した結果（確率分布）
+ */
+template<typename Derived>
+auto softmax(const Eigen::MatrixBase<Derived>& X, int axis = 1) {
+    typedef typename Derived::Scalar Scalar;
+    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> result(X.rows(), X.cols());
+    softmax_into(result, X, axis);
     return result;
 }
 
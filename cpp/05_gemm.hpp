@@ -5,6 +5,71 @@
 
 namespace onnx {
 
+/**
+ * Gemm を呼び出し側のバッファに書き込む
+ *
+ * out に beta * C を書いてから積を out に直接加算するので、積の一時行列を作らない。
+ * out may be C itself (Y = A * B + Y), but must not share storage with A or B.
+ *
+ * @param out 出力 (op(A).rows() x op(B).cols()、呼び出し側で確保)
+ * @param A 入力行列
+ * @param B 入力行列
+ * @param C バイアス行列 (out と同じ形状)
+ * @param alpha A*Bのスカラー倍数 (デフォルト: 1.0)
+ * @param beta Cのスカラー倍数 (デフォルト: 1.0)
+ * @param transA Aを転置するか (デフォルト: false)
+ * @param transB Bを転置するか (デフォルト: false)
+ */
+template<typename Derived1, typename Derived2, typename Derived3>
+void gemm_into(Eigen::Ref<Eigen::Matrix<typename Derived1::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+               const Eigen::MatrixBase<Derived1>& A,
+               const Eigen::MatrixBase<Derived2>& B,
+               const Eigen::MatrixBase<Derived3>& C,
+               double alpha = 1.0,
+               double beta = 1.0,
+               bool transA = false,
+               bool transB = false) {
+    out = beta * C;
+
+    if (transA && transB) {
+        out.noalias() += alpha * A.transpose() * B.transpose();
+    } else if (transA) {
+        out.noalias() += alpha * A.transpose() * B;
+    } else if (transB) {
+        out.noalias() += alpha * A * B.transpose();
+    } else {
+        out.noalias() += alpha * A * B;
+    }
+}
+
+/**
+ * Gemm を呼び出し側のバッファに書き込む (C なし)
+ *
+ * @param out 出力 (op(A).rows() x op(B).cols()、呼び出し側で確保、A, B と重ならないこと)
+ * @param A 入力行列
+ * @param B 入力行列
+ * @param alpha A*Bのスカラー倍数 (デフォルト: 1.0)
+ * @param transA Aを転置するか (デフォルト: false)
+ * @param transB Bを転置するか (デフォルト: false)
+ */
+template<typename Derived1, typename Derived2>
+void gemm_into(Eigen::Ref<Eigen::Matrix<typename Derived1::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+               const Eigen::MatrixBase<Derived1>& A,
+               const Eigen::MatrixBase<Derived2>& B,
+               double alpha = 1.0,
+               bool transA = false,
+               bool transB = false) {
+    if (transA && transB) {
+        out.noalias() = alpha * A.transpose() * B.transpose();
+    } else if (transA) {
+        out.noalias() = alpha * A.transpose() * B;
+    } else if (transB) {
+        out.noalias() = alpha * A * B.transpose();
+    } else {
+        out.noalias() = alpha * A * B;
+    }
+}
+
 /**
  * ONNX Gemm operator
  *
@@ -29,18 +94,9 @@ auto gemm(const Eigen::MatrixBase<Derived1>& A,
           bool transA = false,
           bool transB = false) {
     typedef typename Derived1::Scalar Scalar;
-    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Y;
-
-    if (transA && transB) {
-        Y = alpha * A.transpose() * B.transpose() + beta * C;
-    } else if (transA) {
-        Y = alpha * A.transpose() * B + beta * C;
-    } else if (transB) {
-        Y = alpha * A * B.transpose() + beta * C;
-    } else {
-        Y = alpha * A * B + beta * C;
-    }
-
+    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Y(transA ? A.cols() : A.rows(),
+                                                            transB ? B.rows() : B.cols());
+    gemm_into(Y, A, B, C, alpha, beta, transA, transB);
     return Y;
 }
 
@@ -52,18 +108,9 @@ auto gemm(const Eigen::MatrixBase<Derived1>& A,
           bool transA = false,
           bool transB = false) {
     typedef typename Derived1::Scalar Scalar;
-    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Y;
-
-    if (transA && transB) {
-        Y = alpha * A.transpose() * B.transpose();
-    } else if (transA) {
-        Y = alpha * A.transpose() * B;
-    } else if (transB) {
-        Y = alpha * A * B.transpose();
-    } else {
-        Y = alpha * A * B;
-    }
-
+    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Y(transA ? A.cols() : A.rows(),
+                                                            transB ? B.rows() : B.cols());
+    gemm_into(Y, A, B, alpha, transA, transB);
     return Y;
 }
 
@@ -20,6 +20,22 @@ auto matmul(const Eigen::MatrixBase<Derived1>& A,
     return (A * B).eval();
 }
 
+/**
+ * MatMul を呼び出し側のバッファに書き込む
+ *
+ * 積を out に直接評価する (一時行列なし)。out は A, B と重ならないこと。
+ *
+ * @param out 出力 (A.rows() x B.cols()、呼び出し側で確保)
+ * @param A 入力行列
+ * @param B 入力行列
+ */
+template<typename Derived1, typename Derived2>
+void matmul_into(Eigen::Ref<Eigen::Matrix<typename Derived1::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                 const Eigen::MatrixBase<Derived1>& A,
+                 const Eigen::MatrixBase<Derived2>& B) {
+    out.noalias() = A * B;
+}
+
 } // namespace onnx
 
 #endif // ONNX_05_MATMUL_HPP
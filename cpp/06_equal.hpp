@@ -6,32 +6,51 @@
 namespace onnx {
 
 /**
- * ONNX Equal operator
+ * Equal を呼び出し側のバッファに書き込む
  *
- * 要素ごとの等価比較を行う。
- * ブロードキャストをサポート。
+ * 出力は A と同じ形状で、真なら 1.0、偽なら 0.0 を書き込む。
+ * out may be A itself (or B when B has A's shape): each element is read
+ * before it is overwritten.
  *
+ * @param out 出力 (A と同じ形状、呼び出し側で確保)
  * @param A 入力テンソル1
  * @param B 入力テンソル2
- * @return C: A == B の結果（ブール配列）
  */
 template<typename Derived1, typename Derived2>
-auto equal(const Eigen::MatrixBase<Derived1>& A,
-           const Eigen::MatrixBase<Derived2>& B) {
+void equal_into(Eigen::Ref<Eigen::MatrixXd> out,
+                const Eigen::MatrixBase<Derived1>& A,
+                const Eigen::MatrixBase<Derived2>& B) {
     // Same shape - direct comparison
     if (A.rows() == B.rows() && A.cols() == B.cols()) {
-        return (A.array() == B.array()).template cast<double>();
+        out = (A.array() == B.array()).template cast<double>().matrix();
+        return;
     }
 
     // Broadcasting
-    Eigen::MatrixXd result(A.rows(), A.cols());
     for (int i = 0; i < A.rows(); ++i) {
         for (int j = 0; j < A.cols(); ++j) {
             int bi = (B.rows() == 1) ? 0 : i;
             int bj = (B.cols() == 1) ? 0 : j;
-            result(i, j) = (A(i, j) == B(bi, bj)) ? 1.0 : 0.0;
+            out(i, j) = (A(i, j) == B(bi, bj)) ? 1.0 : 0.0;
         }
     }
+}
+
+/**
+ * ONNX Equal operator
+ *
+ * 要素ごとの等価比較を行う。
+ * ブロードキャストをサポート。
+ *
+ * @param A 入力テンソル1
+ * @param B 入力テンソル2
+ * @return C: A == B の結果（ブール配列）
+ */
+template<typename Derived1, typename Derived2>
+Eigen::MatrixXd equal(const Eigen::MatrixBase<Derived1>& A,
+                      const Eigen::MatrixBase<Derived2>& B) {
+    Eigen::MatrixXd result(A.rows(), A.cols());
+    equal_into(result, A, B);
     return result;
 }
 
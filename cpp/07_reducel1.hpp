@@ -6,48 +6,51 @@
 namespace onnx {
 
 /**
- * ONNX ReduceL1 operator
+ * ReduceL1 を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿ってL1ノルム（絶対値の和）を計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return L1ノルム
  */
 template<typename Derived>
-auto reducel1(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
-    typedef typename Derived::Scalar Scalar;
-
+void reducel1_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                   const Eigen::MatrixBase<Derived>& data,
+                   int axis = -1) {
     if (axis == -1) {
         // L1 norm of all elements
-        Scalar norm = data.array().abs().sum();
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = norm;
-            return result;
-        } else {
-            return norm;
-        }
+        out(0, 0) = data.array().abs().sum();
     } else if (axis == 0) {
         // L1 norm along columns
-        auto norm = data.array().abs().colwise().sum();
-        if (keepdims) {
-            return norm.matrix().eval();
-        } else {
-            return norm.matrix().eval();
-        }
+        out = data.array().abs().colwise().sum().matrix();
     } else {
         // L1 norm along rows (axis == 1)
-        auto norm = data.array().abs().rowwise().sum();
-        if (keepdims) {
-            return norm.matrix().eval();
-        } else {
-            return norm.matrix().eval();
-        }
+        out = data.array().abs().rowwise().sum().matrix();
     }
 }
 
+/**
+ * ONNX ReduceL1 operator
+ *
+ * 指定された軸に沿ってL1ノルム（絶対値の和）を計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return L1ノルム
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reducel1(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reducel1_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCEL1_HPP
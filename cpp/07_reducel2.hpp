@@ -7,46 +7,51 @@
 namespace onnx {
 
 /**
- * ONNX ReduceL2 operator
+ * ReduceL2 を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿ってL2ノルムを計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return L2ノルム
  */
 template<typename Derived>
-auto reducel2(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
-    typedef typename Derived::Scalar Scalar;
-
+void reducel2_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                   const Eigen::MatrixBase<Derived>& data,
+                   int axis = -1) {
     if (axis == -1) {
         // L2 norm of all elements
-        Scalar norm = data.norm();
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = norm;
-            return result;
-        } else {
-            return norm;
-        }
+        out(0, 0) = data.norm();
     } else if (axis == 0) {
         // L2 norm along columns
-        Eigen::Matrix<Scalar, 1, Eigen::Dynamic> result(1, data.cols());
-        for (int j = 0; j < data.cols(); ++j) {
-            result(0, j) = data.col(j).norm();
-        }
-        return result;
+        out = data.colwise().norm();
     } else {
         // L2 norm along rows (axis == 1)
-        Eigen::Matrix<Scalar, Eigen::Dynamic, 1> result(data.rows(), 1);
-        for (int i = 0; i < data.rows(); ++i) {
-            result(i, 0) = data.row(i).norm();
-        }
-        return result;
+        out = data.rowwise().norm();
     }
 }
 
+/**
+ * ONNX ReduceL2 operator
+ *
+ * 指定された軸に沿ってL2ノルムを計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return L2ノルム
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reducel2(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reducel2_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCEL2_HPP
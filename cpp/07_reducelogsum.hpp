@@ -7,48 +7,51 @@
 namespace onnx {
 
 /**
- * ONNX ReduceLogSum operator
+ * ReduceLogSum を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿ってlog(sum(x))を計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return log(sum(x))
  */
 template<typename Derived>
-auto reducelogsum(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
-    typedef typename Derived::Scalar Scalar;
-
+void reducelogsum_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                       const Eigen::MatrixBase<Derived>& data,
+                       int axis = -1) {
     if (axis == -1) {
-        // LogSum of all elements
-        Scalar log_sum = std::log(data.sum());
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = log_sum;
-            return result;
-        } else {
-            return log_sum;
-        }
+        // Log of sum of all elements
+        out(0, 0) = std::log(data.sum());
     } else if (axis == 0) {
-        // LogSum along columns
-        auto sums = data.colwise().sum();
-        Eigen::Matrix<Scalar, 1, Eigen::Dynamic> result(1, data.cols());
-        for (int j = 0; j < data.cols(); ++j) {
-            result(0, j) = std::log(sums(j));
-        }
-        return result;
+        // Log of sum along columns
+        out = data.colwise().sum().array().log().matrix();
     } else {
-        // LogSum along rows (axis == 1)
-        auto sums = data.rowwise().sum();
-        Eigen::Matrix<Scalar, Eigen::Dynamic, 1> result(data.rows(), 1);
-        for (int i = 0; i < data.rows(); ++i) {
-            result(i, 0) = std::log(sums(i));
-        }
-        return result;
+        // Log of sum along rows (axis == 1)
+        out = data.rowwise().sum().array().log().matrix();
     }
 }
 
+/**
+ * ONNX ReduceLogSum operator
+ *
+ * 指定された軸に沿ってlog(sum(x))を計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return log(sum(x))
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reducelogsum(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reducelogsum_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCELOGSUM_HPP
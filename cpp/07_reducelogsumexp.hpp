@@ -7,50 +7,61 @@
 namespace onnx {
 
 /**
- * ONNX ReduceLogSumExp operator
+ * ReduceLogSumExp を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿ってlog(sum(exp(x)))を計算する。
- * 数値安定性のため、最大値を引いてから計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return log(sum(exp(x)))
  */
 template<typename Derived>
-auto reducelogsumexp(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+void reducelogsumexp_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                          const Eigen::MatrixBase<Derived>& data,
+                          int axis = -1) {
     typedef typename Derived::Scalar Scalar;
 
     if (axis == -1) {
         // LogSumExp of all elements
         Scalar max_val = data.maxCoeff();
-        Scalar lse = max_val + std::log((data.array() - max_val).exp().sum());
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = lse;
-            return result;
-        } else {
-            return lse;
-        }
+        out(0, 0) = max_val + std::log((data.array() - max_val).exp().sum());
     } else if (axis == 0) {
         // LogSumExp along columns
-        Eigen::Matrix<Scalar, 1, Eigen::Dynamic> result(1, data.cols());
         for (int j = 0; j < data.cols(); ++j) {
             Scalar max_val = data.col(j).maxCoeff();
-            result(0, j) = max_val + std::log((data.col(j).array() - max_val).exp().sum());
+            out(0, j) = max_val + std::log((data.col(j).array() - max_val).exp().sum());
         }
-        return result;
     } else {
         // LogSumExp along rows (axis == 1)
-        Eigen::Matrix<Scalar, Eigen::Dynamic, 1> result(data.rows(), 1);
         for (int i = 0; i < data.rows(); ++i) {
             Scalar max_val = data.row(i).maxCoeff();
-            result(i, 0) = max_val + std::log((data.row(i).array() - max_val).exp().sum());
+            out(i, 0) = max_val + std::log((data.row(i).array() - max_val).exp().sum());
         }
-        return result;
     }
 }
 
+/**
+ * ONNX ReduceLogSumExp operator
+ *
+ * 指定された軸に沿ってlog(sum(exp(x)))を計算する。
+ * 数値安定性のため、最大値を引いてから計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return log(sum(exp(x)))
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reducelogsumexp(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reducelogsumexp_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCELOGSUMEXP_HPP
@@ -6,48 +6,51 @@
 namespace onnx {
 
 /**
- * ONNX ReduceMax operator
+ * ReduceMax を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿って最大値を計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return 最大値
  */
 template<typename Derived>
-auto reducemax(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
-    typedef typename Derived::Scalar Scalar;
-
+void reducemax_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                    const Eigen::MatrixBase<Derived>& data,
+                    int axis = -1) {
     if (axis == -1) {
         // Max of all elements
-        Scalar max_val = data.maxCoeff();
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = max_val;
-            return result;
-        } else {
-            return max_val;
-        }
+        out(0, 0) = data.maxCoeff();
     } else if (axis == 0) {
         // Max along columns
-        auto max_val = data.colwise().maxCoeff();
-        if (keepdims) {
-            return max_val.eval();
-        } else {
-            return max_val.eval();
-        }
+        out = data.colwise().maxCoeff();
     } else {
         // Max along rows (axis == 1)
-        auto max_val = data.rowwise().maxCoeff();
-        if (keepdims) {
-            return max_val.eval();
-        } else {
-            return max_val.eval();
-        }
+        out = data.rowwise().maxCoeff();
     }
 }
 
+/**
+ * ONNX ReduceMax operator
+ *
+ * 指定された軸に沿って最大値を計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return 最大値
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reducemax(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reducemax_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCEMAX_HPP
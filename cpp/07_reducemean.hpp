@@ -6,48 +6,51 @@
 namespace onnx {
 
 /**
- * ONNX ReduceMean operator
+ * ReduceMean を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿って平均を計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return 平均値
  */
 template<typename Derived>
-auto reducemean(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
-    typedef typename Derived::Scalar Scalar;
-
+void reducemean_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                     const Eigen::MatrixBase<Derived>& data,
+                     int axis = -1) {
     if (axis == -1) {
         // Mean of all elements
-        Scalar mean = data.mean();
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = mean;
-            return result;
-        } else {
-            return mean;
-        }
+        out(0, 0) = data.mean();
     } else if (axis == 0) {
         // Mean along columns
-        auto mean = data.colwise().mean();
-        if (keepdims) {
-            return mean.eval();
-        } else {
-            return mean.eval();
-        }
+        out = data.colwise().mean();
     } else {
         // Mean along rows (axis == 1)
-        auto mean = data.rowwise().mean();
-        if (keepdims) {
-            return mean.eval();
-        } else {
-            return mean.eval();
-        }
+        out = data.rowwise().mean();
     }
 }
 
+/**
+ * ONNX ReduceMean operator
+ *
+ * 指定された軸に沿って平均を計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return 平均値
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reducemean(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reducemean_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCEMEAN_HPP
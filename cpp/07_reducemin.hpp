@@ -6,48 +6,51 @@
 namespace onnx {
 
 /**
- * ONNX ReduceMin operator
+ * ReduceMin を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿って最小値を計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return 最小値
  */
 template<typename Derived>
-auto reducemin(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
-    typedef typename Derived::Scalar Scalar;
-
+void reducemin_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                    const Eigen::MatrixBase<Derived>& data,
+                    int axis = -1) {
     if (axis == -1) {
         // Min of all elements
-        Scalar min_val = data.minCoeff();
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = min_val;
-            return result;
-        } else {
-            return min_val;
-        }
+        out(0, 0) = data.minCoeff();
     } else if (axis == 0) {
         // Min along columns
-        auto min_val = data.colwise().minCoeff();
-        if (keepdims) {
-            return min_val.eval();
-        } else {
-            return min_val.eval();
-        }
+        out = data.colwise().minCoeff();
     } else {
         // Min along rows (axis == 1)
-        auto min_val = data.rowwise().minCoeff();
-        if (keepdims) {
-            return min_val.eval();
-        } else {
-            return min_val.eval();
-        }
+        out = data.rowwise().minCoeff();
     }
 }
 
+/**
+ * ONNX ReduceMin operator
+ *
+ * 指定された軸に沿って最小値を計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return 最小値
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reducemin(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reducemin_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCEMIN_HPP
@@ -6,46 +6,51 @@
 namespace onnx {
 
 /**
- * ONNX ReduceProd operator
+ * ReduceProd を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿って積を計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return 積
  */
 template<typename Derived>
-auto reduceprod(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
-    typedef typename Derived::Scalar Scalar;
-
+void reduceprod_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                     const Eigen::MatrixBase<Derived>& data,
+                     int axis = -1) {
     if (axis == -1) {
         // Product of all elements
-        Scalar prod = data.prod();
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = prod;
-            return result;
-        } else {
-            return prod;
-        }
+        out(0, 0) = data.prod();
     } else if (axis == 0) {
         // Product along columns
-        Eigen::Matrix<Scalar, 1, Eigen::Dynamic> result(1, data.cols());
-        for (int j = 0; j < data.cols(); ++j) {
-            result(0, j) = data.col(j).prod();
-        }
-        return result;
+        out = data.colwise().prod();
     } else {
         // Product along rows (axis == 1)
-        Eigen::Matrix<Scalar, Eigen::Dynamic, 1> result(data.rows(), 1);
-        for (int i = 0; i < data.rows(); ++i) {
-            result(i, 0) = data.row(i).prod();
-        }
-        return result;
+        out = data.rowwise().prod();
     }
 }
 
+/**
+ * ONNX ReduceProd operator
+ *
+ * 指定された軸に沿って積を計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return 積
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reduceprod(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reduceprod_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCEPROD_HPP
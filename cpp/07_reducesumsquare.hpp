@@ -6,48 +6,51 @@
 namespace onnx {
 
 /**
- * ONNX ReduceSumSquare operator
+ * ReduceSumSquare を呼び出し側のバッファに書き込む
  *
- * 指定された軸に沿って二乗和を計算する。
+ * 出力の形状は axis = -1 で 1x1、axis = 0 で 1 x cols、axis = 1 で rows x 1
+ * (2D では keepdims で形状は変わらない)。
  *
+ * @param out 出力 (呼び出し側で確保)
  * @param data 入力テンソル
  * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
- * @param keepdims 次元を保持するか (デフォルト: true)
- * @return 二乗和
  */
 template<typename Derived>
-auto reducesumsquare(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
-    typedef typename Derived::Scalar Scalar;
-
+void reducesumsquare_into(Eigen::Ref<Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>> out,
+                          const Eigen::MatrixBase<Derived>& data,
+                          int axis = -1) {
     if (axis == -1) {
         // Sum of squares of all elements
-        Scalar sum_sq = data.array().square().sum();
-        if (keepdims) {
-            Eigen::Matrix<Scalar, 1, 1> result;
-            result(0, 0) = sum_sq;
-            return result;
-        } else {
-            return sum_sq;
-        }
+        out(0, 0) = data.array().square().sum();
     } else if (axis == 0) {
         // Sum of squares along columns
-        auto sum_sq = data.array().square().colwise().sum();
-        if (keepdims) {
-            return sum_sq.matrix().eval();
-        } else {
-            return sum_sq.matrix().eval();
-        }
+        out = data.array().square().colwise().sum().matrix();
     } else {
         // Sum of squares along rows (axis == 1)
-        auto sum_sq = data.array().square().rowwise().sum();
-        if (keepdims) {
-            return sum_sq.matrix().eval();
-        } else {
-            return sum_sq.matrix().eval();
-        }
+        out = data.array().square().rowwise().sum().matrix();
     }
 }
 
+/**
+ * ONNX ReduceSumSquare operator
+ *
+ * 指定された軸に沿って二乗和を計算する。
+ *
+ * @param data 入力テンソル
+ * @param axis 削減する軸 (0: 列方向, 1: 行方向, -1: 全要素, デフォルト: -1)
+ * @param keepdims 次元を保持するか (デフォルト: true)
+ * @return 二乗和
+ */
+template<typename Derived>
+Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+reducesumsquare(const Eigen::MatrixBase<Derived>& data, int axis = -1, bool keepdims = true) {
+    (void)keepdims;  // 2D: the reduced axis is kept as size 1 either way
+    Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Eigen::Dynamic> result(
+        (axis == -1 || axis == 0) ? 1 : data.rows(), (axis == 0) ? data.cols() : 1);
+    reducesumsquare_into(result, data, axis);
+    return result;
+}
+
 } // namespace onnx
 
 #endif // ONNX_07_REDUCESUMSQUARE_HPP
@@ -2,19 +2,117 @@
 #define ONNX_08_PAD_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 #include <string>
 
 namespace onnx {
 
+/**
+ * Helper function: パディング後の座標を入力座標に変換する
+ *
+ * i は入力の座標系 (負の値や n 以上はパディング領域)。
+ * constant では範囲外に対して -1 を返す。
+ * reflect は端の要素を含まない鏡映、edge は端の複製、wrap は周期的な折り返し。
+ */
+inline int pad_source_index(int i, int n, const std::string& mode) {
+    if (i >= 0 && i < n) return i;
+    if (mode == "reflect") {
+        if (n == 1) return 0;
+        const int period = 2 * (n - 1);
+        i %= period;
+        if (i < 0) i += period;
+        return (i < n) ? i : period - i;
+    }
+    if (mode == "edge") {
+        return (i < 0) ? 0 : n - 1;
+    }
+    if (mode == "wrap") {
+        i %= n;
+        return (i < 0) ? i + n : i;
+    }
+    return -1;
+}
+
+/**
+ * Helper function: 1軸分のパディング対応表
+ *
+ * 出力位置 o の入力位置 pad_source_index(o - pad_begin, n, mode) を並べる。
+ */
+inline std::vector<int> pad_source_table(int n, int pad_begin, int pad_end, const std::string& mode) {
+    std::vector<int> table(std::max(0, n + pad_begin + pad_end));
+    for (size_t o = 0; o < table.size(); ++o) {
+        table[o] = pad_source_index(static_cast<int>(o) - pad_begin, n, mode);
+    }
+    return table;
+}
+
+/**
+ * Pad を呼び出し側のバッファに書き込む
+ *
+ * Output columns are filled from the source column given by a per-axis
+ * table; the rows inside the input are copied as one contiguous segment.
+ *
+ * @param out 出力 ((rows + top + bottom) x (cols + left + right))、呼び出し側で確保。data と重ならないこと
+ * @param data 入力テンソル
+ * @param pads パディング量 [top, left, bottom, right] for 2D
+ * @param mode パディングモード ("constant", "reflect", "edge", "wrap")
+ * @param constant_value constantモード時の値 (デフォルト: 0)
+ */
+template<typename Derived>
+void pad_into(Eigen::Ref<Eigen::MatrixXd> out,
+              const Eigen::MatrixBase<Derived>& data,
+              const std::vector<int>& pads,
+              const std::string& mode = "constant",
+              double constant_value = 0.0) {
+    const Eigen::Ref<const Eigen::MatrixXd> src(data);
+
+    int rows = src.rows();
+    int cols = src.cols();
+
+    // pads: [top, left, bottom, right] for 2D matrix
+    int pad_top = pads[0];
+    int pad_left = pads[1];
+    int pad_bottom = pads[2];
+    int pad_right = pads[3];
+
+    std::vector<int> row_src = pad_source_table(rows, pad_top, pad_bottom, mode);
+    std::vector<int> col_src = pad_source_table(cols, pad_left, pad_right, mode);
+
+    const int new_rows = row_src.size();
+    const int new_cols = col_src.size();
+
+    // Output rows that lie inside the input
+    const int lo = std::min(new_rows, std::max(0, pad_top));
+    const int hi = std::max(lo, std::min(new_rows, pad_top + rows));
+
+    for (int j = 0; j < new_cols; ++j) {
+        if (col_src[j] < 0) {
+            out.col(j).setConstant(constant_value);
+            continue;
+        }
+        auto src_col = src.col(col_src[j]);
+        out.col(j).segment(lo, hi - lo) = src_col.segment(lo - pad_top, hi - lo);
+        for (int i = 0; i < lo; ++i) {
+            out(i, j) = (row_src[i] < 0) ? constant_value : src_col(row_src[i]);
+        }
+        for (int i = hi; i < new_rows; ++i) {
+            out(i, j) = (row_src[i] < 0) ? constant_value : src_col(row_src[i]);
+        }
+    }
+}
+
 /**
  * ONNX Pad operator
  *
  * テンソルにパディングを追加する。
+ * 出力を確保して pad_into() を呼ぶ。
  *
  * @param data 入力テンソル
  * @param pads パディング量 [top, left, bottom, right] for 2D
- * @param mode パディングモード ("constant", "reflect", "edge")
+ * @param mode パディングモード ("constant", "reflect", "edge", "wrap")
  * @param constant_value constantモード時の値 (デフォルト: 0)
  * @return パディングされたテンソル
  */
@@ -23,112 +121,299 @@ Eigen::MatrixXd pad(const Eigen::MatrixBase<Derived>& data,
                     const std::vector<int>& pads,
                     const std::string& mode = "constant",
                     double constant_value = 0.0) {
-    typedef typename Derived::Scalar Scalar;
+    Eigen::MatrixXd result(std::max(0, static_cast<int>(data.rows()) + pads[0] + pads[2]),
+                           std::max(0, static_cast<int>(data.cols()) + pads[1] + pads[3]));
+    pad_into(result, data, pads, mode, constant_value);
+    return result;
+}
 
-    int rows = data.rows();
-    int cols = data.cols();
+/**
+ * Pad (N-D) の出力形状
+ *
+ * @param shape 入力テンソルの形状
+ * @param pads パディング量 [x1_begin, x2_begin, ..., x1_end, x2_end, ...] (axes の順)
+ * @param axes パディングする軸 (負の値は末尾から数える) - optional, 省略時は全軸
+ * @return 各軸 shape[d] + begin + end (負になる場合は 0)
+ */
+inline std::vector<int> pad_output_shape(const std::vector<int>& shape,
+                                         const std::vector<int>& pads,
+                                         const std::vector<int>* axes = nullptr) {
+    const int rank = shape.size();
+    std::vector<int> out(shape);
+    const int n_axes = (axes != nullptr) ? static_cast<int>(axes->size()) : rank;
+    for (int k = 0; k < n_axes; ++k) {
+        int a = (axes != nullptr) ? (*axes)[k] : k;
+        if (a < 0) a += rank;
+        out[a] = std::max(0, shape[a] + pads[k] + pads[n_axes + k]);
+    }
+    return out;
+}
 
-    // pads: [top, left, bottom, right] for 2D matrix
-    int pad_top = pads[0];
-    int pad_left = pads[1];
-    int pad_bottom = pads[2];
-    int pad_right = pads[3];
+/**
+ * Pad (N-D) を呼び出し側のバッファに書き込む
+ *
+ * The output is produced one innermost row at a time: the source row is
+ * located through per-axis tables, the part inside the input is copied as
+ * one contiguous run and only the border elements go through the table.
+ * Negative pads crop the corresponding axis.
+ *
+ * @param output 出力 (pad_output_shape() の要素数)、呼び出し側で確保。data と重ならないこと
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param pads パディング量 [x1_begin, x2_begin, ..., x1_end, x2_end, ...] (axes の順)
+ * @param mode パディングモード ("constant", "reflect", "edge", "wrap")
+ * @param constant_value constantモード時の値 (デフォルト: 0)
+ * @param axes パディングする軸 (負の値は末尾から数える) - optional, 省略時は全軸
+ */
+inline void pad_into(Eigen::Ref<Eigen::VectorXd> output,
+                     const Eigen::VectorXd& data,
+                     const std::vector<int>& shape,
+                     const std::vector<int>& pads,
+                     const std::string& mode = "constant",
+                     double constant_value = 0.0,
+                     const std::vector<int>* axes = nullptr) {
+    const int rank = shape.size();
+    if (rank == 0) {
+        output = data;
+        return;
+    }
 
-    int new_rows = rows + pad_top + pad_bottom;
-    int new_cols = cols + pad_left + pad_right;
+    // Expand pads to every axis
+    std::vector<int> begin(rank, 0), end(rank, 0);
+    const int n_axes = (axes != nullptr) ? static_cast<int>(axes->size()) : rank;
+    for (int k = 0; k < n_axes; ++k) {
+        int a = (axes != nullptr) ? (*axes)[k] : k;
+        if (a < 0) a += rank;
+        begin[a] = pads[k];
+        end[a] = pads[n_axes + k];
+    }
 
-    Eigen::MatrixXd result(new_rows, new_cols);
+    std::vector<std::vector<int>> src_index(rank);
+    std::vector<int> out_shape(rank);
+    for (int d = 0; d < rank; ++d) {
+        src_index[d] = pad_source_table(shape[d], begin[d], end[d], mode);
+        out_shape[d] = src_index[d].size();
+    }
 
-    if (mode == "constant") {
-        // Fill with constant value
-        result.setConstant(constant_value);
+    std::vector<long> in_stride(rank);
+    in_stride[rank - 1] = 1;
+    for (int d = rank - 2; d >= 0; --d) in_stride[d] = in_stride[d + 1] * shape[d + 1];
 
-        // Copy original data
-        result.block(pad_top, pad_left, rows, cols) = data;
+    long total = 1;
+    for (int d = 0; d < rank; ++d) total *= out_shape[d];
+    if (total == 0) return;
 
-    } else if (mode == "reflect") {
-        // Fill center with original data
-        result.block(pad_top, pad_left, rows, cols) = data;
+    const int n = shape[rank - 1];
+    const int out_n = out_shape[rank - 1];
+    const std::vector<int>& inner = src_index[rank - 1];
+    const int lo = std::min(out_n, std::max(0, begin[rank - 1]));
+    const int hi = std::max(lo, std::min(out_n, begin[rank - 1] + n));
 
-        // Reflect top
-        for (int i = 0; i < pad_top; ++i) {
-            int src_row = pad_top - i;
-            for (int j = pad_left; j < pad_left + cols; ++j) {
-                result(i, j) = result(src_row, j);
-            }
-        }
+    const long rows = total / out_n;
+    std::vector<int> idx(rank - 1, 0);
 
-        // Reflect bottom
-        for (int i = 0; i < pad_bottom; ++i) {
-            int src_row = pad_top + rows - 2 - i;
-            for (int j = pad_left; j < pad_left + cols; ++j) {
-                result(pad_top + rows + i, j) = result(src_row, j);
-            }
+    for (long r = 0; r < rows; ++r) {
+        double* dst = output.data() + r * out_n;
+
+        // Source row offset (-1: the row lies in the constant padding)
+        long offset = 0;
+        for (int d = 0; d < rank - 1 && offset >= 0; ++d) {
+            int s = src_index[d][idx[d]];
+            offset = (s < 0) ? -1 : offset + s * in_stride[d];
         }
 
-        // Reflect left
-        for (int i = 0; i < new_rows; ++i) {
-            for (int j = 0; j < pad_left; ++j) {
-                int src_col = pad_left + (pad_left - j);
-                if (src_col < pad_left + cols) {
-                    result(i, j) = result(i, src_col);
-                }
-            }
+        if (offset < 0) {
+            std::fill(dst, dst + out_n, constant_value);
+        } else {
+            const double* src = data.data() + offset;
+            std::copy(src + (lo - begin[rank - 1]), src + (hi - begin[rank - 1]), dst + lo);
+            for (int o = 0; o < lo; ++o) dst[o] = (inner[o] < 0) ? constant_value : src[inner[o]];
+            for (int o = hi; o < out_n; ++o) dst[o] = (inner[o] < 0) ? constant_value : src[inner[o]];
         }
 
-        // Reflect right
-        for (int i = 0; i < new_rows; ++i) {
-            for (int j = 0; j < pad_right; ++j) {
-                int src_col = pad_left + cols - 2 - j;
-                if (src_col >= pad_left) {
-                    result(i, pad_left + cols + j) = result(i, src_col);
-                }
-            }
+        // Advance odometer over the outer axes
+        for (int d = rank - 2; d >= 0; --d) {
+            if (++idx[d] < out_shape[d]) break;
+            idx[d] = 0;
         }
+    }
+}
 
-    } else if (mode == "edge") {
-        // Fill center with original data
-        result.block(pad_top, pad_left, rows, cols) = data;
+/**
+ * ONNX Pad operator (N-D)
+ *
+ * テンソルにパディングを追加する。
+ * 出力を確保して pad_into() を呼ぶ。
+ *
+ * @param data 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状
+ * @param pads パディング量 [x1_begin, x2_begin, ..., x1_end, x2_end, ...] (axes の順)
+ * @param mode パディングモード ("constant", "reflect", "edge", "wrap")
+ * @param constant_value constantモード時の値 (デフォルト: 0)
+ * @param axes パディングする軸 (負の値は末尾から数える) - optional, 省略時は全軸
+ * @return パディングされたテンソル (flattened, row-major)
+ */
+inline Eigen::VectorXd pad(const Eigen::VectorXd& data,
+                           const std::vector<int>& shape,
+                           const std::vector<int>& pads,
+                           const std::string& mode = "constant",
+                           double constant_value = 0.0,
+                           const std::vector<int>* axes = nullptr) {
+    if (shape.empty()) return data;
+    long total = 1;
+    for (int d : pad_output_shape(shape, pads, axes)) total *= d;
+    Eigen::VectorXd result(total);
+    pad_into(result, data, shape, pads, mode, constant_value, axes);
+    return result;
+}
 
-        // Edge top
-        for (int i = 0; i < pad_top; ++i) {
-            for (int j = pad_left; j < pad_left + cols; ++j) {
-                result(i, j) = data(0, j - pad_left);
-            }
+/**
+ * Pad を後段の Conv / MaxPool / AveragePool に融合する
+ *
+ * (N, C, H, W) に対する Pad が H, W 軸の非負パディングのみで、後段の演算が
+ * そのパディングを暗黙に扱える場合、パディング量を後段の pads に加算して true を返す。
+ * この場合 Pad の出力を実体化する必要はない。
+ *
+ * - Conv: constant 0。reflect / edge / wrap は Conv の pads が 0 のとき pad_mode に設定
+ * - AveragePool: constant 0 で、後段が count_include_pad = true の場合のみ
+ *   (Pad のゼロは実データなので除数に含める必要がある。count_include_pad = false
+ *   では融合後のパディングが除数から外れ、結果が変わる)
+ * - MaxPool: constant -inf
+ *
+ * @param pads Pad のパディング量 [N_begin, C_begin, H_begin, W_begin, N_end, C_end, H_end, W_end]
+ * @param mode Pad のパディングモード
+ * @param constant_value Pad の constant 値
+ * @param consumer 後段の演算 ("Conv", "MaxPool", "AveragePool")
+ * @param pad_top 後段の上パディング (in/out)
+ * @param pad_left 後段の左パディング (in/out)
+ * @param pad_bottom 後段の下パディング (in/out)
+ * @param pad_right 後段の右パディング (in/out)
+ * @param pad_mode 後段 Conv のパディングモード (in/out) - optional
+ * @param count_include_pad 後段 AveragePool の count_include_pad (AveragePool 以外では無視)
+ * @return 融合できた場合 true (false の場合は出力引数を変更しない)
+ */
+inline bool pad_fold_into_consumer(const std::vector<int>& pads,
+                                   const std::string& mode,
+                                   double constant_value,
+                                   const std::string& consumer,
+                                   int& pad_top, int& pad_left,
+                                   int& pad_bottom, int& pad_right,
+                                   std::string* pad_mode = nullptr,
+                                   bool count_include_pad = false) {
+    if (pads.size() != 8) return false;
+    if (pads[0] != 0 || pads[1] != 0 || pads[4] != 0 || pads[5] != 0) return false;
+    for (int k : {2, 3, 6, 7}) {
+        if (pads[k] < 0) return false;
+    }
+
+    const bool constant = (mode == "constant");
+    bool foldable = false;
+    if (consumer == "Conv") {
+        if (constant && constant_value == 0.0 && (pad_mode == nullptr || *pad_mode == "constant")) {
+            foldable = true;
+        } else if (!constant && pad_mode != nullptr &&
+                   pad_top == 0 && pad_left == 0 && pad_bottom == 0 && pad_right == 0) {
+            *pad_mode = mode;
+            foldable = true;
         }
+    } else if (consumer == "AveragePool") {
+        foldable = constant && constant_value == 0.0 && count_include_pad;
+    } else if (consumer == "MaxPool") {
+        foldable = constant && constant_value == -std::numeric_limits<double>::infinity();
+    }
+    if (!foldable) return false;
 
-        // Edge bottom
-        for (int i = 0; i < pad_bottom; ++i) {
-            for (int j = pad_left; j < pad_left + cols; ++j) {
-                result(pad_top + rows + i, j) = data(rows - 1, j - pad_left);
-            }
+    pad_top += pads[2];
+    pad_left += pads[3];
+    pad_bottom += pads[6];
+    pad_right += pads[7];
+    return true;
+}
+
+/**
+ * Pad (NHWC) を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation for (1, H, W, C) channel-last input. Interior rows are
+ * copied as one contiguous run of W * C values; border pixels copy whole
+ * channel vectors. Negative pads crop, as in pad_into().
+ *
+ * @param output 出力 (長さ (H + top + bottom) * (W + left + right) * C)、呼び出し側で確保。data と重ならないこと
+ * @param data 入力テンソル (flattened (H, W, C), row-major)
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param C チャネル数
+ * @param pads パディング量 [top, left, bottom, right] (負の値は切り取り)
+ * @param mode パディングモード ("constant", "reflect", "edge", "wrap")
+ * @param constant_value constantモード時の値 (デフォルト: 0)
+ */
+inline void pad_nhwc_into(Eigen::Ref<Eigen::VectorXd> output,
+                          const Eigen::VectorXd& data,
+                          int H, int W, int C,
+                          const std::vector<int>& pads,
+                          const std::string& mode = "constant",
+                          double constant_value = 0.0) {
+    int pad_top = pads[0];
+    int pad_left = pads[1];
+    int pad_bottom = pads[2];
+    int pad_right = pads[3];
+
+    int new_H = H + pad_top + pad_bottom;
+    int new_W = W + pad_left + pad_right;
+    int w_lo = std::max(0, -pad_left);
+    int w_hi = W - std::max(0, -pad_right);
+
+    for (int oh = 0; oh < new_H; ++oh) {
+        double* dst_row = output.data() + static_cast<long>(oh) * new_W * C;
+        int sh = pad_source_index(oh - pad_top, H, mode);
+        if (sh < 0) {
+            std::fill(dst_row, dst_row + static_cast<long>(new_W) * C, constant_value);
+            continue;
         }
+        const double* src_row = data.data() + static_cast<long>(sh) * W * C;
 
-        // Edge left
-        for (int i = 0; i < new_rows; ++i) {
-            for (int j = 0; j < pad_left; ++j) {
-                int src_row = i - pad_top;
-                if (src_row < 0) src_row = 0;
-                if (src_row >= rows) src_row = rows - 1;
-                result(i, j) = data(src_row, 0);
-            }
+        // Interior: contiguous copy (negative pads crop the source range)
+        if (w_hi > w_lo) {
+            std::copy(src_row + static_cast<long>(w_lo) * C, src_row + static_cast<long>(w_hi) * C,
+                      dst_row + static_cast<long>(w_lo + pad_left) * C);
         }
 
-        // Edge right
-        for (int i = 0; i < new_rows; ++i) {
-            for (int j = 0; j < pad_right; ++j) {
-                int src_row = i - pad_top;
-                if (src_row < 0) src_row = 0;
-                if (src_row >= rows) src_row = rows - 1;
-                result(i, pad_left + cols + j) = data(src_row, cols - 1);
+        // Left / right borders
+        auto border = [&](int ow) {
+            double* dst = dst_row + static_cast<long>(ow) * C;
+            int sw = pad_source_index(ow - pad_left, W, mode);
+            if (sw < 0) {
+                std::fill(dst, dst + C, constant_value);
+            } else {
+                std::copy(src_row + static_cast<long>(sw) * C, src_row + static_cast<long>(sw + 1) * C, dst);
             }
-        }
-    } else {
-        // Default to constant mode
-        result.setConstant(constant_value);
-        result.block(pad_top, pad_left, rows, cols) = data;
+        };
+        for (int ow = 0; ow < pad_left; ++ow) border(ow);
+        for (int ow = pad_left + W; ow < new_W; ++ow) border(ow);
     }
+}
 
+/**
+ * ONNX Pad operator (NHWC)
+ *
+ * テンソルの空間次元 (H, W) にパディングを追加する。
+ * 出力を確保して pad_nhwc_into() を呼ぶ。
+ *
+ * @param data 入力テンソル (flattened (H, W, C), row-major)
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param C チャネル数
+ * @param pads パディング量 [top, left, bottom, right]
+ * @param mode パディングモード ("constant", "reflect", "edge", "wrap")
+ * @param constant_value constantモード時の値 (デフォルト: 0)
+ * @return パディングされたテンソル (flattened (H + top + bottom, W + left + right, C))
+ */
+inline Eigen::VectorXd pad_nhwc(const Eigen::VectorXd& data,
+                                int H, int W, int C,
+                                const std::vector<int>& pads,
+                                const std::string& mode = "constant",
+                                double constant_value = 0.0) {
+    Eigen::VectorXd result(static_cast<long>(H + pads[0] + pads[2]) * (W + pads[1] + pads[3]) * C);
+    pad_nhwc_into(result, data, H, W, C, pads, mode, constant_value);
     return result;
 }
 
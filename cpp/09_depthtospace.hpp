@@ -2,6 +2,8 @@
 #define ONNX_09_DEPTHTOSPACE_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <string>
 #include <vector>
 
 namespace onnx {
@@ -19,8 +21,8 @@ namespace onnx {
  * @param blocksize ブロックサイズ
  * @return 再配置されたテンソル (single matrix)
  */
-std::vector<Eigen::MatrixXd> depthtospace(const std::vector<Eigen::MatrixXd>& input_channels,
-                                           int blocksize) {
+inline std::vector<Eigen::MatrixXd> depthtospace(const std::vector<Eigen::MatrixXd>& input_channels,
+                                                  int blocksize) {
     if (input_channels.empty()) {
         return std::vector<Eigen::MatrixXd>();
     }
@@ -78,7 +80,7 @@ Eigen::MatrixXd depthtospace_single(const std::vector<Eigen::MatrixXd>& input_ch
     Eigen::MatrixXd output(new_H, new_W);
 
     // Rearrange blocks from input channels
-    for (int c = 0; c < input_channels.size(); ++c) {
+    for (int c = 0; c < static_cast<int>(input_channels.size()); ++c) {
         int block_h = c / blocksize;
         int block_w = c % blocksize;
 
@@ -94,6 +96,157 @@ Eigen::MatrixXd depthtospace_single(const std::vector<Eigen::MatrixXd>& input_ch
     return output;
 }
 
+/**
+ * DepthToSpace (NCHW) を呼び出し側のバッファに書き込む
+ *
+ * Contiguous (1, C, H, W) tensor. Every output row (c, h * blocksize + bh)
+ * interleaves blocksize input rows of the same (h), so the permutation is
+ * done row by row: contiguous reads from blocksize source rows and one
+ * sequential store stream, without per-channel temporaries.
+ *
+ * DCR: 入力チャネル = (bh * blocksize + bw) * C_out + c
+ * CRD: 入力チャネル = c * blocksize^2 + bh * blocksize + bw
+ *
+ * @param output 出力 (X と同じ長さ)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (C, H, W), row-major)
+ * @param C 入力チャネル数 (blocksize^2 の倍数)
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param blocksize ブロックサイズ
+ * @param mode "DCR" (depth-column-row, ONNX既定) または "CRD" (column-row-depth)
+ */
+inline void depthtospace_into(Eigen::Ref<Eigen::VectorXd> output,
+                              const Eigen::VectorXd& X,
+                              int C, int H, int W,
+                              int blocksize,
+                              const std::string& mode = "DCR") {
+    const int b = blocksize;
+    const int bb = b * b;
+    const int new_C = C / bb;
+    const int new_W = W * b;
+    const long plane = static_cast<long>(H) * W;
+    const bool crd = (mode == "CRD");
+
+    for (int c = 0; c < new_C; ++c) {
+        for (int h = 0; h < H; ++h) {
+            for (int bh = 0; bh < b; ++bh) {
+                double* dst = output.data() + (static_cast<long>(c) * H * b + h * b + bh) * new_W;
+
+                // Source row of input channel for block (bh, bw)
+                auto row = [&](int bw) {
+                    int c_in = crd ? c * bb + bh * b + bw : (bh * b + bw) * new_C + c;
+                    return X.data() + c_in * plane + static_cast<long>(h) * W;
+                };
+
+                if (b == 2) {
+                    const double* s0 = row(0);
+                    const double* s1 = row(1);
+                    for (int w = 0; w < W; ++w) {
+                        dst[2 * w] = s0[w];
+                        dst[2 * w + 1] = s1[w];
+                    }
+                } else {
+                    for (int bw = 0; bw < b; ++bw) {
+                        const double* src = row(bw);
+                        for (int w = 0; w < W; ++w) dst[w * b + bw] = src[w];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * ONNX DepthToSpace operator (NCHW)
+ *
+ * チャネル次元を空間次元（H, W）に再配置する。
+ * 出力を確保して depthtospace_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (C, H, W), row-major)
+ * @param C 入力チャネル数 (blocksize^2 の倍数)
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param blocksize ブロックサイズ
+ * @param mode "DCR" (depth-column-row, ONNX既定) または "CRD" (column-row-depth)
+ * @return 再配置されたテンソル (flattened (C/blocksize^2, H*blocksize, W*blocksize))
+ */
+inline Eigen::VectorXd depthtospace(const Eigen::VectorXd& X,
+                                    int C, int H, int W,
+                                    int blocksize,
+                                    const std::string& mode = "DCR") {
+    Eigen::VectorXd output(X.size());
+    depthtospace_into(output, X, C, H, W, blocksize, mode);
+    return output;
+}
+
+/**
+ * DepthToSpace (NHWC) を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation for (1, H, W, C) channel-last input.
+ * In DCR mode each output pixel is a contiguous run of C / blocksize^2
+ * input channels, so the rearrangement is a sequence of block copies.
+ *
+ * @param output 出力 (X と同じ長さ)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param C 入力チャネル数 (blocksize^2 の倍数)
+ * @param blocksize ブロックサイズ
+ * @param mode "DCR" (depth-column-row, ONNX既定) または "CRD" (column-row-depth)
+ */
+inline void depthtospace_nhwc_into(Eigen::Ref<Eigen::VectorXd> output,
+                                   const Eigen::VectorXd& X,
+                                   int H, int W, int C,
+                                   int blocksize,
+                                   const std::string& mode = "DCR") {
+    const int bb = blocksize * blocksize;
+    const int new_C = C / bb;
+    const int new_W = W * blocksize;
+
+    for (int h = 0; h < H; ++h) {
+        for (int w = 0; w < W; ++w) {
+            const double* src = X.data() + (static_cast<long>(h) * W + w) * C;
+            for (int bh = 0; bh < blocksize; ++bh) {
+                for (int bw = 0; bw < blocksize; ++bw) {
+                    long dst_pixel = static_cast<long>(h * blocksize + bh) * new_W + (w * blocksize + bw);
+                    double* dst = output.data() + dst_pixel * new_C;
+                    int block_idx = bh * blocksize + bw;
+                    if (mode == "CRD") {
+                        for (int c = 0; c < new_C; ++c) {
+                            dst[c] = src[c * bb + block_idx];
+                        }
+                    } else {
+                        std::copy(src + block_idx * new_C, src + (block_idx + 1) * new_C, dst);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * ONNX DepthToSpace operator (NHWC)
+ *
+ * チャネル次元を空間次元（H, W）に再配置する。
+ * 出力を確保して depthtospace_nhwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param H 入力高さ
+ * @param W 入力幅
+ * @param C 入力チャネル数 (blocksize^2 の倍数)
+ * @param blocksize ブロックサイズ
+ * @param mode "DCR" (depth-column-row, ONNX既定) または "CRD" (column-row-depth)
+ * @return 再配置されたテンソル (flattened (H*blocksize, W*blocksize, C/blocksize^2))
+ */
+inline Eigen::VectorXd depthtospace_nhwc(const Eigen::VectorXd& X,
+                                         int H, int W, int C,
+                                         int blocksize,
+                                         const std::string& mode = "DCR") {
+    Eigen::VectorXd output(X.size());
+    depthtospace_nhwc_into(output, X, H, W, C, blocksize, mode);
+    return output;
+}
+
 } // namespace onnx
 
 #endif // ONNX_09_DEPTHTOSPACE_HPP
@@ -2,6 +2,8 @@
 #define ONNX_09_SPACETODEPTH_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <string>
 #include <vector>
 
 namespace onnx {
@@ -57,8 +59,8 @@ std::vector<Eigen::MatrixXd> spacetodepth(const Eigen::MatrixBase<Derived>& inpu
  * @param blocksize ブロックサイズ
  * @return 再配置されたテンソル (vector of matrices)
  */
-std::vector<Eigen::MatrixXd> spacetodepth_multi(const std::vector<Eigen::MatrixXd>& input_channels,
-                                                 int blocksize) {
+inline std::vector<Eigen::MatrixXd> spacetodepth_multi(const std::vector<Eigen::MatrixXd>& input_channels,
+                                                        int blocksize) {
     if (input_channels.empty()) {
         return std::vector<Eigen::MatrixXd>();
     }
@@ -94,6 +96,144 @@ std::vector<Eigen::MatrixXd> spacetodepth_multi(const std::vector<Eigen::MatrixX
     return output;
 }
 
+/**
+ * SpaceToDepth (NCHW) を呼び出し側のバッファに書き込む
+ *
+ * Contiguous (1, C, H, W) tensor. Each input row (c, h * blocksize + bh)
+ * is read once and de-interleaved into blocksize output rows, so loads
+ * are sequential and stores go to blocksize contiguous streams.
+ *
+ * DCR: 出力チャネル = (bh * blocksize + bw) * C + c (ONNX SpaceToDepth の並び)
+ * CRD: 出力チャネル = c * blocksize^2 + bh * blocksize + bw (DepthToSpace CRD の逆変換)
+ *
+ * @param output 出力 (X と同じ長さ)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (C, H, W), row-major)
+ * @param C 入力チャネル数
+ * @param H 入力高さ (blocksize の倍数)
+ * @param W 入力幅 (blocksize の倍数)
+ * @param blocksize ブロックサイズ
+ * @param mode "DCR" (既定) または "CRD"
+ */
+inline void spacetodepth_into(Eigen::Ref<Eigen::VectorXd> output,
+                              const Eigen::VectorXd& X,
+                              int C, int H, int W,
+                              int blocksize,
+                              const std::string& mode = "DCR") {
+    const int b = blocksize;
+    const int bb = b * b;
+    const int new_H = H / b;
+    const int new_W = W / b;
+    const long new_plane = static_cast<long>(new_H) * new_W;
+    const bool crd = (mode == "CRD");
+
+    for (int c = 0; c < C; ++c) {
+        for (int h = 0; h < new_H; ++h) {
+            for (int bh = 0; bh < b; ++bh) {
+                const double* src = X.data() + (static_cast<long>(c) * H + h * b + bh) * W;
+
+                // Destination row of output channel for block (bh, bw)
+                auto row = [&](int bw) {
+                    int c_out = crd ? c * bb + bh * b + bw : (bh * b + bw) * C + c;
+                    return output.data() + c_out * new_plane + static_cast<long>(h) * new_W;
+                };
+
+                if (b == 2) {
+                    double* d0 = row(0);
+                    double* d1 = row(1);
+                    for (int w = 0; w < new_W; ++w) {
+                        d0[w] = src[2 * w];
+                        d1[w] = src[2 * w + 1];
+                    }
+                } else {
+                    for (int bw = 0; bw < b; ++bw) {
+                        double* dst = row(bw);
+                        for (int w = 0; w < new_W; ++w) dst[w] = src[w * b + bw];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * ONNX SpaceToDepth operator (NCHW)
+ *
+ * 空間次元（H, W）をチャネル次元に再配置する。
+ * 出力を確保して spacetodepth_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (C, H, W), row-major)
+ * @param C 入力チャネル数
+ * @param H 入力高さ (blocksize の倍数)
+ * @param W 入力幅 (blocksize の倍数)
+ * @param blocksize ブロックサイズ
+ * @param mode "DCR" (既定) または "CRD"
+ * @return 再配置されたテンソル (flattened (C*blocksize^2, H/blocksize, W/blocksize))
+ */
+inline Eigen::VectorXd spacetodepth(const Eigen::VectorXd& X,
+                                    int C, int H, int W,
+                                    int blocksize,
+                                    const std::string& mode = "DCR") {
+    Eigen::VectorXd output(X.size());
+    spacetodepth_into(output, X, C, H, W, blocksize, mode);
+    return output;
+}
+
+/**
+ * SpaceToDepth (NHWC) を呼び出し側のバッファに書き込む
+ *
+ * 2D implementation for (1, H, W, C) channel-last input. Output channel
+ * (bh * blocksize + bw) * C + c takes input pixel (h * blocksize + bh,
+ * w * blocksize + bw), so every input pixel is copied as one contiguous run.
+ *
+ * @param output 出力 (X と同じ長さ)、呼び出し側で確保。X と重ならないこと
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param H 入力高さ (blocksize の倍数)
+ * @param W 入力幅 (blocksize の倍数)
+ * @param C 入力チャネル数
+ * @param blocksize ブロックサイズ
+ */
+inline void spacetodepth_nhwc_into(Eigen::Ref<Eigen::VectorXd> output,
+                                   const Eigen::VectorXd& X,
+                                   int H, int W, int C,
+                                   int blocksize) {
+    const int new_H = H / blocksize;
+    const int new_W = W / blocksize;
+    const int new_C = C * blocksize * blocksize;
+
+    for (int h = 0; h < new_H; ++h) {
+        for (int w = 0; w < new_W; ++w) {
+            double* dst = output.data() + (static_cast<long>(h) * new_W + w) * new_C;
+            for (int bh = 0; bh < blocksize; ++bh) {
+                const double* src = X.data() +
+                    (static_cast<long>(h * blocksize + bh) * W + w * blocksize) * C;
+                // blocksize adjacent pixels are contiguous in the input row
+                std::copy(src, src + blocksize * C, dst + bh * blocksize * C);
+            }
+        }
+    }
+}
+
+/**
+ * ONNX SpaceToDepth operator (NHWC)
+ *
+ * 空間次元（H, W）をチャネル次元に再配置する。
+ * 出力を確保して spacetodepth_nhwc_into() を呼ぶ。
+ *
+ * @param X 入力テンソル (flattened (H, W, C), row-major)
+ * @param H 入力高さ (blocksize の倍数)
+ * @param W 入力幅 (blocksize の倍数)
+ * @param C 入力チャネル数
+ * @param blocksize ブロックサイズ
+ * @return 再配置されたテンソル (flattened (H/blocksize, W/blocksize, C*blocksize^2))
+ */
+inline Eigen::VectorXd spacetodepth_nhwc(const Eigen::VectorXd& X,
+                                         int H, int W, int C,
+                                         int blocksize) {
+    Eigen::VectorXd output(X.size());
+    spacetodepth_nhwc_into(output, X, H, W, C, blocksize);
+    return output;
+}
+
 } // namespace onnx
 
 #endif // ONNX_09_SPACETODEPTH_HPP
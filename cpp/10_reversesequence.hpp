@@ -2,6 +2,7 @@
 #define ONNX_10_REVERSESEQUENCE_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <vector>
 
 namespace onnx {
@@ -11,6 +12,8 @@ namespace onnx {
  *
  * 各バッチについて、指定された長さまでシーケンスを反転する。
  * Simplified for 2D case (batch_axis and time_axis work on rows/columns)
+ * ONNX requires batch_axis != time_axis; other combinations return the
+ * input unchanged.
  *
  * @param input_tensor 入力テンソル
  * @param sequence_lens 各バッチの反転する長さ
@@ -25,65 +28,131 @@ Eigen::MatrixXd reversesequence(const Eigen::MatrixBase<Derived>& input_tensor,
                                  int time_axis = 0) {
     Eigen::MatrixXd output = input_tensor;
 
-    int batch_size = (batch_axis == 0) ? input_tensor.rows() : input_tensor.cols();
-
-    // Case 1: batch_axis=0 (rows), time_axis=1 (cols)
-    // Reverse elements in each row up to sequence_lens[row_idx]
     if (batch_axis == 0 && time_axis == 1) {
-        for (int row = 0; row < batch_size; ++row) {
-            int seq_len = sequence_lens[row];
-            // Reverse the first seq_len elements in this row
-            for (int col = 0; col < seq_len / 2; ++col) {
-                double temp = output(row, col);
-                output(row, col) = output(row, seq_len - 1 - col);
-                output(row, seq_len - 1 - col) = temp;
-            }
+        // Reverse the first seq_len elements in each row
+        for (int row = 0; row < output.rows(); ++row) {
+            output.row(row).head(sequence_lens[row]).reverseInPlace();
         }
-    }
-    // Case 2: batch_axis=1 (cols), time_axis=0 (rows)
-    // Reverse elements in each column up to sequence_lens[col_idx]
-    else if (batch_axis == 1 && time_axis == 0) {
-        for (int col = 0; col < batch_size; ++col) {
-            int seq_len = sequence_lens[col];
-            // Reverse the first seq_len elements in this column
-            for (int row = 0; row < seq_len / 2; ++row) {
-                double temp = output(row, col);
-                output(row, col) = output(seq_len - 1 - row, col);
-                output(seq_len - 1 - row, col) = temp;
-            }
+    } else if (batch_axis == 1 && time_axis == 0) {
+        // Reverse the first seq_len elements in each column
+        for (int col = 0; col < output.cols(); ++col) {
+            output.col(col).head(sequence_lens[col]).reverseInPlace();
         }
     }
-    // Case 3: batch_axis=0 (rows), time_axis=0 (rows) - same axis
-    // Not typically used, but handle it
-    else if (batch_axis == 0 && time_axis == 0) {
-        // This doesn't make sense in standard usage, treat as column-wise operation
-        for (int col = 0; col < input_tensor.cols(); ++col) {
-            for (int row = 0; row < batch_size && row < sequence_lens.size(); ++row) {
-                int seq_len = sequence_lens[row];
-                if (row < seq_len / 2) {
-                    double temp = output(row, col);
-                    output(row, col) = output(seq_len - 1 - row, col);
-                    output(seq_len - 1 - row, col) = temp;
-                }
-            }
+
+    return output;
+}
+
+/**
+ * ONNX ReverseSequence operator (N-D, in-place)
+ *
+ * data を直接書き換えて、各バッチのシーケンスを先頭から sequence_lens[b] 個だけ反転する。
+ * Layout is (time, batch, ...) or (batch, time, ...). Every (time, batch)
+ * position owns a contiguous slab of prod(shape[2:]) features, so the
+ * reversal swaps whole slabs pairwise. Batches are independent and are
+ * distributed over threads.
+ *
+ * @param data 入力テンソル (flattened, row-major)。結果で上書きされる
+ * @param shape 入力テンソルの形状 (ランク2以上)
+ * @param sequence_lens 各バッチの反転する長さ
+ * @param batch_axis バッチ軸 (0 または 1)
+ * @param time_axis 時間軸 (0 または 1、batch_axis と異なる)
+ */
+inline void reversesequence_inplace(Eigen::Ref<Eigen::VectorXd> data,
+                                    const std::vector<int>& shape,
+                                    const std::vector<int>& sequence_lens,
+                                    int batch_axis = 1,
+                                    int time_axis = 0) {
+    long slab = 1;
+    for (size_t d = 2; d < shape.size(); ++d) slab *= shape[d];
+
+    const int batch = shape[batch_axis];
+    const long time_stride = (time_axis == 0) ? shape[1] * slab : slab;
+    const long batch_stride = (batch_axis == 0) ? shape[1] * slab : slab;
+    double* base = data.data();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int b = 0; b < batch; ++b) {
+        const int len = sequence_lens[b];
+        double* seq = base + b * batch_stride;
+        for (int t = 0; t < len / 2; ++t) {
+            double* a = seq + t * time_stride;
+            std::swap_ranges(a, a + slab, seq + (len - 1 - t) * time_stride);
         }
     }
-    // Case 4: batch_axis=1 (cols), time_axis=1 (cols) - same axis
-    // Not typically used, but handle it
-    else if (batch_axis == 1 && time_axis == 1) {
-        // This doesn't make sense in standard usage, treat as row-wise operation
-        for (int row = 0; row < input_tensor.rows(); ++row) {
-            for (int col = 0; col < batch_size && col < sequence_lens.size(); ++col) {
-                int seq_len = sequence_lens[col];
-                if (col < seq_len / 2) {
-                    double temp = output(row, col);
-                    output(row, col) = output(row, seq_len - 1 - col);
-                    output(row, seq_len - 1 - col) = temp;
-                }
-            }
+}
+
+/**
+ * ReverseSequence (N-D) を呼び出し側のバッファに書き込む
+ *
+ * The output is written in one pass: slab t of batch b is copied from
+ * slab len-1-t for t < len and from slab t otherwise. If output is
+ * input_tensor itself, reversesequence_inplace() is used instead.
+ *
+ * @param output 出力 (input_tensor と同じ長さ)、呼び出し側で確保。input_tensor と同じでもよい (部分的な重なりは不可)
+ * @param input_tensor 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状 (ランク2以上)
+ * @param sequence_lens 各バッチの反転する長さ
+ * @param batch_axis バッチ軸 (0 または 1)
+ * @param time_axis 時間軸 (0 または 1、batch_axis と異なる)
+ */
+inline void reversesequence_into(Eigen::Ref<Eigen::VectorXd> output,
+                                 const Eigen::VectorXd& input_tensor,
+                                 const std::vector<int>& shape,
+                                 const std::vector<int>& sequence_lens,
+                                 int batch_axis = 1,
+                                 int time_axis = 0) {
+    if (output.data() == input_tensor.data()) {
+        reversesequence_inplace(output, shape, sequence_lens, batch_axis, time_axis);
+        return;
+    }
+
+    long slab = 1;
+    for (size_t d = 2; d < shape.size(); ++d) slab *= shape[d];
+
+    const int batch = shape[batch_axis];
+    const int steps = shape[time_axis];
+    const long time_stride = (time_axis == 0) ? shape[1] * slab : slab;
+    const long batch_stride = (batch_axis == 0) ? shape[1] * slab : slab;
+
+    const double* src = input_tensor.data();
+    double* dst = output.data();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int b = 0; b < batch; ++b) {
+        const int len = sequence_lens[b];
+        for (int t = 0; t < steps; ++t) {
+            const int from = (t < len) ? len - 1 - t : t;
+            const double* s = src + b * batch_stride + from * time_stride;
+            std::copy(s, s + slab, dst + b * batch_stride + t * time_stride);
         }
     }
+}
 
+/**
+ * ONNX ReverseSequence operator (N-D)
+ *
+ * 各バッチについて、指定された長さまでシーケンスを反転する。
+ * 出力を確保して reversesequence_into() を呼ぶ。
+ *
+ * @param input_tensor 入力テンソル (flattened, row-major)
+ * @param shape 入力テンソルの形状 (ランク2以上)
+ * @param sequence_lens 各バッチの反転する長さ
+ * @param batch_axis バッチ軸 (0 または 1)
+ * @param time_axis 時間軸 (0 または 1、batch_axis と異なる)
+ * @return 反転されたテンソル (flattened, row-major)
+ */
+inline Eigen::VectorXd reversesequence(const Eigen::VectorXd& input_tensor,
+                                       const std::vector<int>& shape,
+                                       const std::vector<int>& sequence_lens,
+                                       int batch_axis = 1,
+                                       int time_axis = 0) {
+    Eigen::VectorXd output(input_tensor.size());
+    reversesequence_into(output, input_tensor, shape, sequence_lens, batch_axis, time_axis);
     return output;
 }
 
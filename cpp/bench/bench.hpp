@@ -0,0 +1,451 @@
+#ifndef ONNX_BENCH_BENCH_HPP
+#define ONNX_BENCH_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../profile/memory.hpp"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace onnx {
+namespace bench {
+
+/**
+ * ベンチマーク1件の結果
+ *
+ * ns_* は1回の呼び出しあたりの時間。bytes / flops は1回の呼び出しで
+ * 読み書きするバイト数と浮動小数点演算数の見積もり (不明な場合は 0)。
+ * allocs_per_op / heap_peak_bytes は malloc フック (MEMORY=1) がある場合のみ
+ * (ない場合は -1)。
+ */
+struct Result {
+    std::string name;
+    std::string shape;
+    long iterations;
+    int repetitions;
+    double ns_median;
+    double ns_min;
+    double ns_mad;
+    double bytes;
+    double flops;
+    double ns_p99 = 0.0;
+    double peak_bytes = 0.0;
+    double allocs_per_op = -1.0;
+    double heap_peak_bytes = -1.0;
+};
+
+/**
+ * 実行オプション
+ *
+ * --filter SUBSTR   名前に SUBSTR を含むベンチマークだけを実行する
+ * --json FILE       結果を JSON で FILE に書き出す
+ * --min-time-ms N   1回の計測の最短時間 (ミリ秒)
+ * --repetitions N   計測の繰り返し回数
+ * --samples N       レイテンシ計測 (run_latency) の呼び出し回数
+ * --trace FILE      プロファイル結果を Chrome trace 形式で FILE に書き出す (PROFILE=1 でビルド)
+ * --counters        プロファイル時にハードウェアカウンタも読む (Linux perf_event_open)
+ * --quick           短時間の設定 (min-time 1ms, 5 repetitions, 20 samples)
+ */
+struct Options {
+    std::string filter;
+    std::string json_path;
+    std::string trace_path;
+    bool counters = false;
+    double min_time_ms = 5.0;
+    int repetitions = 11;
+    double warmup_ms = 20.0;
+    int samples = 100;
+};
+
+/**
+ * Helper function: コマンドライン引数を解析する
+ */
+inline Options parse_args(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : ""; };
+        if (a == "--filter") {
+            opt.filter = next();
+        } else if (a == "--json") {
+            opt.json_path = next();
+        } else if (a == "--trace") {
+            opt.trace_path = next();
+        } else if (a == "--counters") {
+            opt.counters = true;
+        } else if (a == "--min-time-ms") {
+            opt.min_time_ms = std::atof(next().c_str());
+        } else if (a == "--repetitions") {
+            opt.repetitions = std::max(1, std::atoi(next().c_str()));
+        } else if (a == "--samples") {
+            opt.samples = std::max(1, std::atoi(next().c_str()));
+        } else if (a == "--quick") {
+            opt.min_time_ms = 1.0;
+            opt.repetitions = 5;
+            opt.warmup_ms = 2.0;
+            opt.samples = 20;
+        } else {
+            std::cerr << "unknown option: " << a << std::endl;
+            std::exit(2);
+        }
+    }
+    return opt;
+}
+
+/**
+ * 計算結果が最適化で消されないようにする
+ *
+ * 値のアドレスをコンパイラから見えない形で使ったことにする。
+ */
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * Helper function: 中央値
+ */
+inline double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return (n % 2 == 1) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+/**
+ * Helper function: パーセンタイル (nearest-rank, q は 0-100)
+ */
+inline double percentile(std::vector<double> v, double q) {
+    std::sort(v.begin(), v.end());
+    const double rank = std::ceil(q / 100.0 * v.size());
+    const size_t i = static_cast<size_t>(std::max(1.0, rank)) - 1;
+    return v[std::min(i, v.size() - 1)];
+}
+
+/**
+ * Helper function: /proc/self/status の項目 (kB) をバイト数で返す
+ *
+ * key は "VmRSS:" (現在の常駐メモリ) や "VmHWM:" (常駐メモリのピーク)。
+ * 読めない環境 (Linux 以外) では 0 を返す。
+ */
+inline double proc_status_bytes(const char* key) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    const size_t n = std::strlen(key);
+    while (std::getline(in, line)) {
+        if (line.compare(0, n, key) == 0) return 1024.0 * std::atof(line.c_str() + n);
+    }
+    return 0.0;
+}
+
+/**
+ * Helper function: 常駐メモリのピーク (VmHWM) を現在値にリセットする
+ *
+ * Linux 4.0 以降で /proc/self/clear_refs に "5" を書くとリセットされる。
+ * @return リセットできた場合 true
+ */
+inline bool reset_peak_rss() {
+#if defined(__GLIBC__)
+    // Return freed heap pages first, so that memory left over from earlier
+    // cases is not counted as already resident
+    malloc_trim(0);
+#endif
+    std::ofstream out("/proc/self/clear_refs");
+    if (!out) return false;
+    out << "5";
+    return static_cast<bool>(out.flush());
+}
+
+/**
+ * ベンチマークの実行と結果の収集
+ *
+ * Each case is warmed up, then the iteration count is calibrated so that
+ * one repetition lasts at least min_time_ms. The per-call time of every
+ * repetition is recorded; median and median absolute deviation (MAD) are
+ * reported, which are robust to the occasional preempted repetition.
+ */
+class Suite {
+public:
+    explicit Suite(const Options& options) : options_(options) {}
+
+    /**
+     * ベンチマークを1件実行する
+     *
+     * @param name オペレータ / 実装の名前 (例: "02_transpose/nd")
+     * @param shape 形状の説明 (例: "256x256")
+     * @param bytes 1回あたりのメモリ転送量 (バイト)
+     * @param flops 1回あたりの浮動小数点演算数
+     * @param fn 計測対象
+     */
+    template<typename F>
+    void run(const std::string& name, const std::string& shape,
+             double bytes, double flops, F&& fn) {
+        const std::string full = name + "/" + shape;
+        if (!options_.filter.empty() && full.find(options_.filter) == std::string::npos) return;
+
+        typedef std::chrono::steady_clock Clock;
+        auto elapsed_ns = [](Clock::time_point a, Clock::time_point b) {
+            return std::chrono::duration<double, std::nano>(b - a).count();
+        };
+
+        // Warm-up (at least one call)
+        const Clock::time_point warm_start = Clock::now();
+        do {
+            fn();
+        } while (elapsed_ns(warm_start, Clock::now()) < options_.warmup_ms * 1e6);
+
+        // Calibrate iterations per repetition
+        long iterations = 1;
+        for (;;) {
+            const Clock::time_point t0 = Clock::now();
+            for (long i = 0; i < iterations; ++i) fn();
+            const double ns = elapsed_ns(t0, Clock::now());
+            if (ns >= options_.min_time_ms * 1e6 || iterations >= (1L << 30)) break;
+            const double scale = (ns > 0) ? options_.min_time_ms * 1e6 / ns : 10.0;
+            iterations = std::max(iterations + 1, static_cast<long>(iterations * std::min(10.0, scale * 1.2)));
+        }
+
+        std::vector<double> samples;
+        samples.reserve(options_.repetitions);
+        const long long allocs_start = profile::memory::process_counters().allocations;
+        for (int r = 0; r < options_.repetitions; ++r) {
+            const Clock::time_point t0 = Clock::now();
+            for (long i = 0; i < iterations; ++i) fn();
+            samples.push_back(elapsed_ns(t0, Clock::now()) / iterations);
+        }
+        const long long allocs = profile::memory::process_counters().allocations - allocs_start;
+
+        Result res;
+        res.name = name;
+        res.shape = shape;
+        res.iterations = iterations;
+        res.repetitions = options_.repetitions;
+        res.ns_median = median(samples);
+        res.ns_min = *std::min_element(samples.begin(), samples.end());
+        std::vector<double> dev;
+        for (double s : samples) dev.push_back(std::abs(s - res.ns_median));
+        res.ns_mad = median(dev);
+        res.bytes = bytes;
+        res.flops = flops;
+        if (profile::memory::hooks_installed()) {
+            res.allocs_per_op = static_cast<double>(allocs) / (static_cast<double>(iterations) * options_.repetitions);
+        }
+        results_.push_back(res);
+
+        print(res);
+    }
+
+    /**
+     * レイテンシ分布とピークメモリを計測する (モデル単位のベンチマーク用)
+     *
+     * Unlike run(), every call is timed on its own so that tail latency
+     * is visible: p50 and p99 over options.samples calls are reported.
+     * The resident-set high-water mark is reset before the warm-up, and
+     * peak_bytes is its growth over the resident set at that point, i.e.
+     * the working memory of fn including the first-call allocations.
+     * With the malloc hooks (MEMORY=1), allocations per call and the heap
+     * high-water mark above the starting live size are reported as well.
+     *
+     * @param name モデル / 部分グラフの名前
+     * @param shape 形状の説明
+     * @param bytes 1回あたりのメモリ転送量 (バイト)
+     * @param flops 1回あたりの浮動小数点演算数
+     * @param fn 計測対象
+     */
+    template<typename F>
+    void run_latency(const std::string& name, const std::string& shape,
+                     double bytes, double flops, F&& fn) {
+        const std::string full = name + "/" + shape;
+        if (!options_.filter.empty() && full.find(options_.filter) == std::string::npos) return;
+
+        typedef std::chrono::steady_clock Clock;
+        auto elapsed_ns = [](Clock::time_point a, Clock::time_point b) {
+            return std::chrono::duration<double, std::nano>(b - a).count();
+        };
+
+        const bool peak_reset = reset_peak_rss();
+        const double rss_base = proc_status_bytes("VmRSS:");
+        profile::memory::reset_process_peak();
+        const long long heap_base = profile::memory::process_counters().live;
+
+        const Clock::time_point warm_start = Clock::now();
+        do {
+            fn();
+        } while (elapsed_ns(warm_start, Clock::now()) < options_.warmup_ms * 1e6);
+
+        std::vector<double> samples;
+        samples.reserve(options_.samples);
+        const long long allocs_start = profile::memory::process_counters().allocations;
+        for (int r = 0; r < options_.samples; ++r) {
+            const Clock::time_point t0 = Clock::now();
+            fn();
+            samples.push_back(elapsed_ns(t0, Clock::now()));
+        }
+        const profile::memory::Counters heap = profile::memory::process_counters();
+
+        Result res;
+        res.name = name;
+        res.shape = shape;
+        res.iterations = 1;
+        res.repetitions = options_.samples;
+        res.ns_median = percentile(samples, 50.0);
+        res.ns_p99 = percentile(samples, 99.0);
+        res.ns_min = *std::min_element(samples.begin(), samples.end());
+        std::vector<double> dev;
+        for (double s : samples) dev.push_back(std::abs(s - res.ns_median));
+        res.ns_mad = median(dev);
+        res.bytes = bytes;
+        res.flops = flops;
+        res.peak_bytes = peak_reset ? std::max(0.0, proc_status_bytes("VmHWM:") - rss_base) : 0.0;
+        if (profile::memory::hooks_installed()) {
+            res.allocs_per_op = static_cast<double>(heap.allocations - allocs_start) / options_.samples;
+            res.heap_peak_bytes = static_cast<double>(heap.peak - heap_base);
+        }
+        results_.push_back(res);
+
+        print(res);
+    }
+
+    const std::vector<Result>& results() const { return results_; }
+
+    /**
+     * 結果を JSON で書き出す (--json が指定されている場合)
+     *
+     * {"context": {...}, "benchmarks": [{"name", "shape", "ns_per_op", "ns_min",
+     * "ns_mad", "iterations", "repetitions", "gb_per_s", "gflop_per_s",
+     * "ns_p99", "peak_bytes"[, "allocs_per_op", "heap_peak_bytes"]}, ...]}
+     * ns_p99 / peak_bytes は run_latency() の結果のみ (それ以外は 0)。
+     * allocs_per_op / heap_peak_bytes は malloc フックがある場合のみ出力する。
+     *
+     * @return 書き出しに失敗した場合 false
+     */
+    bool write_json() const {
+        if (options_.json_path.empty()) return true;
+        std::ofstream out(options_.json_path);
+        if (!out) {
+            std::cerr << "cannot write " << options_.json_path << std::endl;
+            return false;
+        }
+        write_json(out);
+        return true;
+    }
+
+    void write_json(std::ostream& out) const {
+        char buf[512];
+        out << "{\n  \"context\": {";
+        out << "\"compiler\": \"" << compiler() << "\", ";
+#ifdef _OPENMP
+        out << "\"openmp\": true, ";
+#else
+        out << "\"openmp\": false, ";
+#endif
+        out << "\"min_time_ms\": " << options_.min_time_ms << ", ";
+        out << "\"repetitions\": " << options_.repetitions << "},\n";
+        out << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            std::snprintf(buf, sizeof(buf),
+                          "    {\"name\": \"%s\", \"shape\": \"%s\", \"ns_per_op\": %.3f, "
+                          "\"ns_min\": %.3f, \"ns_mad\": %.3f, \"iterations\": %ld, \"repetitions\": %d, "
+                          "\"gb_per_s\": %.4f, \"gflop_per_s\": %.4f, "
+                          "\"ns_p99\": %.3f, \"peak_bytes\": %.0f",
+                          r.name.c_str(), r.shape.c_str(), r.ns_median, r.ns_min, r.ns_mad,
+                          r.iterations, r.repetitions,
+                          r.bytes / r.ns_median, r.flops / r.ns_median,
+                          r.ns_p99, r.peak_bytes);
+            out << buf;
+            if (r.allocs_per_op >= 0) {
+                std::snprintf(buf, sizeof(buf), ", \"allocs_per_op\": %.3f", r.allocs_per_op);
+                out << buf;
+            }
+            if (r.heap_peak_bytes >= 0) {
+                std::snprintf(buf, sizeof(buf), ", \"heap_peak_bytes\": %.0f", r.heap_peak_bytes);
+                out << buf;
+            }
+            out << "}" << ((i + 1 < results_.size()) ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    static std::string compiler() {
+#if defined(__clang__)
+        return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        return std::string("gcc ") + __VERSION__;
+#else
+        return "unknown";
+#endif
+    }
+
+    static void print(const Result& r) {
+        char buf[256];
+        if (r.ns_p99 > 0) {
+            std::snprintf(buf, sizeof(buf), "%-36s %-22s p50 %10.3f ms  p99 %10.3f ms  %8.2f GFLOP/s  peak %8.1f MiB",
+                          r.name.c_str(), r.shape.c_str(), r.ns_median * 1e-6, r.ns_p99 * 1e-6,
+                          r.flops / r.ns_median, r.peak_bytes / (1024.0 * 1024.0));
+            std::cout << buf;
+            if (r.allocs_per_op >= 0) {
+                std::snprintf(buf, sizeof(buf), "  allocs %8.1f  heap %8.1f MiB",
+                              r.allocs_per_op, r.heap_peak_bytes / (1024.0 * 1024.0));
+                std::cout << buf;
+            }
+            std::cout << std::endl;
+            return;
+        }
+        std::snprintf(buf, sizeof(buf), "%-36s %-22s %14.1f ns  (+-%5.1f%%)  %8.2f GB/s  %8.2f GFLOP/s",
+                      r.name.c_str(), r.shape.c_str(), r.ns_median,
+                      r.ns_median > 0 ? 100.0 * r.ns_mad / r.ns_median : 0.0,
+                      r.bytes / r.ns_median, r.flops / r.ns_median);
+        std::cout << buf;
+        if (r.allocs_per_op >= 0) {
+            std::snprintf(buf, sizeof(buf), "  %6.1f allocs", r.allocs_per_op);
+            std::cout << buf;
+        }
+        std::cout << std::endl;
+    }
+
+    Options options_;
+    std::vector<Result> results_;
+};
+
+/**
+ * Helper function: 形状の説明文字列 (例: {256, 256} -> "256x256")
+ */
+inline std::string shape_str(const std::vector<int>& shape) {
+    std::string s;
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if (i > 0) s += "x";
+        s += std::to_string(shape[i]);
+    }
+    return s;
+}
+
+/**
+ * 要素ごとの演算で使う形状の組
+ *
+ * small / medium / large と、SIMD 幅で割り切れない unaligned の形状。
+ */
+inline std::vector<std::vector<int>> matrix_sweep() {
+    return {{32, 32}, {256, 256}, {1024, 1024}, {255, 257}};
+}
+
+} // namespace bench
+} // namespace onnx
+
+#endif // ONNX_BENCH_BENCH_HPP
@@ -0,0 +1,47 @@
+#include "bench.hpp"
+#include "../01_add.hpp"
+#include "../01_clip.hpp"
+#include "../01_div.hpp"
+#include "../01_exp.hpp"
+#include "../01_log.hpp"
+#include "../01_mul.hpp"
+#include "../01_neg.hpp"
+#include "../01_pow.hpp"
+#include "../01_sqrt.hpp"
+#include "../01_sub.hpp"
+
+/**
+ * 数学演算 (01) のベンチマーク
+ *
+ * 二項演算は同じ形状の2入力、単項演算は1入力。
+ * bytes は入力と出力の読み書き、flops は1要素あたり1演算として数える。
+ */
+void bench_01_math(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    for (const auto& s : bench::matrix_sweep()) {
+        const int rows = s[0], cols = s[1];
+        const double n = static_cast<double>(rows) * cols;
+        const std::string label = shape_str(s);
+
+        Eigen::MatrixXd A = Eigen::MatrixXd::Random(rows, cols).array() + 2.0;
+        Eigen::MatrixXd B = Eigen::MatrixXd::Random(rows, cols).array() + 2.0;
+        Eigen::MatrixXd Y;
+
+        suite.run("01_add", label, 24 * n, n, [&] { Y = onnx::add(A, B); bench::do_not_optimize(Y); });
+        suite.run("01_sub", label, 24 * n, n, [&] { Y = onnx::sub(A, B); bench::do_not_optimize(Y); });
+        suite.run("01_mul", label, 24 * n, n, [&] { Y = onnx::mul(A, B); bench::do_not_optimize(Y); });
+        suite.run("01_div", label, 24 * n, n, [&] { Y = onnx::div(A, B); bench::do_not_optimize(Y); });
+        suite.run("01_pow", label, 24 * n, n, [&] { Y = onnx::pow(A, B); bench::do_not_optimize(Y); });
+        suite.run("01_neg", label, 16 * n, n, [&] { Y = onnx::neg(A); bench::do_not_optimize(Y); });
+        suite.run("01_exp", label, 16 * n, n, [&] { Y = onnx::exp(A); bench::do_not_optimize(Y); });
+        suite.run("01_log", label, 16 * n, n, [&] { Y = onnx::log(A); bench::do_not_optimize(Y); });
+        suite.run("01_sqrt", label, 16 * n, n, [&] { Y = onnx::sqrt(A); bench::do_not_optimize(Y); });
+        suite.run("01_clip", label, 16 * n, 2 * n, [&] { Y = onnx::clip(A, 1.5, 2.5); bench::do_not_optimize(Y); });
+
+        // Broadcast a row vector
+        Eigen::MatrixXd b_row = B.row(0);
+        suite.run("01_add/broadcast_row", label, 16 * n, n, [&] { Y = onnx::add(A, b_row); bench::do_not_optimize(Y); });
+    }
+}
@@ -0,0 +1,120 @@
+#include "bench.hpp"
+#include "../02_concat.hpp"
+#include "../02_flatten.hpp"
+#include "../02_gather.hpp"
+#include "../02_gatherelements.hpp"
+#include "../02_gathernd.hpp"
+#include "../02_reshape.hpp"
+#include "../02_resize.hpp"
+#include "../02_scatterelements.hpp"
+#include "../02_scatternd.hpp"
+#include "../02_slice.hpp"
+#include "../02_split.hpp"
+#include "../02_squeeze.hpp"
+#include "../02_transpose.hpp"
+#include "../02_unsqueeze.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * テンソル操作 (02) のベンチマーク
+ *
+ * 形状変換は N-D (flattened, row-major) の API を計測する。
+ * ビューを返す演算は呼び出しのオーバーヘッドだけを測ることになる。
+ */
+void bench_02_tensor(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    const std::vector<std::vector<int>> sweep = {{8, 16, 16}, {32, 64, 64}, {64, 128, 128}, {31, 63, 65}};
+
+    for (const auto& s : sweep) {
+        const std::string label = shape_str(s);
+        const long n = static_cast<long>(s[0]) * s[1] * s[2];
+        Eigen::VectorXd x = Eigen::VectorXd::Random(n);
+        Eigen::VectorXd y, storage;
+        std::vector<int> out_shape;
+
+        // Layout changes
+        suite.run("02_transpose/nd_021", label, 16.0 * n, 0, [&] {
+            y = transpose(x, s, {0, 2, 1}); bench::do_not_optimize(y); });
+        suite.run("02_transpose/nd_210", label, 16.0 * n, 0, [&] {
+            y = transpose(x, s, {2, 1, 0}); bench::do_not_optimize(y); });
+        Eigen::MatrixXd m = Eigen::Map<const Eigen::MatrixXd>(x.data(), s[0] * s[1], s[2]);
+        suite.run("02_reshape/2d_copy", label, 16.0 * n, 0, [&] {
+            Eigen::MatrixXd r = reshape(m, s[2], s[0] * s[1]); bench::do_not_optimize(r); });
+        suite.run("02_reshape/view", label, 0, 0, [&] {
+            auto v = reshape_view(x, s, {0, -1}, out_shape, storage); bench::do_not_optimize(v); });
+        suite.run("02_flatten/view", label, 0, 0, [&] {
+            auto v = flatten_view(x, s, 1, out_shape); bench::do_not_optimize(v); });
+        suite.run("02_squeeze/view", label, 0, 0, [&] {
+            auto v = squeeze_view(x, s, nullptr, out_shape); bench::do_not_optimize(v); });
+        suite.run("02_unsqueeze/view", label, 0, 0, [&] {
+            auto v = unsqueeze_view(x, s, {0}, out_shape); bench::do_not_optimize(v); });
+
+        // Slicing and joining
+        std::vector<int> last_axis = {-1};
+        suite.run("02_slice/inner_half", label, 8.0 * n, 0, [&] {
+            y = slice(x, s, {0}, {s[2] / 2}, &last_axis); bench::do_not_optimize(y); });
+        std::vector<long> step2 = {2};
+        suite.run("02_slice/inner_step2", label, 8.0 * n, 0, [&] {
+            y = slice(x, s, {0}, {s[2]}, &last_axis, &step2); bench::do_not_optimize(y); });
+        std::vector<std::vector<int>> split_shapes;
+        suite.run("02_split/inner_3", label, 16.0 * n, 0, [&] {
+            auto parts = split(x, s, -1, split_output_sizes(s[2], 3), &split_shapes);
+            bench::do_not_optimize(parts); });
+        std::vector<int> half = s;
+        half[1] = s[1] / 2;
+        Eigen::VectorXd x_half = x.head(static_cast<long>(s[0]) * half[1] * s[2]);
+        suite.run("02_concat/axis1", label, 16.0 * x_half.size() * 2, 0, [&] {
+            y = concat({&x_half, &x_half}, {half, half}, 1); bench::do_not_optimize(y); });
+
+        // Resize (bilinear 2x on the two inner axes)
+        suite.run("02_resize/linear_2x", label, 8.0 * n * 5, 4.0 * 6 * n, [&] {
+            y = resize(x, s, {1.0, 2.0, 2.0}, "linear"); bench::do_not_optimize(y); });
+        suite.run("02_resize/nearest_2x", label, 8.0 * n * 5, 0, [&] {
+            y = resize(x, s, {1.0, 2.0, 2.0}, "nearest"); bench::do_not_optimize(y); });
+    }
+
+    // Index-driven ops: embedding-style tables (rows x dim)
+    const std::vector<std::vector<int>> tables = {{1000, 64}, {100000, 128}, {500000, 32}, {99991, 100}};
+    for (const auto& t : tables) {
+        const std::string label = shape_str(t);
+        const int rows = t[0], dim = t[1];
+        Eigen::VectorXd table = Eigen::VectorXd::Random(static_cast<long>(rows) * dim);
+        const int num = 4096;
+        Eigen::Matrix<int64_t, Eigen::Dynamic, 1> idx(num);
+        for (int i = 0; i < num; ++i) idx(i) = (static_cast<int64_t>(i) * 7919) % rows;
+        Eigen::VectorXd y;
+
+        suite.run("02_gather/axis0", label, 16.0 * num * dim, 0, [&] {
+            y = gather(table, t, idx, {num}, 0); bench::do_not_optimize(y); });
+
+        Eigen::Matrix<int64_t, Eigen::Dynamic, 1> offsets(num / 32);
+        for (int b = 0; b < num / 32; ++b) offsets(b) = b * 32;
+        suite.run("02_gather/embeddingbag_sum", label, 8.0 * num * dim, 1.0 * num * dim, [&] {
+            y = embeddingbag(table, dim, idx, offsets, "sum"); bench::do_not_optimize(y); });
+
+        suite.run("02_gathernd/rows", label, 16.0 * num * dim, 0, [&] {
+            y = gathernd(table, t, idx, {num, 1}); bench::do_not_optimize(y); });
+
+        Eigen::VectorXd updates = Eigen::VectorXd::Random(static_cast<long>(num) * dim);
+        suite.run("02_scatternd/rows_inplace", label, 16.0 * num * dim, 0, [&] {
+            scatternd_inplace(table, t, idx, {num, 1}, updates); bench::do_not_optimize(table); });
+        suite.run("02_scatternd/rows_add_inplace", label, 24.0 * num * dim, 1.0 * num * dim, [&] {
+            scatternd_inplace(table, t, idx, {num, 1}, updates, "add"); bench::do_not_optimize(table); });
+
+        // Element-wise index ops on a (block_rows x dim) block
+        const int block_rows = std::min(num, rows);
+        std::vector<int> block_shape = {block_rows, dim};
+        Eigen::VectorXd block = table.head(static_cast<long>(block_rows) * dim);
+        Eigen::Matrix<int64_t, Eigen::Dynamic, 1> eidx(block.size());
+        for (long i = 0; i < eidx.size(); ++i) eidx(i) = (i * 31) % dim;
+        suite.run("02_gatherelements/axis1", label, 24.0 * block.size(), 0, [&] {
+            y = gatherelements(block, block_shape, eidx, block_shape, 1); bench::do_not_optimize(y); });
+        suite.run("02_scatterelements/axis1_add", label, 32.0 * block.size(), 1.0 * block.size(), [&] {
+            y = scatterelements(block, block_shape, eidx, block_shape, block, 1, "add");
+            bench::do_not_optimize(y); });
+    }
+}
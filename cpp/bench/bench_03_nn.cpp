@@ -0,0 +1,94 @@
+#include "bench.hpp"
+#include "../03_averagepool.hpp"
+#include "../03_conv.hpp"
+#include "../03_convtranspose.hpp"
+#include "../03_globalaveragepool.hpp"
+#include "../03_gru.hpp"
+#include "../03_layernormalization.hpp"
+#include "../03_lstm.hpp"
+#include "../03_maxpool.hpp"
+#include "../03_maxunpool.hpp"
+
+#include <cstdint>
+
+/**
+ * ニューラルネットワーク層 (03) のベンチマーク
+ *
+ * 畳み込みとプーリングは planar (C x H*W) の API、
+ * RNN は (seq_length x input_size) の API を計測する。
+ * flops は積和を2演算として数える。
+ */
+void bench_03_nn(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    // (C, H, W, M): small / medium / large / unaligned feature maps
+    const std::vector<std::vector<int>> maps = {{16, 16, 16, 16}, {64, 56, 56, 64}, {128, 28, 28, 256}, {30, 33, 35, 31}};
+
+    for (const auto& s : maps) {
+        const int C = s[0], H = s[1], W = s[2], M = s[3];
+        const std::string label = shape_str({C, H, W});
+        const double hw = static_cast<double>(H) * W;
+        Eigen::MatrixXd X = Eigen::MatrixXd::Random(C, H * W);
+        Eigen::MatrixXd Y;
+
+        Eigen::MatrixXd W3 = Eigen::MatrixXd::Random(M, C * 9);
+        Eigen::VectorXd B = Eigen::VectorXd::Random(M);
+        suite.run("03_conv/3x3_pad1", label + "->" + std::to_string(M),
+                  8.0 * (C * hw + M * C * 9 + M * hw), 2.0 * M * C * 9 * hw, [&] {
+            Y = conv(X, W3, &B, C, H, W, M, 3, 3, 1, 1, 1, 1, 1, 1); bench::do_not_optimize(Y); });
+
+        Eigen::MatrixXd W1 = Eigen::MatrixXd::Random(M, C);
+        suite.run("03_conv/1x1", label + "->" + std::to_string(M),
+                  8.0 * (C * hw + M * C + M * hw), 2.0 * M * C * hw, [&] {
+            Y = conv(X, W1, &B, C, H, W, M, 1, 1); bench::do_not_optimize(Y); });
+
+        Eigen::MatrixXd WT = Eigen::MatrixXd::Random(C, M * 4);
+        suite.run("03_convtranspose/2x2_s2", label + "->" + std::to_string(M),
+                  8.0 * (C * hw + C * M * 4 + M * hw * 4), 2.0 * C * M * 4 * hw, [&] {
+            Y = convtranspose(X, WT, &B, C, H, W, M, 2, 2, 2, 2); bench::do_not_optimize(Y); });
+
+        suite.run("03_maxpool/3x3_s1_pad1", label, 16.0 * C * hw, 9.0 * C * hw, [&] {
+            Y = maxpool(X, C, H, W, 3, 3, 1, 1, 1, 1, 1, 1); bench::do_not_optimize(Y); });
+        Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic> I;
+        suite.run("03_maxpool/2x2_s2_indices", label, 8.0 * C * hw * 1.5, C * hw, [&] {
+            Y = maxpool(X, C, H, W, 2, 2, 2, 2, 0, 0, 0, 0, false, 1, 1, &I); bench::do_not_optimize(Y); });
+        Eigen::MatrixXd P = maxpool(X, C, H, W, 2, 2, 2, 2, 0, 0, 0, 0, false, 1, 1, &I);
+        suite.run("03_maxunpool/2x2_s2", label, 8.0 * C * hw * 1.5, 0, [&] {
+            Y = maxunpool(P, I, C, H / 2, W / 2, 2, 2, 2, 2, 0, 0, 0, 0, H, W); bench::do_not_optimize(Y); });
+
+        suite.run("03_averagepool/3x3_s1_pad1", label, 16.0 * C * hw, 9.0 * C * hw, [&] {
+            Y = averagepool(X, C, H, W, 3, 3, 1, 1, 1, 1, 1, 1); bench::do_not_optimize(Y); });
+        suite.run("03_globalaveragepool", label, 8.0 * C * hw, C * hw, [&] {
+            Y = globalaveragepool(X, C, H, W); bench::do_not_optimize(Y); });
+    }
+
+    // LayerNormalization over (tokens x hidden)
+    const std::vector<std::vector<int>> ln = {{16, 64}, {128, 768}, {512, 1024}, {127, 769}};
+    for (const auto& s : ln) {
+        const int rows = s[0], cols = s[1];
+        const double n = static_cast<double>(rows) * cols;
+        Eigen::VectorXd X = Eigen::VectorXd::Random(rows * cols);
+        Eigen::VectorXd scale = Eigen::VectorXd::Random(cols);
+        Eigen::VectorXd bias = Eigen::VectorXd::Random(cols);
+        Eigen::VectorXd Y;
+        suite.run("03_layernormalization", shape_str(s), 16.0 * n, 8.0 * n, [&] {
+            Y = layernormalization(X, s, scale, &bias); bench::do_not_optimize(Y); });
+    }
+
+    // Recurrent layers (seq_length, input_size, hidden_size)
+    const std::vector<std::vector<int>> rnn = {{16, 32, 32}, {64, 128, 128}, {128, 256, 512}, {50, 100, 127}};
+    for (const auto& s : rnn) {
+        const int T = s[0], I = s[1], Hd = s[2];
+        Eigen::MatrixXd X = Eigen::MatrixXd::Random(T, I);
+        Eigen::MatrixXd W4 = Eigen::MatrixXd::Random(4 * Hd, I);
+        Eigen::MatrixXd R4 = Eigen::MatrixXd::Random(4 * Hd, Hd);
+        Eigen::MatrixXd W3 = Eigen::MatrixXd::Random(3 * Hd, I);
+        Eigen::MatrixXd R3 = Eigen::MatrixXd::Random(3 * Hd, Hd);
+
+        suite.run("03_lstm", shape_str(s), 8.0 * 4 * Hd * (I + Hd), 2.0 * T * 4 * Hd * (I + Hd), [&] {
+            auto out = lstm(X, W4, R4); bench::do_not_optimize(out); });
+        suite.run("03_gru", shape_str(s), 8.0 * 3 * Hd * (I + Hd), 2.0 * T * 3 * Hd * (I + Hd), [&] {
+            auto out = gru(X, W3, R3); bench::do_not_optimize(out); });
+    }
+}
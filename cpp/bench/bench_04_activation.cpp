@@ -0,0 +1,42 @@
+#include "bench.hpp"
+#include "../04_elu.hpp"
+#include "../04_hardsigmoid.hpp"
+#include "../04_hardswish.hpp"
+#include "../04_leakyrelu.hpp"
+#include "../04_prelu.hpp"
+#include "../04_relu.hpp"
+#include "../04_sigmoid.hpp"
+#include "../04_softmax.hpp"
+#include "../04_swish.hpp"
+#include "../04_tanh.hpp"
+
+/**
+ * 活性化関数 (04) のベンチマーク
+ *
+ * bytes は入力の読み出しと出力の書き込み、flops は1要素あたり1演算として数える。
+ */
+void bench_04_activation(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    for (const auto& s : bench::matrix_sweep()) {
+        const int rows = s[0], cols = s[1];
+        const double n = static_cast<double>(rows) * cols;
+        const std::string label = shape_str(s);
+
+        Eigen::MatrixXd X = Eigen::MatrixXd::Random(rows, cols);
+        Eigen::MatrixXd slope = Eigen::MatrixXd::Constant(1, 1, 0.25);
+        Eigen::MatrixXd Y;
+
+        suite.run("04_relu", label, 16 * n, n, [&] { Y = onnx::relu(X); bench::do_not_optimize(Y); });
+        suite.run("04_leakyrelu", label, 16 * n, n, [&] { Y = onnx::leakyrelu(X); bench::do_not_optimize(Y); });
+        suite.run("04_elu", label, 16 * n, n, [&] { Y = onnx::elu(X); bench::do_not_optimize(Y); });
+        suite.run("04_prelu", label, 16 * n, n, [&] { Y = onnx::prelu(X, slope); bench::do_not_optimize(Y); });
+        suite.run("04_swish", label, 16 * n, n, [&] { Y = onnx::swish(X); bench::do_not_optimize(Y); });
+        suite.run("04_sigmoid", label, 16 * n, n, [&] { Y = onnx::sigmoid(X); bench::do_not_optimize(Y); });
+        suite.run("04_hardsigmoid", label, 16 * n, n, [&] { Y = onnx::hardsigmoid(X); bench::do_not_optimize(Y); });
+        suite.run("04_hardswish", label, 16 * n, n, [&] { Y = onnx::hardswish(X); bench::do_not_optimize(Y); });
+        suite.run("04_tanh", label, 16 * n, n, [&] { Y = onnx::tanh(X); bench::do_not_optimize(Y); });
+        suite.run("04_softmax", label, 16 * n, 3 * n, [&] { Y = onnx::softmax(X, 1); bench::do_not_optimize(Y); });
+    }
+}
@@ -0,0 +1,32 @@
+#include "bench.hpp"
+#include "../05_gemm.hpp"
+#include "../05_matmul.hpp"
+
+/**
+ * 線形代数 (05) のベンチマーク
+ *
+ * (M, K, N) の行列積。flops は 2*M*K*N。
+ */
+void bench_05_linalg(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    const std::vector<std::vector<int>> sweep = {{32, 32, 32}, {256, 256, 256}, {1024, 1024, 1024},
+                                                 {1, 768, 3072}, {255, 257, 253}};
+
+    for (const auto& s : sweep) {
+        const int M = s[0], K = s[1], N = s[2];
+        const std::string label = shape_str(s);
+        const double bytes = 8.0 * (static_cast<double>(M) * K + static_cast<double>(K) * N + static_cast<double>(M) * N);
+        const double flops = 2.0 * M * K * N;
+
+        Eigen::MatrixXd A = Eigen::MatrixXd::Random(M, K);
+        Eigen::MatrixXd B = Eigen::MatrixXd::Random(K, N);
+        Eigen::MatrixXd C = Eigen::MatrixXd::Random(M, N);
+        Eigen::MatrixXd Y;
+
+        suite.run("05_matmul", label, bytes, flops, [&] { Y = onnx::matmul(A, B); bench::do_not_optimize(Y); });
+        suite.run("05_gemm", label, bytes + 8.0 * M * N, flops + 2.0 * M * N, [&] {
+            Y = onnx::gemm(A, B, C, 1.0, 1.0); bench::do_not_optimize(Y); });
+    }
+}
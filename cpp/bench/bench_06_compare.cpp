@@ -0,0 +1,32 @@
+#include "bench.hpp"
+#include "../06_equal.hpp"
+#include "../06_greater.hpp"
+#include "../06_greaterorequal.hpp"
+#include "../06_less.hpp"
+#include "../06_lessorequal.hpp"
+
+/**
+ * 比較演算 (06) のベンチマーク
+ *
+ * 同じ形状の2入力。bytes は2入力の読み出しと出力の書き込み。
+ */
+void bench_06_compare(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    for (const auto& s : bench::matrix_sweep()) {
+        const int rows = s[0], cols = s[1];
+        const double n = static_cast<double>(rows) * cols;
+        const std::string label = shape_str(s);
+
+        Eigen::MatrixXd A = Eigen::MatrixXd::Random(rows, cols);
+        Eigen::MatrixXd B = Eigen::MatrixXd::Random(rows, cols);
+        Eigen::MatrixXd Y;
+
+        suite.run("06_equal", label, 24 * n, n, [&] { Y = onnx::equal(A, B); bench::do_not_optimize(Y); });
+        suite.run("06_greater", label, 24 * n, n, [&] { Y = onnx::greater(A, B); bench::do_not_optimize(Y); });
+        suite.run("06_greaterorequal", label, 24 * n, n, [&] { Y = onnx::greaterorequal(A, B); bench::do_not_optimize(Y); });
+        suite.run("06_less", label, 24 * n, n, [&] { Y = onnx::less(A, B); bench::do_not_optimize(Y); });
+        suite.run("06_lessorequal", label, 24 * n, n, [&] { Y = onnx::lessorequal(A, B); bench::do_not_optimize(Y); });
+    }
+}
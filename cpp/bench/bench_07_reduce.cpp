@@ -0,0 +1,45 @@
+#include "bench.hpp"
+#include "../07_reducel1.hpp"
+#include "../07_reducel2.hpp"
+#include "../07_reducelogsum.hpp"
+#include "../07_reducelogsumexp.hpp"
+#include "../07_reducemax.hpp"
+#include "../07_reducemean.hpp"
+#include "../07_reducemin.hpp"
+#include "../07_reduceprod.hpp"
+#include "../07_reducesum.hpp"
+#include "../07_reducesumsquare.hpp"
+
+/**
+ * 集約演算 (07) のベンチマーク
+ *
+ * 各形状について軸0 (列方向) と軸1 (行方向) の集約を計測する。
+ */
+void bench_07_reduce(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    for (const auto& s : bench::matrix_sweep()) {
+        const int rows = s[0], cols = s[1];
+        const double n = static_cast<double>(rows) * cols;
+
+        Eigen::MatrixXd X = Eigen::MatrixXd::Random(rows, cols).array() + 2.0;
+        Eigen::MatrixXd Y;
+
+        for (int axis = 0; axis < 2; ++axis) {
+            const std::string label = shape_str(s) + "/axis" + std::to_string(axis);
+            suite.run("07_reducesum", label, 8 * n, n, [&] { Y = onnx::reducesum(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reducemean", label, 8 * n, n, [&] { Y = onnx::reducemean(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reducemax", label, 8 * n, n, [&] { Y = onnx::reducemax(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reducemin", label, 8 * n, n, [&] { Y = onnx::reducemin(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reduceprod", label, 8 * n, n, [&] { Y = onnx::reduceprod(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reducel1", label, 8 * n, 2 * n, [&] { Y = onnx::reducel1(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reducel2", label, 8 * n, 2 * n, [&] { Y = onnx::reducel2(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reducesumsquare", label, 8 * n, 2 * n, [&] {
+                Y = onnx::reducesumsquare(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reducelogsum", label, 8 * n, n, [&] { Y = onnx::reducelogsum(X, axis); bench::do_not_optimize(Y); });
+            suite.run("07_reducelogsumexp", label, 8 * n, 3 * n, [&] {
+                Y = onnx::reducelogsumexp(X, axis); bench::do_not_optimize(Y); });
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#include "bench.hpp"
+#include "../08_pad.hpp"
+
+/**
+ * ユーティリティ (08) のベンチマーク
+ *
+ * (C, H, W) テンソルの空間軸に 2 ずつパディングする。
+ */
+void bench_08_utility(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    const std::vector<std::vector<int>> sweep = {{8, 16, 16}, {64, 56, 56}, {128, 112, 112}, {31, 63, 65}};
+    const std::vector<int> pads = {0, 2, 2, 0, 2, 2};
+
+    for (const auto& s : sweep) {
+        const std::string label = shape_str(s);
+        const double n = static_cast<double>(s[0]) * s[1] * s[2];
+        const double out_n = static_cast<double>(s[0]) * (s[1] + 4) * (s[2] + 4);
+        Eigen::VectorXd x = Eigen::VectorXd::Random(static_cast<long>(n));
+        Eigen::VectorXd y;
+
+        for (const char* mode : {"constant", "reflect", "edge", "wrap"}) {
+            suite.run(std::string("08_pad/") + mode, label, 8.0 * (n + out_n), 0, [&] {
+                y = pad(x, s, pads, mode); bench::do_not_optimize(y); });
+        }
+    }
+}
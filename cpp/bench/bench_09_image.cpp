@@ -0,0 +1,31 @@
+#include "bench.hpp"
+#include "../09_depthtospace.hpp"
+#include "../09_spacetodepth.hpp"
+
+/**
+ * 画像処理 (09) のベンチマーク
+ *
+ * NCHW (flattened) の DepthToSpace / SpaceToDepth。bytes は入力と出力の読み書き。
+ */
+void bench_09_image(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    // (C, H, W, blocksize) for DepthToSpace input
+    const std::vector<std::vector<int>> sweep = {{16, 16, 16, 2}, {64, 56, 56, 2}, {256, 64, 64, 4}, {36, 31, 33, 3}};
+
+    for (const auto& s : sweep) {
+        const int C = s[0], H = s[1], W = s[2], b = s[3];
+        const std::string label = shape_str({C, H, W}) + "/b" + std::to_string(b);
+        const double n = static_cast<double>(C) * H * W;
+        Eigen::VectorXd x = Eigen::VectorXd::Random(static_cast<long>(n));
+        Eigen::VectorXd y;
+
+        suite.run("09_depthtospace/DCR", label, 16 * n, 0, [&] {
+            y = depthtospace(x, C, H, W, b, "DCR"); bench::do_not_optimize(y); });
+        suite.run("09_depthtospace/CRD", label, 16 * n, 0, [&] {
+            y = depthtospace(x, C, H, W, b, "CRD"); bench::do_not_optimize(y); });
+        suite.run("09_spacetodepth/DCR", label, 16 * n, 0, [&] {
+            y = spacetodepth(x, C / (b * b), H * b, W * b, b, "DCR"); bench::do_not_optimize(y); });
+    }
+}
@@ -0,0 +1,28 @@
+#include "bench.hpp"
+#include "../10_reversesequence.hpp"
+
+/**
+ * 制御フロー (10) のベンチマーク
+ *
+ * (time, batch, feature) レイアウトの ReverseSequence。バッチの半分は全長を反転する。
+ */
+void bench_10_control(onnx::bench::Suite& suite) {
+    using namespace onnx;
+    using bench::shape_str;
+
+    const std::vector<std::vector<int>> sweep = {{16, 4, 32}, {64, 32, 256}, {256, 64, 512}, {63, 17, 129}};
+
+    for (const auto& s : sweep) {
+        const std::string label = shape_str(s);
+        const double n = static_cast<double>(s[0]) * s[1] * s[2];
+        Eigen::VectorXd x = Eigen::VectorXd::Random(static_cast<long>(n));
+        std::vector<int> lens(s[1]);
+        for (int b = 0; b < s[1]; ++b) lens[b] = (b % 2 == 0) ? s[0] : s[0] / 2 + 1;
+        Eigen::VectorXd y;
+
+        suite.run("10_reversesequence", label, 16 * n, 0, [&] {
+            y = reversesequence(x, s, lens, 1, 0); bench::do_not_optimize(y); });
+        suite.run("10_reversesequence/inplace", label, 16 * n, 0, [&] {
+            reversesequence_inplace(x, s, lens, 1, 0); bench::do_not_optimize(x); });
+    }
+}
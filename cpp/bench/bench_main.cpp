@@ -0,0 +1,36 @@
+// malloc フック (MEMORY=1) はこの翻訳単位で定義する
+#define ONNX_MEMORY_HOOKS_IMPLEMENTATION
+#include "bench.hpp"
+
+void bench_01_math(onnx::bench::Suite& suite);
+void bench_02_tensor(onnx::bench::Suite& suite);
+void bench_03_nn(onnx::bench::Suite& suite);
+void bench_04_activation(onnx::bench::Suite& suite);
+void bench_05_linalg(onnx::bench::Suite& suite);
+void bench_06_compare(onnx::bench::Suite& suite);
+void bench_07_reduce(onnx::bench::Suite& suite);
+void bench_08_utility(onnx::bench::Suite& suite);
+void bench_09_image(onnx::bench::Suite& suite);
+void bench_10_control(onnx::bench::Suite& suite);
+
+/**
+ * オペレータごとのマイクロベンチマーク
+ *
+ * 使い方: bench [--filter SUBSTR] [--json FILE] [--min-time-ms N] [--repetitions N] [--quick]
+ */
+int main(int argc, char** argv) {
+    onnx::bench::Suite suite(onnx::bench::parse_args(argc, argv));
+
+    bench_01_math(suite);
+    bench_02_tensor(suite);
+    bench_03_nn(suite);
+    bench_04_activation(suite);
+    bench_05_linalg(suite);
+    bench_06_compare(suite);
+    bench_07_reduce(suite);
+    bench_08_utility(suite);
+    bench_09_image(suite);
+    bench_10_control(suite);
+
+    return suite.write_json() ? 0 : 1;
+}
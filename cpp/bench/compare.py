@@ -0,0 +1,154 @@
+"""
+ベンチマーク結果の比較 (性能回帰ゲート)
+
+bench / bench_models が出力した JSON を基準の JSON と比較し、
+ケースごと・オペレータごとの速度比を表示する。標準ライブラリのみを使う。
+
+A case is a significant change only when the shift of the median exceeds
+both a relative threshold and a noise band derived from the median
+absolute deviations (MAD) of the two runs:
+
+    |cur - base| > max(threshold * base, k * 1.4826 * sqrt(mad_base^2 + mad_cur^2))
+
+1.4826 * MAD estimates the standard deviation for normally distributed
+timings, so k = 3 keeps false alarms rare. MAD only captures noise within
+one run; drift between runs (frequency scaling, other load) is covered by
+the relative threshold, 10% by default. Timings are only comparable on the
+machine that recorded the baseline: refresh it with `make bench-baseline`.
+
+使い方:
+    python3 bench/compare.py BASELINE.json CURRENT.json [--threshold 0.10] [--k 3]
+
+終了コード: 有意な性能低下があれば 1、なければ 0。
+"""
+
+import argparse
+import json
+import math
+import sys
+
+
+def load(path):
+    """
+    JSON を読み込み、(name, shape) をキーとする辞書を返す
+
+    Args:
+        path: bench が出力した JSON ファイル
+
+    Returns:
+        {(name, shape): benchmark エントリ}
+    """
+    with open(path) as f:
+        data = json.load(f)
+    return {(b["name"], b["shape"]): b for b in data["benchmarks"]}
+
+
+def classify(base, cur, threshold, k):
+    """
+    1ケースの変化を判定する
+
+    Args:
+        base: 基準のエントリ
+        cur: 今回のエントリ
+        threshold: 相対しきい値 (0.10 = 10%)
+        k: ノイズ帯の幅 (MAD 由来の標準偏差の何倍か)
+
+    Returns:
+        (speedup, status): speedup = base / cur (1 より大きければ高速化)、
+        status は "slower", "faster", "~" のいずれか
+    """
+    b = base["ns_per_op"]
+    c = cur["ns_per_op"]
+    noise = k * 1.4826 * math.hypot(base.get("ns_mad", 0.0), cur.get("ns_mad", 0.0))
+    band = max(threshold * b, noise)
+    speedup = b / c if c > 0 else float("inf")
+    if c - b > band:
+        return speedup, "slower"
+    if b - c > band:
+        return speedup, "faster"
+    return speedup, "~"
+
+
+def geomean(values):
+    """
+    幾何平均
+
+    Args:
+        values: 正の値のリスト
+
+    Returns:
+        幾何平均 (空の場合 1.0)
+    """
+    if not values:
+        return 1.0
+    return math.exp(sum(math.log(v) for v in values) / len(values))
+
+
+def compare(baseline, current, threshold=0.10, k=3.0, show_all=False, out=sys.stdout):
+    """
+    基準と今回の結果を比較して表を出力する
+
+    Args:
+        baseline: load() の結果 (基準)
+        current: load() の結果 (今回)
+        threshold: 相対しきい値
+        k: ノイズ帯の幅
+        show_all: 変化のないケースも表示するか
+        out: 出力先
+
+    Returns:
+        有意に遅くなったケースの数
+    """
+    rows = []
+    per_op = {}
+    for key in sorted(set(baseline) & set(current)):
+        speedup, status = classify(baseline[key], current[key], threshold, k)
+        rows.append((key, baseline[key]["ns_per_op"], current[key]["ns_per_op"], speedup, status))
+        op = key[0].split("/")[0]
+        per_op.setdefault(op, []).append((speedup, status))
+
+    print("%-44s %-22s %14s %14s %9s  %s" % ("name", "shape", "base ns", "current ns", "speedup", ""), file=out)
+    for (name, shape), b, c, speedup, status in rows:
+        if show_all or status != "~":
+            print("%-44s %-22s %14.1f %14.1f %8.3fx  %s" % (name, shape, b, c, speedup, status), file=out)
+
+    print("", file=out)
+    print("%-28s %6s %9s %7s %7s" % ("operator", "cases", "geomean", "slower", "faster"), file=out)
+    for op in sorted(per_op):
+        cases = per_op[op]
+        print("%-28s %6d %8.3fx %7d %7d" % (
+            op, len(cases), geomean([s for s, _ in cases]),
+            sum(1 for _, st in cases if st == "slower"),
+            sum(1 for _, st in cases if st == "faster")), file=out)
+
+    missing = sorted(set(baseline) - set(current))
+    added = sorted(set(current) - set(baseline))
+    if missing:
+        print("\nnot in current: " + ", ".join("%s/%s" % key for key in missing), file=out)
+    if added:
+        print("\nnot in baseline: " + ", ".join("%s/%s" % key for key in added), file=out)
+
+    slower = sum(1 for row in rows if row[4] == "slower")
+    faster = sum(1 for row in rows if row[4] == "faster")
+    print("\n%d cases compared: %d slower, %d faster (threshold %.1f%%, k=%.1f)" % (
+        len(rows), slower, faster, threshold * 100, k), file=out)
+    return slower
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Compare benchmark JSON against a baseline")
+    parser.add_argument("baseline", help="baseline JSON (e.g. bench/baseline.json)")
+    parser.add_argument("current", help="JSON written by bench --json")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="minimum relative change to report (default: 0.10)")
+    parser.add_argument("--k", type=float, default=3.0,
+                        help="noise band in MAD-derived standard deviations (default: 3)")
+    parser.add_argument("--all", action="store_true", help="also list unchanged cases")
+    args = parser.parse_args(argv)
+
+    slower = compare(load(args.baseline), load(args.current), args.threshold, args.k, args.all)
+    return 1 if slower > 0 else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
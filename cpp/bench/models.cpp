@@ -0,0 +1,276 @@
+// malloc フック (MEMORY=1) はこの翻訳単位で定義する
+#define ONNX_MEMORY_HOOKS_IMPLEMENTATION
+#include "bench.hpp"
+#include "../01_add.hpp"
+#include "../01_clip.hpp"
+#include "../03_conv.hpp"
+#include "../03_layernormalization.hpp"
+#include "../03_lstm.hpp"
+#include "../04_relu.hpp"
+#include "../04_softmax.hpp"
+#include "../04_tanh.hpp"
+#include "../05_gemm.hpp"
+#include "../05_matmul.hpp"
+#include "../profile/profile.hpp"
+#include "../runtime/arena.hpp"
+
+#include <cmath>
+
+/**
+ * モデル単位のベンチマーク
+ *
+ * 既存のオペレータを組み合わせて代表的な部分グラフを構成し、
+ * 実運用に近い形状でレイテンシ (p50 / p99) とピークメモリを計測する。
+ * Weights are created once outside the timed region; only the forward
+ * pass of one sample (batch 1) is measured.
+ *
+ * Each operator call is a profiled node, so building with PROFILE=1 and
+ * passing --trace and/or --counters runs one extra forward pass per model
+ * with the profiler enabled and prints the per-op summary; --trace also
+ * writes a Chrome trace, --counters adds hardware counters (IPC, MPKI).
+ *
+ * 使い方: bench_models [--filter SUBSTR] [--json FILE] [--samples N] [--trace FILE] [--counters] [--quick]
+ */
+
+namespace {
+
+using onnx::bench::Suite;
+using onnx::bench::shape_str;
+using onnx::profile::node;
+
+bool profile_enabled = false;
+
+/**
+ * Helper function: レイテンシを計測し、プロファイル有効時はプロファイラ付きで1回実行する
+ *
+ * Each forward pass is one inference, so the thread's scratch arena is
+ * reset after it, as a runtime would between requests.
+ */
+template<typename F>
+void measure(Suite& suite, const std::string& name, const std::string& shape,
+             double bytes, double flops, F&& forward) {
+    auto inference = [&] {
+        forward();
+        onnx::runtime::Arena::thread_instance().reset();
+    };
+
+    const size_t before = suite.results().size();
+    suite.run_latency(name, shape, bytes, flops, inference);
+    if (!profile_enabled || suite.results().size() == before) return;
+
+    onnx::profile::Profiler& profiler = onnx::profile::Profiler::instance();
+    profiler.enable();
+    inference();
+    profiler.enable(false);
+}
+
+/**
+ * ResNet basic block (NHWC)
+ *
+ * relu(x + conv3x3(relu(conv3x3(x)))), BatchNorm はバイアスに畳み込み済みとする。
+ */
+void bench_resnet_block(Suite& suite) {
+    const int H = 56, W = 56, C = 64;
+    const long n = static_cast<long>(H) * W * C;
+
+    Eigen::VectorXd x = Eigen::VectorXd::Random(n);
+    Eigen::MatrixXd w1 = Eigen::MatrixXd::Random(C, C * 9) * 0.05;
+    Eigen::MatrixXd w2 = Eigen::MatrixXd::Random(C, C * 9) * 0.05;
+    Eigen::VectorXd b1 = Eigen::VectorXd::Random(C);
+    Eigen::VectorXd b2 = Eigen::VectorXd::Random(C);
+
+    const double flops = 2.0 * (2.0 * n * C * 9);
+    const double bytes = 8.0 * (4.0 * n + 2.0 * C * C * 9);
+    Eigen::VectorXd y;
+
+    const double conv_flops = 2.0 * n * C * 9;
+    const double conv_bytes = 8.0 * (2.0 * n + C * C * 9);
+
+    measure(suite, "model/resnet_basic_block", shape_str({H, W, C}), bytes, flops, [&] {
+        Eigen::VectorXd h = node("Conv", "conv1", conv_bytes, conv_flops, [&] {
+            return onnx::conv_nhwc(x, w1, &b1, C, H, W, C, 3, 3, 1, 1, 1, 1, 1, 1); });
+        h = node("Relu", "relu1", 16.0 * n, n, [&]() -> Eigen::VectorXd { return onnx::relu(h); });
+        h = node("Conv", "conv2", conv_bytes, conv_flops, [&] {
+            return onnx::conv_nhwc(h, w2, &b2, C, H, W, C, 3, 3, 1, 1, 1, 1, 1, 1); });
+        h = node("Add", "residual", 24.0 * n, n, [&] { return onnx::add(h, x); });
+        y = node("Relu", "relu2", 16.0 * n, n, [&]() -> Eigen::VectorXd { return onnx::relu(h); });
+        onnx::bench::do_not_optimize(y);
+    });
+}
+
+/**
+ * MobileNetV2 inverted residual block (NHWC, stride 1)
+ *
+ * 1x1 expand + ReLU6, 3x3 depthwise + ReLU6, 1x1 project, 残差加算。
+ */
+void bench_mobilenet_block(Suite& suite) {
+    const int H = 56, W = 56, C = 24, E = 144;
+    const long hw = static_cast<long>(H) * W;
+
+    Eigen::VectorXd x = Eigen::VectorXd::Random(hw * C);
+    Eigen::MatrixXd w_expand = Eigen::MatrixXd::Random(E, C) * 0.1;
+    Eigen::MatrixXd w_dw = Eigen::MatrixXd::Random(E, 9) * 0.1;
+    Eigen::MatrixXd w_project = Eigen::MatrixXd::Random(C, E) * 0.1;
+    Eigen::VectorXd b_expand = Eigen::VectorXd::Random(E);
+    Eigen::VectorXd b_dw = Eigen::VectorXd::Random(E);
+    Eigen::VectorXd b_project = Eigen::VectorXd::Random(C);
+
+    const double flops = 2.0 * hw * (C * E + 9.0 * E + E * C);
+    const double bytes = 8.0 * hw * (2.0 * C + 4.0 * E);
+    Eigen::VectorXd y;
+
+    measure(suite, "model/mobilenetv2_block", shape_str({H, W, C}) + "/e" + std::to_string(E), bytes, flops, [&] {
+        Eigen::VectorXd h = node("Conv", "expand", 8.0 * hw * (C + E), 2.0 * hw * C * E, [&] {
+            return onnx::conv_nhwc(x, w_expand, &b_expand, C, H, W, E, 1, 1); });
+        h = node("Clip", "relu6_expand", 16.0 * hw * E, 2.0 * hw * E, [&]() -> Eigen::VectorXd {
+            return onnx::clip(h, 0.0, 6.0); });
+        h = node("Conv", "depthwise", 16.0 * hw * E, 18.0 * hw * E, [&] {
+            return onnx::conv_nhwc(h, w_dw, &b_dw, E, H, W, E, 3, 3, 1, 1, 1, 1, 1, 1, E); });
+        h = node("Clip", "relu6_depthwise", 16.0 * hw * E, 2.0 * hw * E, [&]() -> Eigen::VectorXd {
+            return onnx::clip(h, 0.0, 6.0); });
+        h = node("Conv", "project", 8.0 * hw * (E + C), 2.0 * hw * E * C, [&] {
+            return onnx::conv_nhwc(h, w_project, &b_project, E, H, W, C, 1, 1); });
+        y = node("Add", "residual", 24.0 * hw * C, hw * C, [&] { return onnx::add(h, x); });
+        onnx::bench::do_not_optimize(y);
+    });
+}
+
+/**
+ * Transformer encoder layer (BERT-base, post-LayerNorm)
+ *
+ * 自己注意 (QKV 射影, ヘッドごとの softmax(QK^T / sqrt(d)) V, 出力射影) と
+ * FFN (GELU, tanh 近似) をそれぞれ SkipLayerNormalization で残差接続する。
+ */
+void bench_transformer_layer(Suite& suite) {
+    const int T = 128, D = 768, heads = 12, F = 3072;
+    const int dh = D / heads;
+
+    Eigen::MatrixXd x = Eigen::MatrixXd::Random(T, D);
+    Eigen::MatrixXd w_qkv = Eigen::MatrixXd::Random(D, 3 * D) * 0.03;
+    Eigen::MatrixXd w_out = Eigen::MatrixXd::Random(D, D) * 0.03;
+    Eigen::MatrixXd w_ff1 = Eigen::MatrixXd::Random(D, F) * 0.03;
+    Eigen::MatrixXd w_ff2 = Eigen::MatrixXd::Random(F, D) * 0.03;
+    Eigen::RowVectorXd b_qkv = Eigen::RowVectorXd::Random(3 * D);
+    Eigen::RowVectorXd b_out = Eigen::RowVectorXd::Random(D);
+    Eigen::RowVectorXd b_ff1 = Eigen::RowVectorXd::Random(F);
+    Eigen::RowVectorXd b_ff2 = Eigen::RowVectorXd::Random(D);
+    Eigen::RowVectorXd gamma = Eigen::RowVectorXd::Ones(D);
+    Eigen::RowVectorXd beta = Eigen::RowVectorXd::Zero(D);
+
+    const double flops = 2.0 * T * D * (3.0 * D + D + 2.0 * F) + 4.0 * T * T * D;
+    const double bytes = 8.0 * (4.0 * D * D + 2.0 * D * F + 4.0 * T * D + T * F);
+    const double scale = 1.0 / std::sqrt(static_cast<double>(dh));
+    const double gelu_c = std::sqrt(2.0 / M_PI);
+    Eigen::MatrixXd y;
+
+    const double td = static_cast<double>(T) * D;
+    const double tf = static_cast<double>(T) * F;
+
+    measure(suite, "model/transformer_encoder_layer", shape_str({T, D}) + "/h" + std::to_string(heads), bytes, flops, [&] {
+        Eigen::MatrixXd qkv = node("Gemm", "qkv", 8.0 * (td + 3.0 * D * D + 3.0 * td), 6.0 * td * D, [&] {
+            return onnx::gemm(x, w_qkv); });
+        qkv = node("Add", "qkv_bias", 48.0 * td, 3.0 * td, [&] { return onnx::add(qkv, b_qkv); });
+
+        Eigen::MatrixXd ctx(T, D);
+        for (int h = 0; h < heads; ++h) {
+            Eigen::MatrixXd scores = node("Gemm", "attn_scores", 8.0 * (2.0 * T * dh + T * T), 2.0 * T * T * dh, [&] {
+                return onnx::gemm(qkv.middleCols(h * dh, dh), qkv.middleCols(D + h * dh, dh), scale, false, true); });
+            scores = node("Softmax", "attn_softmax", 16.0 * T * T, 3.0 * T * T, [&] { return onnx::softmax(scores, 1); });
+            ctx.middleCols(h * dh, dh) = node("MatMul", "attn_context", 8.0 * (T * T + 2.0 * T * dh), 2.0 * T * T * dh, [&] {
+                return onnx::matmul(scores, qkv.middleCols(2 * D + h * dh, dh)); });
+        }
+
+        Eigen::MatrixXd attn = node("Gemm", "attn_out", 8.0 * (2.0 * td + D * D), 2.0 * td * D, [&] {
+            return onnx::gemm(ctx, w_out); });
+        attn = node("Add", "attn_out_bias", 16.0 * td, td, [&] { return onnx::add(attn, b_out); });
+        Eigen::MatrixXd x1 = node("SkipLayerNormalization", "attn_norm", 24.0 * td, 8.0 * td, [&] {
+            return onnx::skiplayernormalization(attn, x, gamma, beta); });
+
+        Eigen::MatrixXd ff = node("Gemm", "ffn1", 8.0 * (td + D * F + tf), 2.0 * td * F, [&] {
+            return onnx::gemm(x1, w_ff1); });
+        ff = node("Add", "ffn1_bias", 16.0 * tf, tf, [&] { return onnx::add(ff, b_ff1); });
+        ff = node("Gelu", "ffn_gelu", 16.0 * tf, 8.0 * tf, [&]() -> Eigen::MatrixXd {
+            Eigen::MatrixXd inner = (gelu_c * (ff.array() + 0.044715 * ff.array().cube())).matrix();
+            return (0.5 * ff.array() * (1.0 + onnx::tanh(inner).array())).matrix();
+        });
+        Eigen::MatrixXd out = node("Gemm", "ffn2", 8.0 * (tf + F * D + td), 2.0 * tf * D, [&] {
+            return onnx::gemm(ff, w_ff2); });
+        out = node("Add", "ffn2_bias", 16.0 * td, td, [&] { return onnx::add(out, b_ff2); });
+        y = node("SkipLayerNormalization", "ffn_norm", 24.0 * td, 8.0 * td, [&] {
+            return onnx::skiplayernormalization(out, x1, gamma, beta); });
+        onnx::bench::do_not_optimize(y);
+    });
+}
+
+/**
+ * LSTM encoder (2 layers, batch 1)
+ *
+ * 1層目の出力系列を2層目の入力とする。
+ */
+void bench_lstm_encoder(Suite& suite) {
+    const int T = 100, I = 256, Hd = 512, layers = 2;
+
+    Eigen::MatrixXd x = Eigen::MatrixXd::Random(T, I);
+    std::vector<Eigen::MatrixXd> w, r;
+    std::vector<Eigen::VectorXd> wb, rb;
+    for (int l = 0; l < layers; ++l) {
+        const int in = (l == 0) ? I : Hd;
+        w.push_back(Eigen::MatrixXd::Random(4 * Hd, in) * 0.05);
+        r.push_back(Eigen::MatrixXd::Random(4 * Hd, Hd) * 0.05);
+        wb.push_back(Eigen::VectorXd::Random(4 * Hd));
+        rb.push_back(Eigen::VectorXd::Random(4 * Hd));
+    }
+
+    const double flops = 2.0 * T * 4 * Hd * ((I + Hd) + (Hd + Hd));
+    const double bytes = 8.0 * 4 * Hd * ((I + Hd) + (Hd + Hd));
+    Eigen::MatrixXd y;
+
+    const char* layer_names[] = {"lstm0", "lstm1"};
+
+    measure(suite, "model/lstm_encoder", shape_str({T, I}) + "/h" + std::to_string(Hd) + "x" + std::to_string(layers),
+            bytes, flops, [&] {
+        y = x;
+        for (int l = 0; l < layers; ++l) {
+            const double in = y.cols();
+            y = node("LSTM", layer_names[l], 8.0 * 4 * Hd * (in + Hd), 2.0 * T * 4 * Hd * (in + Hd), [&] {
+                return std::get<0>(onnx::lstm(y, w[l], r[l], &wb[l], &rb[l])); });
+        }
+        onnx::bench::do_not_optimize(y);
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const onnx::bench::Options options = onnx::bench::parse_args(argc, argv);
+    Suite suite(options);
+
+    onnx::profile::Profiler& profiler = onnx::profile::Profiler::instance();
+    profile_enabled = !options.trace_path.empty() || options.counters;
+#ifndef ONNX_PROFILE
+    if (profile_enabled) std::cerr << "--trace/--counters: built without PROFILE=1, no nodes will be recorded" << std::endl;
+#endif
+    if (options.counters) {
+        profiler.enable_counters();
+        const onnx::profile::PerfCounters& counters = onnx::profile::PerfCounters::thread_instance();
+        for (int i = 0; i < onnx::profile::PERF_NUM_COUNTERS; ++i) {
+            if (!counters.available(i)) {
+                std::cerr << "--counters: " << onnx::profile::PerfCounters::name(i)
+                          << " not available (perf_event_open)" << std::endl;
+            }
+        }
+    }
+
+    bench_resnet_block(suite);
+    bench_mobilenet_block(suite);
+    bench_transformer_layer(suite);
+    bench_lstm_encoder(suite);
+
+    bool ok = suite.write_json();
+    if (profile_enabled) {
+        std::cout << std::endl;
+        profiler.print_summary();
+        if (!options.trace_path.empty()) ok = profiler.write_chrome_trace(options.trace_path) && ok;
+    }
+    return ok ? 0 : 1;
+}
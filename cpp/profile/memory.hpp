@@ -0,0 +1,219 @@
+#ifndef ONNX_PROFILE_MEMORY_HPP
+#define ONNX_PROFILE_MEMORY_HPP
+
+#include <atomic>
+
+/**
+ * ヒープ割り当ての追跡
+ *
+ * カーネルは Eigen の行列や std::vector で結果と一時領域を確保するので、
+ * malloc 系の関数そのものをフックして全ての割り当てを数える。
+ * The hooks replace malloc / free / calloc / realloc / memalign /
+ * posix_memalign / aligned_alloc of the executable (glibc, forwarding to
+ * __libc_*), which also covers operator new. They are compiled in only
+ * with -DONNX_MEMORY_HOOKS (make MEMORY=1), and defined in exactly one
+ * translation unit of the program:
+ *
+ *     #define ONNX_MEMORY_HOOKS_IMPLEMENTATION
+ *     #include "profile/memory.hpp"
+ *
+ * Counts are kept per thread (used by profile::Scope for per-node
+ * numbers) and per process (used for per-run numbers). Sizes are the
+ * usable sizes reported by malloc_usable_size, so live bytes return to
+ * the same value once everything is freed.
+ */
+
+namespace onnx {
+namespace profile {
+namespace memory {
+
+/**
+ * 割り当てのカウンタ
+ *
+ * live は現在確保中のバイト数、peak はその最大値。
+ * スレッドごとの live は他スレッドで確保された領域を解放すると負になりうる。
+ */
+struct Counters {
+    long long allocations;
+    long long frees;
+    long long bytes;
+    long long live;
+    long long peak;
+};
+
+inline std::atomic<bool> g_hooks_installed{false};
+inline std::atomic<long long> g_allocations{0};
+inline std::atomic<long long> g_frees{0};
+inline std::atomic<long long> g_bytes{0};
+inline std::atomic<long long> g_live{0};
+inline std::atomic<long long> g_peak{0};
+
+/** フックがリンクされているか (MEMORY=1 かつ glibc) */
+inline bool hooks_installed() {
+    return g_hooks_installed.load(std::memory_order_relaxed);
+}
+
+/** 呼び出しスレッドのカウンタ */
+inline Counters& thread_counters() {
+    thread_local Counters counters;  // zero-initialized, no allocation
+    return counters;
+}
+
+/** プロセス全体のカウンタ */
+inline Counters process_counters() {
+    Counters c;
+    c.allocations = g_allocations.load(std::memory_order_relaxed);
+    c.frees = g_frees.load(std::memory_order_relaxed);
+    c.bytes = g_bytes.load(std::memory_order_relaxed);
+    c.live = g_live.load(std::memory_order_relaxed);
+    c.peak = g_peak.load(std::memory_order_relaxed);
+    return c;
+}
+
+/** プロセス全体の peak を現在の live にリセットする */
+inline void reset_process_peak() {
+    g_peak.store(g_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+/**
+ * Helper function: 割り当て1回を記録する (フックから呼ばれる)
+ */
+inline void on_alloc(long long size) {
+    Counters& t = thread_counters();
+    t.allocations += 1;
+    t.bytes += size;
+    t.live += size;
+    if (t.live > t.peak) t.peak = t.live;
+
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    const long long live = g_live.fetch_add(size, std::memory_order_relaxed) + size;
+    long long peak = g_peak.load(std::memory_order_relaxed);
+    while (live > peak && !g_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Helper function: 解放1回を記録する (フックから呼ばれる)
+ */
+inline void on_free(long long size) {
+    Counters& t = thread_counters();
+    t.frees += 1;
+    t.live -= size;
+
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+    g_live.fetch_sub(size, std::memory_order_relaxed);
+}
+
+/**
+ * スコープ内の割り当て回数・バイト数・ピーク増分を測る (呼び出しスレッド)
+ *
+ * The thread peak is lowered to the current live size while the scope is
+ * open and restored afterwards, so scopes nest.
+ */
+class ScopeCounter {
+public:
+    ScopeCounter() {
+        Counters& t = thread_counters();
+        start_ = t;
+        t.peak = t.live;
+    }
+
+    /** スコープ開始からの割り当て回数 */
+    long long allocations() const { return thread_counters().allocations - start_.allocations; }
+
+    /** スコープ開始からの割り当てバイト数 */
+    long long bytes() const { return thread_counters().bytes - start_.bytes; }
+
+    /** スコープ開始時からの live の最大増分 */
+    long long peak() const { return thread_counters().peak - start_.live; }
+
+    ~ScopeCounter() {
+        Counters& t = thread_counters();
+        if (start_.peak > t.peak) t.peak = start_.peak;
+    }
+
+    ScopeCounter(const ScopeCounter&) = delete;
+    ScopeCounter& operator=(const ScopeCounter&) = delete;
+
+private:
+    Counters start_;
+};
+
+} // namespace memory
+} // namespace profile
+} // namespace onnx
+
+#endif // ONNX_PROFILE_MEMORY_HPP
+
+// malloc フックの定義 (1つの翻訳単位でのみ)
+#if defined(ONNX_MEMORY_HOOKS) && defined(ONNX_MEMORY_HOOKS_IMPLEMENTATION) && !defined(ONNX_PROFILE_MEMORY_HOOKS_DEFINED)
+#define ONNX_PROFILE_MEMORY_HOOKS_DEFINED
+
+#include <cerrno>
+#include <cstddef>
+#include <malloc.h>
+
+#if defined(__GLIBC__)
+
+extern "C" {
+
+void* __libc_malloc(size_t size) noexcept;
+void* __libc_calloc(size_t count, size_t size) noexcept;
+void* __libc_realloc(void* ptr, size_t size) noexcept;
+void* __libc_memalign(size_t alignment, size_t size) noexcept;
+void __libc_free(void* ptr) noexcept;
+
+static void* onnx_memory_track(void* ptr) {
+    if (ptr != nullptr) onnx::profile::memory::on_alloc(static_cast<long long>(malloc_usable_size(ptr)));
+    return ptr;
+}
+
+// glibc declares these with __THROW, i.e. noexcept in C++
+void* malloc(size_t size) noexcept {
+    return onnx_memory_track(__libc_malloc(size));
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    return onnx_memory_track(__libc_calloc(count, size));
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+    const long long old_size = (ptr != nullptr) ? static_cast<long long>(malloc_usable_size(ptr)) : 0;
+    void* result = __libc_realloc(ptr, size);
+    if (result == nullptr && size != 0) return nullptr;  // ptr is still valid
+    if (ptr != nullptr) onnx::profile::memory::on_free(old_size);
+    return onnx_memory_track(result);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+    return onnx_memory_track(__libc_memalign(alignment, size));
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    return onnx_memory_track(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) noexcept {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* ptr = onnx_memory_track(__libc_memalign(alignment, size));
+    if (ptr == nullptr) return ENOMEM;
+    *out = ptr;
+    return 0;
+}
+
+void free(void* ptr) noexcept {
+    if (ptr == nullptr) return;
+    onnx::profile::memory::on_free(static_cast<long long>(malloc_usable_size(ptr)));
+    __libc_free(ptr);
+}
+
+} // extern "C"
+
+namespace {
+[[maybe_unused]] const bool onnx_memory_hooks_registered = (onnx::profile::memory::g_hooks_installed.store(true), true);
+}
+
+#endif // __GLIBC__
+
+#endif // ONNX_MEMORY_HOOKS_IMPLEMENTATION
@@ -0,0 +1,140 @@
+#ifndef ONNX_PROFILE_PERF_COUNTERS_HPP
+#define ONNX_PROFILE_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace onnx {
+namespace profile {
+
+/**
+ * 計測するハードウェアカウンタ
+ */
+enum PerfCounter {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_NUM_COUNTERS
+};
+
+/**
+ * カウンタ値の組 (負の値は利用不可)
+ */
+struct CounterSample {
+    double values[PERF_NUM_COUNTERS];
+};
+
+/**
+ * perf_event_open によるハードウェアカウンタ (Linux)
+ *
+ * 呼び出しスレッドのユーザ空間の cycles, instructions, cache misses
+ * (last-level), branch misses を数える。
+ * Each counter is opened on its own rather than as a group, so that one
+ * event the PMU (or a VM) does not expose does not disable the others;
+ * unavailable counters read as -1. Values are scaled by
+ * time_enabled / time_running when the kernel multiplexes counters.
+ * Counters count the opening thread only: use thread_instance() from the
+ * thread being measured. On other platforms nothing is available.
+ */
+class PerfCounters {
+public:
+    PerfCounters() {
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) fds_[i] = -1;
+#if defined(__linux__)
+        static const uint64_t configs[PERF_NUM_COUNTERS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.exclude_kernel = 1;  // allowed with perf_event_paranoid <= 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+            if (fds_[i] >= 0) close(fds_[i]);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /** 呼び出しスレッド用のインスタンス (初回に開く) */
+    static PerfCounters& thread_instance() {
+        thread_local PerfCounters counters;
+        return counters;
+    }
+
+    bool available(int counter) const { return fds_[counter] >= 0; }
+
+    bool any_available() const {
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+            if (available(i)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * 現在のカウンタ値 (開始時からの累計) を読む
+     */
+    CounterSample read() const {
+        CounterSample sample;
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+            sample.values[i] = -1.0;
+#if defined(__linux__)
+            uint64_t buf[3];
+            if (fds_[i] < 0 || ::read(fds_[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) continue;
+            const double value = static_cast<double>(buf[0]);
+            sample.values[i] = (buf[2] > 0 && buf[2] < buf[1]) ? value * buf[1] / buf[2] : value;
+#endif
+        }
+        return sample;
+    }
+
+    /**
+     * 2回の read() の差 (どちらかが利用不可なら -1)
+     */
+    static CounterSample delta(const CounterSample& start, const CounterSample& end) {
+        CounterSample d;
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+            d.values[i] = (start.values[i] >= 0 && end.values[i] >= 0) ? end.values[i] - start.values[i] : -1.0;
+        }
+        return d;
+    }
+
+    static CounterSample unavailable() {
+        CounterSample s;
+        for (int i = 0; i < PERF_NUM_COUNTERS; ++i) s.values[i] = -1.0;
+        return s;
+    }
+
+    static const char* name(int counter) {
+        static const char* names[PERF_NUM_COUNTERS] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+        return names[counter];
+    }
+
+private:
+    int fds_[PERF_NUM_COUNTERS];
+};
+
+} // namespace profile
+} // namespace onnx
+
+#endif // ONNX_PROFILE_PERF_COUNTERS_HPP
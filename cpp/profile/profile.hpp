@@ -0,0 +1,387 @@
+#ifndef ONNX_PROFILE_PROFILE_HPP
+#define ONNX_PROFILE_PROFILE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "memory.hpp"
+#include "perf_counters.hpp"
+
+/**
+ * オペレータ単位のプロファイリング
+ *
+ * オペレータは自由関数なので、計測は呼び出し側 (グラフのノード) で行う。
+ *
+ *     ONNX_PROFILE_SCOPE("Conv", "layer1/conv1", bytes, flops);
+ *     Y = onnx::conv_nhwc(...);
+ *
+ *     Y = onnx::profile::node("Conv", "layer1/conv1", bytes, flops, [&] { return onnx::conv_nhwc(...); });
+ *
+ * The hooks are compiled in only with -DONNX_PROFILE (make PROFILE=1);
+ * otherwise ONNX_PROFILE_SCOPE expands to nothing and node() just calls
+ * the function, so instrumented code costs nothing. Even when compiled
+ * in, events are recorded only while Profiler::enabled() is true.
+ * With enable_counters(), each node also reads hardware counters
+ * (perf_counters.hpp) at its start and end, and the summary reports IPC
+ * and cache / branch misses per 1000 instructions. When the malloc hooks
+ * of memory.hpp are linked in (MEMORY=1), each node also records its
+ * allocation count, allocated bytes and heap high-water mark.
+ */
+
+namespace onnx {
+namespace profile {
+
+/**
+ * 1回のノード実行の記録
+ *
+ * start_ns / end_ns はプロファイラ生成時からの経過時間。
+ * counters はノード実行中のカウンタ増分 (計測していない場合は -1)。
+ * allocations / alloc_bytes / peak_bytes はノード実行中のヒープ割り当て
+ * (malloc フックがない場合は -1)。
+ */
+struct Event {
+    std::string op_type;
+    std::string name;
+    long long start_ns;
+    long long end_ns;
+    int tid;
+    double bytes;
+    double flops;
+    CounterSample counters;
+    long long allocations;
+    long long alloc_bytes;
+    long long peak_bytes;
+};
+
+/**
+ * オペレータ種別ごとの集計
+ */
+struct OpSummary {
+    std::string op_type;
+    long calls = 0;
+    double total_ns = 0.0;
+    double min_ns = 0.0;
+    double max_ns = 0.0;
+    double bytes = 0.0;
+    double flops = 0.0;
+    CounterSample counters = PerfCounters::unavailable();
+    long long allocations = -1;
+    long long alloc_bytes = -1;
+    long long peak_bytes = -1;
+};
+
+/**
+ * Helper function: 呼び出しスレッドの小さな連番 ID
+ *
+ * Chrome trace のトラック番号として使う。最初に記録したスレッドが 0。
+ */
+inline int thread_index() {
+    static std::atomic<int> next(0);
+    thread_local int index = next++;
+    return index;
+}
+
+/**
+ * イベントの収集と出力 (プロセスで1つ)
+ *
+ * Events from all threads go into one vector under a mutex; recording
+ * happens once per node, so contention is negligible next to the kernels.
+ */
+class Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    void enable(bool on = true) { enabled_.store(on, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /** ノードごとにハードウェアカウンタを読むか */
+    void enable_counters(bool on = true) { counters_.store(on, std::memory_order_relaxed); }
+    bool counters_enabled() const { return counters_.load(std::memory_order_relaxed); }
+
+    /** プロファイラ生成時からの経過時間 (ナノ秒) */
+    long long now_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch_).count();
+    }
+
+    void record(Event event) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back(std::move(event));
+    }
+
+    std::vector<Event> events() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.clear();
+    }
+
+    /**
+     * オペレータ種別ごとに集計する (合計時間の降順)
+     */
+    std::vector<OpSummary> summary() const {
+        std::map<std::string, OpSummary> by_type;
+        for (const Event& e : events()) {
+            const double ns = static_cast<double>(e.end_ns - e.start_ns);
+            OpSummary& s = by_type[e.op_type];
+            if (s.calls == 0) {
+                s.op_type = e.op_type;
+                s.min_ns = ns;
+                s.max_ns = ns;
+                s.counters = e.counters;
+            } else {
+                for (int i = 0; i < PERF_NUM_COUNTERS; ++i) {
+                    const bool valid = s.counters.values[i] >= 0 && e.counters.values[i] >= 0;
+                    s.counters.values[i] = valid ? s.counters.values[i] + e.counters.values[i] : -1.0;
+                }
+            }
+            s.calls += 1;
+            s.total_ns += ns;
+            s.min_ns = std::min(s.min_ns, ns);
+            s.max_ns = std::max(s.max_ns, ns);
+            s.bytes += e.bytes;
+            s.flops += e.flops;
+            if (e.allocations >= 0) {
+                s.allocations = std::max(0LL, s.allocations) + e.allocations;
+                s.alloc_bytes = std::max(0LL, s.alloc_bytes) + e.alloc_bytes;
+                s.peak_bytes = std::max(s.peak_bytes, e.peak_bytes);
+            }
+        }
+        std::vector<OpSummary> result;
+        for (const auto& kv : by_type) result.push_back(kv.second);
+        std::sort(result.begin(), result.end(),
+                  [](const OpSummary& a, const OpSummary& b) { return a.total_ns > b.total_ns; });
+        return result;
+    }
+
+    /**
+     * 集計結果を表形式で出力する
+     */
+    void print_summary(std::ostream& out = std::cout) const {
+        const std::vector<OpSummary> rows = summary();
+        double total = 0.0;
+        for (const OpSummary& s : rows) total += s.total_ns;
+
+        char buf[256];
+        std::snprintf(buf, sizeof(buf), "%-28s %7s %12s %7s %12s %10s %10s",
+                      "op_type", "calls", "total ms", "share", "avg us", "GB/s", "GFLOP/s");
+        out << buf << "\n";
+        for (const OpSummary& s : rows) {
+            std::snprintf(buf, sizeof(buf), "%-28s %7ld %12.3f %6.1f%% %12.1f %10.2f %10.2f",
+                          s.op_type.c_str(), s.calls, s.total_ns * 1e-6,
+                          total > 0 ? 100.0 * s.total_ns / total : 0.0,
+                          s.total_ns * 1e-3 / s.calls,
+                          s.total_ns > 0 ? s.bytes / s.total_ns : 0.0,
+                          s.total_ns > 0 ? s.flops / s.total_ns : 0.0);
+            out << buf << "\n";
+        }
+
+        bool has_memory = false;
+        for (const OpSummary& s : rows) has_memory = has_memory || s.allocations >= 0;
+        if (has_memory) {
+            // Heap allocations (malloc hooks)
+            out << "\n";
+            std::snprintf(buf, sizeof(buf), "%-28s %12s %12s %12s %12s",
+                          "op_type", "allocs", "allocs/call", "KiB/call", "peak KiB");
+            out << buf << "\n";
+            for (const OpSummary& s : rows) {
+                if (s.allocations < 0) continue;
+                std::snprintf(buf, sizeof(buf), "%-28s %12lld %12.1f %12.1f %12.1f",
+                              s.op_type.c_str(), s.allocations,
+                              static_cast<double>(s.allocations) / s.calls,
+                              s.alloc_bytes / 1024.0 / s.calls, s.peak_bytes / 1024.0);
+                out << buf << "\n";
+            }
+        }
+
+        bool has_counters = false;
+        for (const OpSummary& s : rows) {
+            for (int i = 0; i < PERF_NUM_COUNTERS; ++i) has_counters = has_counters || s.counters.values[i] >= 0;
+        }
+        if (!has_counters) return;
+
+        // Hardware counters: IPC and misses per 1000 instructions (MPKI)
+        auto fmt = [](char* dst, size_t size, double v, double scale) {
+            if (v >= 0) std::snprintf(dst, size, "%.2f", v * scale);
+            else std::snprintf(dst, size, "-");
+        };
+        out << "\n";
+        std::snprintf(buf, sizeof(buf), "%-28s %12s %12s %8s %12s %12s",
+                      "op_type", "Mcycles", "Minstr", "IPC", "cache MPKI", "branch MPKI");
+        out << buf << "\n";
+        for (const OpSummary& s : rows) {
+            const double* c = s.counters.values;
+            const bool instr = c[PERF_INSTRUCTIONS] > 0;
+            char cyc[32], ins[32], ipc[32], cmpki[32], bmpki[32];
+            fmt(cyc, sizeof(cyc), c[PERF_CYCLES], 1e-6);
+            fmt(ins, sizeof(ins), c[PERF_INSTRUCTIONS], 1e-6);
+            fmt(ipc, sizeof(ipc), (instr && c[PERF_CYCLES] > 0) ? c[PERF_INSTRUCTIONS] / c[PERF_CYCLES] : -1.0, 1.0);
+            fmt(cmpki, sizeof(cmpki), (instr && c[PERF_CACHE_MISSES] >= 0) ? c[PERF_CACHE_MISSES] / c[PERF_INSTRUCTIONS] : -1.0, 1e3);
+            fmt(bmpki, sizeof(bmpki), (instr && c[PERF_BRANCH_MISSES] >= 0) ? c[PERF_BRANCH_MISSES] / c[PERF_INSTRUCTIONS] : -1.0, 1e3);
+            std::snprintf(buf, sizeof(buf), "%-28s %12s %12s %8s %12s %12s",
+                          s.op_type.c_str(), cyc, ins, ipc, cmpki, bmpki);
+            out << buf << "\n";
+        }
+    }
+
+    /**
+     * Chrome trace-event 形式 (JSON) で出力する
+     *
+     * Complete events ("ph": "X") with microsecond timestamps; open the
+     * file in chrome://tracing or https://ui.perfetto.dev (local, offline).
+     *
+     * @return 書き出しに失敗した場合 false
+     */
+    bool write_chrome_trace(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "cannot write " << path << std::endl;
+            return false;
+        }
+        write_chrome_trace(out);
+        return true;
+    }
+
+    void write_chrome_trace(std::ostream& out) const {
+        const std::vector<Event> evs = events();
+        char buf[256];
+        out << "{\"traceEvents\": [\n";
+        for (size_t i = 0; i < evs.size(); ++i) {
+            const Event& e = evs[i];
+            out << "  {\"name\": \"" << escape(e.name.empty() ? e.op_type : e.name)
+                << "\", \"cat\": \"" << escape(e.op_type) << "\", ";
+            std::snprintf(buf, sizeof(buf),
+                          "\"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d, "
+                          "\"args\": {\"bytes\": %.0f, \"flops\": %.0f",
+                          e.start_ns * 1e-3, (e.end_ns - e.start_ns) * 1e-3, e.tid, e.bytes, e.flops);
+            out << buf;
+            if (e.allocations >= 0) {
+                std::snprintf(buf, sizeof(buf), ", \"allocations\": %lld, \"alloc_bytes\": %lld, \"peak_bytes\": %lld",
+                              e.allocations, e.alloc_bytes, e.peak_bytes);
+                out << buf;
+            }
+            for (int c = 0; c < PERF_NUM_COUNTERS; ++c) {
+                if (e.counters.values[c] < 0) continue;
+                std::snprintf(buf, sizeof(buf), ", \"%s\": %.0f", PerfCounters::name(c), e.counters.values[c]);
+                out << buf;
+            }
+            out << "}}" << ((i + 1 < evs.size()) ? "," : "") << "\n";
+        }
+        out << "], \"displayTimeUnit\": \"ms\"}\n";
+    }
+
+private:
+    Profiler() : enabled_(false), counters_(false), epoch_(Clock::now()) {}
+
+    static std::string escape(const std::string& s) {
+        std::string r;
+        for (char c : s) {
+            if (c == '"' || c == '\\') r += '\\';
+            r += c;
+        }
+        return r;
+    }
+
+    std::atomic<bool> enabled_;
+    std::atomic<bool> counters_;
+    Clock::time_point epoch_;
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+};
+
+/**
+ * スコープの開始から終了までを1イベントとして記録する (RAII)
+ *
+ * @param op_type オペレータ種別 (例: "Conv")。集計のキーになる
+ * @param name ノード名 (例: "layer1/conv1")
+ * @param bytes 読み書きするバイト数の見積もり
+ * @param flops 浮動小数点演算数の見積もり
+ */
+class Scope {
+public:
+    Scope(const char* op_type, const char* name, double bytes = 0.0, double flops = 0.0)
+        : active_(Profiler::instance().enabled()), op_type_(op_type), name_(name),
+          bytes_(bytes), flops_(flops), start_ns_(0),
+          counters_(active_ && Profiler::instance().counters_enabled()) {
+        if (!active_) return;
+        if (memory::hooks_installed()) memory_.emplace();
+        if (counters_) start_counters_ = PerfCounters::thread_instance().read();
+        start_ns_ = Profiler::instance().now_ns();
+    }
+
+    ~Scope() {
+        if (!active_) return;
+        Profiler& p = Profiler::instance();
+        const long long end_ns = p.now_ns();
+        const CounterSample counters = counters_
+            ? PerfCounters::delta(start_counters_, PerfCounters::thread_instance().read())
+            : PerfCounters::unavailable();
+        const long long allocations = memory_ ? memory_->allocations() : -1;
+        const long long alloc_bytes = memory_ ? memory_->bytes() : -1;
+        const long long peak_bytes = memory_ ? memory_->peak() : -1;
+        memory_.reset();
+        p.record(Event{op_type_, name_, start_ns_, end_ns, thread_index(), bytes_, flops_, counters,
+                       allocations, alloc_bytes, peak_bytes});
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool active_;
+    const char* op_type_;
+    const char* name_;
+    double bytes_;
+    double flops_;
+    long long start_ns_;
+    bool counters_;
+    CounterSample start_counters_;
+    std::optional<memory::ScopeCounter> memory_;
+};
+
+/**
+ * 関数呼び出しを1ノードとして計測し、その戻り値を返す
+ *
+ * ONNX_PROFILE が未定義の場合は fn() を呼ぶだけ。
+ */
+template<typename F>
+inline auto node(const char* op_type, const char* name, double bytes, double flops, F&& fn) -> decltype(fn()) {
+#ifdef ONNX_PROFILE
+    Scope scope(op_type, name, bytes, flops);
+#else
+    (void)op_type; (void)name; (void)bytes; (void)flops;
+#endif
+    return fn();
+}
+
+} // namespace profile
+} // namespace onnx
+
+#define ONNX_PROFILE_CONCAT_(a, b) a##b
+#define ONNX_PROFILE_CONCAT(a, b) ONNX_PROFILE_CONCAT_(a, b)
+
+#ifdef ONNX_PROFILE
+#define ONNX_PROFILE_SCOPE(op_type, name, bytes, flops) \
+    ::onnx::profile::Scope ONNX_PROFILE_CONCAT(onnx_profile_scope_, __LINE__)(op_type, name, bytes, flops)
+#else
+#define ONNX_PROFILE_SCOPE(op_type, name, bytes, flops) ((void)0)
+#endif
+
+#endif // ONNX_PROFILE_PROFILE_HPP
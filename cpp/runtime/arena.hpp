@@ -0,0 +1,186 @@
+#ifndef ONNX_RUNTIME_ARENA_HPP
+#define ONNX_RUNTIME_ARENA_HPP
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * カーネルの一時領域用バンプアロケータ
+ *
+ * 再帰層のゲートや入力射影など、カーネル内でだけ使う作業領域を
+ * スレッドごとのアリーナから切り出す。
+ * Allocation bumps an offset inside a block; memory is handed back only by
+ * rewinding to an earlier mark (ArenaScope does this when a kernel
+ * returns) or by reset() between inferences. Blocks are kept, so once the
+ * arena has grown to the largest working set, kernels run without calling
+ * malloc. Every allocation is aligned to 64 bytes (one cache line, wide
+ * enough for AVX-512 loads).
+ */
+
+namespace onnx {
+namespace runtime {
+
+/**
+ * スレッドローカルなバンプアリーナ
+ */
+class Arena {
+public:
+    static constexpr size_t alignment = 64;
+
+    /** アリーナ内の位置 (mark / release に使う) */
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+
+    explicit Arena(size_t block_size = size_t(1) << 20) : block_size_(block_size) {}
+
+    ~Arena() {
+        for (Block& b : blocks_) free_block(b);
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /** 呼び出しスレッドのアリーナ */
+    static Arena& thread_instance() {
+        thread_local Arena arena;
+        return arena;
+    }
+
+    /**
+     * n 個の T を確保する (64 バイト境界、未初期化)
+     *
+     * @param n 要素数
+     * @return 先頭へのポインタ (次の release / reset まで有効)
+     */
+    template<typename T>
+    T* allocate(size_t n) {
+        const size_t bytes = round_up(std::max<size_t>(n * sizeof(T), 1));
+
+        while (current_ < blocks_.size() && offset_ + bytes > blocks_[current_].size) {
+            ++current_;
+            offset_ = 0;
+        }
+        if (current_ == blocks_.size()) {
+            blocks_.push_back(new_block(std::max(bytes, block_size_)));
+            offset_ = 0;
+        }
+
+        T* ptr = reinterpret_cast<T*>(blocks_[current_].data + offset_);
+        offset_ += bytes;
+        const size_t used = used_bytes();
+        if (used > high_water_) high_water_ = used;
+        return ptr;
+    }
+
+    /** 現在の位置 */
+    Mark mark() const { return Mark{current_, offset_}; }
+
+    /** mark() 以降の確保をまとめて解放する */
+    void release(const Mark& m) {
+        current_ = m.block;
+        offset_ = m.offset;
+    }
+
+    /**
+     * 全ての確保を解放する (推論ごとに呼ぶ)
+     *
+     * If the arena had to chain several blocks, they are merged into one
+     * block of the total size, so later inferences bump through a single
+     * contiguous block.
+     */
+    void reset() {
+        if (blocks_.size() > 1) {
+            const size_t total = capacity();
+            for (Block& b : blocks_) free_block(b);
+            blocks_.clear();
+            blocks_.push_back(new_block(total));
+        }
+        current_ = 0;
+        offset_ = 0;
+    }
+
+    /** 使用中のバイト数 */
+    size_t used_bytes() const {
+        size_t used = offset_;
+        for (size_t i = 0; i < current_ && i < blocks_.size(); ++i) used += blocks_[i].size;
+        return used;
+    }
+
+    /** 確保済みブロックの合計バイト数 */
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& b : blocks_) total += b.size;
+        return total;
+    }
+
+    /** used_bytes() の最大値 */
+    size_t high_water() const { return high_water_; }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    static size_t round_up(size_t bytes) {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    static Block new_block(size_t size) {
+        return Block{static_cast<char*>(::operator new(size, std::align_val_t(alignment))), size};
+    }
+
+    static void free_block(Block& b) {
+        ::operator delete(b.data, std::align_val_t(alignment));
+    }
+
+    std::vector<Block> blocks_;
+    size_t current_ = 0;
+    size_t offset_ = 0;
+    size_t block_size_;
+    size_t high_water_ = 0;
+};
+
+/** アリーナ上の作業ベクトル / 行列 (64 バイト境界) */
+using ScratchVector = Eigen::Map<Eigen::VectorXd, Eigen::Aligned64>;
+using ScratchMatrix = Eigen::Map<Eigen::MatrixXd, Eigen::Aligned64>;
+
+/**
+ * カーネル1回分の作業領域 (RAII)
+ *
+ * 生成時にスレッドのアリーナの位置を記録し、破棄時にそこまで巻き戻す。
+ * Scopes nest, so a kernel may call another kernel that opens its own.
+ * Maps returned by vector() / matrix() must not outlive the scope.
+ */
+class ArenaScope {
+public:
+    ArenaScope() : arena_(Arena::thread_instance()), mark_(arena_.mark()) {}
+    ~ArenaScope() { arena_.release(mark_); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    /** 長さ n の作業ベクトル (未初期化) */
+    ScratchVector vector(Eigen::Index n) {
+        return ScratchVector(arena_.allocate<double>(n), n);
+    }
+
+    /** rows x cols の作業行列 (列優先、未初期化) */
+    ScratchMatrix matrix(Eigen::Index rows, Eigen::Index cols) {
+        return ScratchMatrix(arena_.allocate<double>(rows * cols), rows, cols);
+    }
+
+private:
+    Arena& arena_;
+    Arena::Mark mark_;
+};
+
+} // namespace runtime
+} // namespace onnx
+
+#endif // ONNX_RUNTIME_ARENA_HPP
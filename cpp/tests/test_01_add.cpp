@@ -37,6 +37,20 @@ int main() {
     assert((C2 - expected2).norm() < 1e-10);
     std::cout << "Test 2 (broadcasting) passed" << std::endl;
 
+    // Test 3: Accumulate into the first operand (row broadcast)
+    Eigen::MatrixXd A3(2, 3);
+    A3 << 1, 2, 3,
+          4, 5, 6;
+    Eigen::MatrixXd B3(1, 3);
+    B3 << 10, 20, 30;
+    add_into(A3, A3, B3);
+
+    Eigen::MatrixXd expected3(2, 3);
+    expected3 << 11, 22, 33,
+                 14, 25, 36;
+    assert((A3 - expected3).norm() < 1e-10);
+    std::cout << "Test 3 (add_into, out aliases A) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -29,6 +29,16 @@ int main() {
     assert((Y2 - expected2).norm() < 1e-10);
     std::cout << "Test 2 (floating point) passed" << std::endl;
 
+    // Test 3: In-place
+    Eigen::MatrixXd X3(2, 2);
+    X3 << 1.0, -2.0,
+          0.0, 4.5;
+    Eigen::MatrixXd expected3 = -X3;
+    neg_into(X3, X3);
+
+    assert((X3 - expected3).norm() < 1e-10);
+    std::cout << "Test 3 (in-place neg_into) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -35,6 +35,20 @@ int main() {
     assert((Z2 - expected2).norm() < 1e-10);
     std::cout << "Test 2 (scalar exponent) passed" << std::endl;
 
+    // Test 3: Row broadcast exponent, written into a caller buffer
+    Eigen::MatrixXd Y3(1, 2);
+    Y3 << 2, 3;
+
+    Eigen::MatrixXd Z3(2, 2);
+    pow_into(Z3, X, Y3);
+    Eigen::MatrixXd expected3(2, 2);
+    expected3 << 4, 27,
+                 16, 125;
+
+    assert((Z3 - expected3).norm() < 1e-10);
+    assert((pow(X, Y3) - expected3).norm() < 1e-10);
+    std::cout << "Test 3 (row broadcast, pow_into) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
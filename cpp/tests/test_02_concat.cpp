@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../02_concat.hpp"
 
 int main() {
@@ -58,6 +59,46 @@ int main() {
     assert((result2 - expected2).norm() < 1e-10);
     std::cout << "Test 3 (concat 2 matrices) passed" << std::endl;
 
+    // Test 4: N-D concat along a middle axis, compared with a direct loop
+    std::vector<std::vector<int>> shapes4 = {{2, 1, 3}, {2, 2, 3}, {2, 3, 3}};
+    Eigen::VectorXd x0 = Eigen::VectorXd::LinSpaced(6, 0, 5);
+    Eigen::VectorXd x1 = Eigen::VectorXd::LinSpaced(12, 100, 111);
+    Eigen::VectorXd x2 = Eigen::VectorXd::LinSpaced(18, 200, 217);
+    std::vector<int> out_shape4;
+    Eigen::VectorXd y4 = concat({&x0, &x1, &x2}, shapes4, -2, &out_shape4);
+
+    assert((out_shape4 == std::vector<int>{2, 6, 3}));
+    for (int a = 0; a < 2; ++a) {
+        for (int b = 0; b < 6; ++b) {
+            for (int c = 0; c < 3; ++c) {
+                double expected;
+                if (b < 1) expected = x0((a * 1 + b) * 3 + c);
+                else if (b < 3) expected = x1((a * 2 + b - 1) * 3 + c);
+                else expected = x2((a * 3 + b - 3) * 3 + c);
+                assert(std::abs(y4((a * 6 + b) * 3 + c) - expected) < 1e-10);
+            }
+        }
+    }
+    std::cout << "Test 4 (N-D concat) passed" << std::endl;
+
+    // Test 5: producers write into their slot, remaining inputs are copied
+    ConcatPlan plan5 = concat_plan(shapes4, 1);
+    Eigen::VectorXd y5(36);
+    auto slot1 = concat_slot(y5, plan5, 1);
+    assert(slot1.rows() == 2 && slot1.cols() == 6);
+    for (int r = 0; r < 2; ++r)
+        for (int c = 0; c < 6; ++c)
+            slot1(r, c) = x1(r * 6 + c);
+    concat_into(y5, plan5, {&x0, nullptr, &x2});
+    assert((y5 - y4).norm() < 1e-10);
+
+    Eigen::MatrixXd planar(6, 2);
+    concat_slot(planar, 0, 0, 2) = A;
+    concat_slot(planar, 0, 2, 2).noalias() = B * Eigen::MatrixXd::Identity(2, 2);
+    concat_slot(planar, 0, 4, 2) = C;
+    assert((planar - expected0).norm() < 1e-10);
+    std::cout << "Test 5 (in-place producer slots) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../02_flatten.hpp"
 
 int main() {
@@ -39,6 +40,16 @@ int main() {
     assert((flat2 - expected2).norm() < 1e-10);
     std::cout << "Test 3 (axis=2) passed" << std::endl;
 
+    // Test 5: N-D zero-copy view
+    Eigen::VectorXd x5 = Eigen::VectorXd::LinSpaced(24, 0, 23);
+    std::vector<int> out_shape;
+    auto view5 = flatten_view(x5, {2, 3, 4}, -1, out_shape);
+    assert(view5.data() == x5.data());
+    assert((out_shape == std::vector<int>{6, 4}));
+    assert((flatten_output_shape({2, 3, 4}, 0) == std::vector<int>{1, 24}));
+    assert((flatten_output_shape({2, 3, 4}, 3) == std::vector<int>{24, 1}));
+    std::cout << "Test 5 (zero-copy N-D view) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <vector>
 #include "../02_gather.hpp"
 
 int main() {
@@ -62,6 +64,74 @@ int main() {
     assert((result3 - expected3).norm() < 1e-10);
     std::cout << "Test 4 (single index) passed" << std::endl;
 
+    // Test 5: Negative indices (2D)
+    std::vector<int> indices5 = {-1, 0};
+    auto result5 = gather(data, indices5, 1);
+    assert(std::abs(result5(0, 0) - 3) < 1e-10);
+    assert(std::abs(result5(2, 1) - 7) < 1e-10);
+    std::cout << "Test 5 (negative indices) passed" << std::endl;
+
+    // Test 6: N-D gather with int32 and int64 indices, compared with a direct loop
+    std::vector<int> shape6 = {2, 5, 3};
+    Eigen::VectorXd x6 = Eigen::VectorXd::LinSpaced(30, 0, 29);
+    Eigen::VectorXi idx32(4);
+    idx32 << 4, -5, 2, -1;
+    Eigen::Matrix<int64_t, Eigen::Dynamic, 1> idx64 = idx32.cast<int64_t>();
+
+    std::vector<int> out_shape6;
+    Eigen::VectorXd y6 = gather(x6, shape6, idx32, {2, 2}, 1, &out_shape6);
+    Eigen::VectorXd y6_64 = gather(x6, shape6, idx64, {2, 2}, -2);
+
+    assert((out_shape6 == std::vector<int>{2, 2, 2, 3}));
+    assert((y6 - y6_64).norm() < 1e-10);
+    for (int a = 0; a < 2; ++a) {
+        for (int j = 0; j < 4; ++j) {
+            int i = idx32(j) < 0 ? idx32(j) + 5 : idx32(j);
+            for (int c = 0; c < 3; ++c) {
+                assert(std::abs(y6((a * 4 + j) * 3 + c) - x6((a * 5 + i) * 3 + c)) < 1e-10);
+            }
+        }
+    }
+    std::cout << "Test 6 (N-D gather, int32/int64) passed" << std::endl;
+
+    // Test 7: EmbeddingBag matches gather + reduce (sum / mean / max / weighted)
+    const int rows7 = 50, dim7 = 8;
+    Eigen::VectorXd table7 = Eigen::VectorXd::Random(rows7 * dim7);
+    Eigen::VectorXi idx7(9);
+    idx7 << 3, 17, -1, 0, 42, 42, 7, 8, 9;
+    Eigen::VectorXi lengths7(4);
+    lengths7 << 3, 0, 2, 4;
+    Eigen::VectorXi offsets7 = embeddingbag_offsets(lengths7);
+    Eigen::VectorXd weights7 = Eigen::VectorXd::LinSpaced(9, 0.5, 2.5);
+
+    Eigen::VectorXd gathered7 = gather(table7, {rows7, dim7}, idx7, {9}, 0);
+    Eigen::VectorXd sum7 = embeddingbag(table7, dim7, idx7, offsets7, "sum");
+    Eigen::VectorXd mean7 = embeddingbag(table7, dim7, idx7, offsets7, "mean");
+    Eigen::VectorXd max7 = embeddingbag(table7, dim7, idx7, offsets7, "max");
+    Eigen::VectorXd wsum7 = embeddingbag(table7, dim7, idx7, offsets7, "sum", &weights7);
+
+    assert(sum7.size() == 4 * dim7);
+    for (int b = 0; b < 4; ++b) {
+        Eigen::VectorXd s = Eigen::VectorXd::Zero(dim7);
+        Eigen::VectorXd w = Eigen::VectorXd::Zero(dim7);
+        Eigen::VectorXd m = Eigen::VectorXd::Zero(dim7);
+        for (int i = offsets7(b); i < offsets7(b) + lengths7(b); ++i) {
+            Eigen::VectorXd row = gathered7.segment(i * dim7, dim7);
+            s += row;
+            w += weights7(i) * row;
+            m = (i == offsets7(b)) ? row : Eigen::VectorXd(m.cwiseMax(row));
+        }
+        Eigen::VectorXd mean = (lengths7(b) > 0) ? Eigen::VectorXd(s / lengths7(b)) : s;
+        assert((sum7.segment(b * dim7, dim7) - s).norm() < 1e-10);
+        assert((mean7.segment(b * dim7, dim7) - mean).norm() < 1e-10);
+        assert((max7.segment(b * dim7, dim7) - m).norm() < 1e-10);
+        assert((wsum7.segment(b * dim7, dim7) - w).norm() < 1e-10);
+    }
+    // per_sample_weights only applies to mode="sum"
+    assert((embeddingbag(table7, dim7, idx7, offsets7, "mean", &weights7) - mean7).norm() < 1e-10);
+    assert((embeddingbag(table7, dim7, idx7, offsets7, "max", &weights7) - max7).norm() < 1e-10);
+    std::cout << "Test 7 (embeddingbag) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "../02_gatherelements.hpp"
+
+int main() {
+    using namespace onnx;
+
+    // Test 1: ONNX example, axis=1
+    Eigen::VectorXd data(4);
+    data << 1, 2,
+            3, 4;
+    Eigen::VectorXi indices(4);
+    indices << 0, 0,
+               1, 0;
+
+    auto result1 = gatherelements(data, {2, 2}, indices, {2, 2}, 1);
+
+    Eigen::VectorXd expected1(4);
+    expected1 << 1, 1,
+                 4, 3;
+
+    assert((result1 - expected1).norm() < 1e-10);
+    std::cout << "Test 1 (axis=1) passed" << std::endl;
+
+    // Test 2: ONNX example, axis=0 with smaller indices and int64 / negative indices
+    Eigen::VectorXd data2(9);
+    data2 << 1, 2, 3,
+             4, 5, 6,
+             7, 8, 9;
+    Eigen::Matrix<int64_t, Eigen::Dynamic, 1> indices2(6);
+    indices2 << 1, 2, 0,
+                2, 0, -3;
+
+    auto result2 = gatherelements(data2, {3, 3}, indices2, {2, 3}, 0);
+
+    Eigen::VectorXd expected2(6);
+    expected2 << 4, 8, 3,
+                 7, 2, 3;
+
+    assert(result2.size() == 6);
+    assert((result2 - expected2).norm() < 1e-10);
+    std::cout << "Test 2 (axis=0, int64, negative indices) passed" << std::endl;
+
+    // Test 3: 3-D, middle axis, compared with a direct loop
+    std::vector<int> shape3 = {2, 4, 3};
+    std::vector<int> ishape3 = {2, 2, 3};
+    Eigen::VectorXd data3 = Eigen::VectorXd::LinSpaced(24, 0, 23);
+    Eigen::VectorXi indices3(12);
+    indices3 << 3, 0, 1, 2, -1, 0,
+                1, 1, 2, 0, 3, -2;
+
+    auto result3 = gatherelements(data3, shape3, indices3, ishape3, -2);
+
+    for (int a = 0; a < 2; ++a) {
+        for (int b = 0; b < 2; ++b) {
+            for (int c = 0; c < 3; ++c) {
+                int i = indices3((a * 2 + b) * 3 + c);
+                if (i < 0) i += 4;
+                assert(std::abs(result3((a * 2 + b) * 3 + c) - data3((a * 4 + i) * 3 + c)) < 1e-10);
+            }
+        }
+    }
+    std::cout << "Test 3 (3D, middle axis) passed" << std::endl;
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
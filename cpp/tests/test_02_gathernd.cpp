@@ -0,0 +1,61 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "../02_gathernd.hpp"
+
+int main() {
+    using namespace onnx;
+
+    // Test 1: ONNX example, full index tuples
+    Eigen::VectorXd data(4);
+    data << 0, 1,
+            2, 3;
+    Eigen::VectorXi indices(4);
+    indices << 0, 0,
+               1, 1;
+
+    std::vector<int> out_shape1;
+    auto result1 = gathernd(data, {2, 2}, indices, {2, 2}, 0, &out_shape1);
+
+    assert((out_shape1 == std::vector<int>{2}));
+    assert(std::abs(result1(0) - 0) < 1e-10);
+    assert(std::abs(result1(1) - 3) < 1e-10);
+    std::cout << "Test 1 (element gather) passed" << std::endl;
+
+    // Test 2: ONNX example, partial tuples gather rows (int64, negative index)
+    Eigen::Matrix<int64_t, Eigen::Dynamic, 1> indices2(2);
+    indices2 << -1, 0;
+
+    std::vector<int> out_shape2;
+    auto result2 = gathernd(data, {2, 2}, indices2, {2, 1}, 0, &out_shape2);
+
+    Eigen::VectorXd expected2(4);
+    expected2 << 2, 3,
+                 0, 1;
+
+    assert((out_shape2 == std::vector<int>{2, 2}));
+    assert((result2 - expected2).norm() < 1e-10);
+    std::cout << "Test 2 (slab gather, negative index) passed" << std::endl;
+
+    // Test 3: ONNX example, batch_dims=1
+    Eigen::VectorXd data3 = Eigen::VectorXd::LinSpaced(8, 0, 7);
+    Eigen::VectorXi indices3(2);
+    indices3 << 1,
+                0;
+
+    std::vector<int> out_shape3;
+    auto result3 = gathernd(data3, {2, 2, 2}, indices3, {2, 1}, 1, &out_shape3);
+
+    Eigen::VectorXd expected3(4);
+    expected3 << 2, 3,
+                 4, 5;
+
+    assert((out_shape3 == std::vector<int>{2, 2}));
+    assert((result3 - expected3).norm() < 1e-10);
+    std::cout << "Test 3 (batch_dims=1) passed" << std::endl;
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../02_reshape.hpp"
 
 int main() {
@@ -43,6 +44,63 @@ int main() {
     assert((reshaped3 - expected3).norm() < 1e-10);
     std::cout << "Test 3 (3x3 to 1x9) passed" << std::endl;
 
+    // Test 4: N-D view shares the input buffer, 0 copies / -1 infers
+    Eigen::VectorXd x4 = Eigen::VectorXd::LinSpaced(24, 0, 23);
+    std::vector<int> out_shape;
+    Eigen::VectorXd storage;
+    auto view4 = reshape_view(x4, {2, 3, 4}, {0, -1}, out_shape, storage);
+    assert(view4.data() == x4.data());
+    assert(storage.size() == 0);
+    assert((out_shape == std::vector<int>{2, 12}));
+    assert((view4 - x4).norm() < 1e-10);
+    std::cout << "Test 4 (zero-copy view, 0 and -1) passed" << std::endl;
+
+    // Test 5: allowzero
+    std::vector<int> shape5;
+    assert(reshape_output_shape({2, 3, 4}, {4, 0, -1}, shape5));
+    assert((shape5 == std::vector<int>{4, 3, 2}));
+    assert(reshape_output_shape({0, 3}, {0, 3}, shape5, true));
+    assert((shape5 == std::vector<int>{0, 3}));
+    assert(reshape_output_shape({0, 3}, {3, -1}, shape5, true));
+    assert((shape5 == std::vector<int>{3, 0}));
+    std::cout << "Test 5 (allowzero) passed" << std::endl;
+
+    // Test 6: row-major matrices are shared, column-major ones are copied
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+    RowMatrix rm = data;
+    Eigen::VectorXd storage6;
+    auto view6 = reshape_view(rm, 4, 2, storage6);
+    assert(view6.data() == rm.data());
+    assert(storage6.size() == 0);
+    assert((view6 - expected).norm() < 1e-10);
+
+    auto view7 = reshape_view(data, 4, 2, storage6);
+    assert(view7.data() == storage6.data());
+    assert((view7 - expected).norm() < 1e-10);
+
+    auto view8 = reshape_view(data.row(1), {4}, {2, 2}, out_shape, storage6);
+    assert(view8.data() == storage6.data());
+    assert(std::abs(view8(0) - 5) < 1e-10 && std::abs(view8(3) - 8) < 1e-10);
+    std::cout << "Test 6 (copy only for non-contiguous input) passed" << std::endl;
+
+    // Test 7: rank-0 results and invalid new_shape
+    assert(reshape_output_shape({1, 1}, {}, shape5) && shape5.empty());
+    shape5 = {7};
+    assert(!reshape_output_shape({6}, {2, 0}, shape5));           // 0 with no input dim to copy
+    assert(!reshape_output_shape({6}, {-1, -1}, shape5));         // more than one -1
+    assert(!reshape_output_shape({6}, {4, -1}, shape5));          // 6 % 4 != 0
+    assert(!reshape_output_shape({6}, {0, -1}, shape5, true));    // -1 next to a zero dim
+    assert(!reshape_output_shape({6}, {2, -2}, shape5));          // negative dim
+    assert(!reshape_output_shape({6}, {2, 4}, shape5));           // element count mismatch
+    assert((shape5 == std::vector<int>{7}));
+    Eigen::VectorXd scalar = Eigen::VectorXd::Constant(1, 3.0);
+    Eigen::VectorXd storage7;
+    auto scalar_view = reshape_view(scalar, {1}, {}, shape5, storage7);
+    assert(shape5.empty() && scalar_view.size() == 1 && scalar_view(0) == 3.0);
+    auto bad_view = reshape_view(scalar, {1}, {2, -1}, shape5, storage7);
+    assert(shape5.empty() && bad_view.data() == nullptr && bad_view.size() == 0);
+    std::cout << "Test 7 (rank-0, invalid shapes) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
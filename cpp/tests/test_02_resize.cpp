@@ -1,6 +1,8 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <string>
+#include <vector>
 #include "../02_resize.hpp"
 
 int main() {
@@ -73,6 +75,171 @@ int main() {
     assert((resized5 - X).norm() < 1e-10);
     std::cout << "Test 5 (identity resize) passed" << std::endl;
 
+    // Test 6: NHWC matches per-channel resize
+    int C = 3, H = 5, W = 4;
+    std::vector<Eigen::MatrixXd> planes(C);
+    Eigen::VectorXd X6(H * W * C);
+    for (int c = 0; c < C; ++c) {
+        planes[c] = Eigen::MatrixXd::Random(H, W);
+        for (int h = 0; h < H; ++h) {
+            for (int w = 0; w < W; ++w) X6((h * W + w) * C + c) = planes[c](h, w);
+        }
+    }
+    for (const std::string mode : {"nearest", "linear"}) {
+        auto Y6 = resize_nhwc(X6, H, W, C, 2.0, 1.5, mode);
+        for (int c = 0; c < C; ++c) {
+            auto ref = resize(planes[c], 2.0, 1.5, mode);
+            assert(Y6.size() == ref.size() * C);
+            for (int i = 0; i < ref.rows(); ++i) {
+                for (int j = 0; j < ref.cols(); ++j) {
+                    assert(std::abs(Y6((i * ref.cols() + j) * C + c) - ref(i, j)) < 1e-12);
+                }
+            }
+        }
+    }
+    std::cout << "Test 6 (NHWC resize) passed" << std::endl;
+
+
+    // Test 7: ONNX linear (half_pixel, align_corners)
+    Eigen::MatrixXd X7(2, 2);
+    X7 << 1, 2,
+          3, 4;
+    Eigen::MatrixXd expected7(4, 4);
+    expected7 << 1.0, 1.25, 1.75, 2.0,
+                 1.5, 1.75, 2.25, 2.5,
+                 2.5, 2.75, 3.25, 3.5,
+                 3.0, 3.25, 3.75, 4.0;
+    assert((resize(X7, 2.0, 2.0, "linear") - expected7).norm() < 1e-10);
+
+    Eigen::MatrixXd expected7_ac(4, 4);
+    expected7_ac << 3, 4, 5, 6,
+                    5, 6, 7, 8,
+                    7, 8, 9, 10,
+                    9, 10, 11, 12;
+    expected7_ac /= 3.0;
+    assert((resize(X7, 2.0, 2.0, "linear", "align_corners") - expected7_ac).norm() < 1e-10);
+
+    Eigen::MatrixXd X7b(2, 4);
+    X7b << 1, 2, 3, 4,
+           5, 6, 7, 8;
+    auto Y7b = resize(X7b, 0.6, 0.6, "linear");
+    assert(Y7b.rows() == 1 && Y7b.cols() == 2);
+    assert(std::abs(Y7b(0, 0) - 2.6666666667) < 1e-6 && std::abs(Y7b(0, 1) - 4.3333333333) < 1e-6);
+
+    auto Y7c = resize(X7b, 0.6, 0.6, "nearest");
+    assert(Y7c.rows() == 1 && Y7c(0, 0) == 1 && Y7c(0, 1) == 3);
+    std::cout << "Test 7 (ONNX linear / nearest) passed" << std::endl;
+
+    // Test 8: ONNX cubic (downsample, upsample, exclude_outside)
+    Eigen::MatrixXd X8(4, 4);
+    X8 << 1, 2, 3, 4,
+          5, 6, 7, 8,
+          9, 10, 11, 12,
+          13, 14, 15, 16;
+    Eigen::MatrixXd expected8(3, 3);
+    expected8 << 1.47119141, 2.78125, 4.08251953,
+                 6.71142578, 8.02148438, 9.32275391,
+                 11.91650391, 13.2265625, 14.52783203;
+    assert((resize(X8, 0.8, 0.8, "cubic") - expected8).norm() < 1e-6);
+
+    Eigen::RowVectorXd expected8_up(8);
+    expected8_up << 0.47265625, 0.76953125, 1.24609375, 1.875,
+                    2.28125, 2.91015625, 3.38671875, 3.68359375;
+    auto Y8_up = resize(X8, 2.0, 2.0, "cubic");
+    assert((Y8_up.row(0) - expected8_up).norm() < 1e-6);
+
+    Eigen::RowVectorXd expected8_ex(8);
+    expected8_ex << 0.55882353, 0.81494204, 1.35698249, 1.89705882,
+                    2.39705882, 2.93713516, 3.47917561, 3.73529412;
+    auto Y8_ex = resize(X8, 2.0, 2.0, "cubic", "half_pixel", "round_prefer_floor", -0.5, false, true);
+    assert((Y8_ex.row(0) - expected8_ex).norm() < 1e-6);
+    std::cout << "Test 8 (cubic) passed" << std::endl;
+
+    // Test 9: Antialias (linear, cubic)
+    Eigen::MatrixXd expected9_linear(2, 2);
+    expected9_linear << 2.875, 4.5,
+                        9.375, 11.0;
+    assert((resize(X8, 0.6, 0.6, "linear", "half_pixel", "round_prefer_floor", -0.75, true)
+            - expected9_linear).norm() < 1e-6);
+
+    Eigen::MatrixXd expected9_cubic(2, 2);
+    expected9_cubic << 2.5180721, 4.2858863,
+                       9.589329, 11.357142;
+    assert((resize(X8, 0.6, 0.6, "cubic", "half_pixel", "round_prefer_floor", -0.75, true)
+            - expected9_cubic).norm() < 1e-5);
+    std::cout << "Test 9 (antialias) passed" << std::endl;
+
+    // Test 10: N-D NCHW with tf_crop_and_resize
+    Eigen::VectorXd X10 = Eigen::Map<Eigen::VectorXd>(Eigen::MatrixXd(X8.transpose()).data(), 16);
+    std::vector<double> roi10 = {0, 0, 0.4, 0.6, 1, 1, 0.6, 0.8};
+    auto Y10 = resize_with_sizes(X10, {1, 1, 4, 4}, {1, 1, 3, 3}, {1.0, 1.0, 0.75, 0.75},
+                                 "linear", "tf_crop_and_resize", "round_prefer_floor",
+                                 -0.75, false, false, 0.0, &roi10);
+    Eigen::VectorXd expected10(9);
+    expected10 << 7.6, 7.9, 8.2,
+                  8.8, 9.1, 9.4,
+                  10.0, 10.3, 10.6;
+    assert((Y10 - expected10).norm() < 1e-6);
+    std::cout << "Test 10 (N-D tf_crop_and_resize) passed" << std::endl;
+
+    // Test 11: N-D resize matches per-plane 2D resize
+    std::vector<int> shape11 = {2, 3, 5, 6};
+    Eigen::VectorXd X11 = Eigen::VectorXd::Random(2 * 3 * 5 * 6);
+    for (const std::string mode : {"nearest", "linear", "cubic"}) {
+        auto Y11 = resize(X11, shape11, {1.0, 1.0, 1.6, 0.5}, mode, "pytorch_half_pixel");
+        assert(Y11.size() == 2 * 3 * 8 * 3);
+        for (int plane = 0; plane < 6; ++plane) {
+            // Row-major (H, W) plane is a column-major (W, H) matrix
+            Eigen::Map<const Eigen::MatrixXd> in(X11.data() + plane * 30, 6, 5);
+            Eigen::MatrixXd ref = resize(in, 0.5, 1.6, mode, "pytorch_half_pixel");
+            Eigen::Map<const Eigen::MatrixXd> out(Y11.data() + plane * 24, 3, 8);
+            assert((out - ref).norm() < 1e-12);
+        }
+    }
+    std::cout << "Test 11 (N-D NCHW) passed" << std::endl;
+
+
+    // Test 12: Integer-ratio fast paths match the generic table path
+    auto table12 = resize_axis_table(9, 18, 2.0, "linear", "half_pixel", "round_prefer_floor",
+                                     -0.75, false, false);
+    assert(table12.stencil && table12.ratio == 2);
+    auto table12n = resize_axis_table(9, 27, 3.0, "nearest", "half_pixel", "round_prefer_floor",
+                                      -0.75, false, false);
+    assert(table12n.replicate && table12n.ratio == 3);
+
+    std::vector<int> shape12 = {2, 9, 11};
+    Eigen::VectorXd X12 = Eigen::VectorXd::Random(2 * 9 * 11);
+    for (const std::string mode : {"nearest", "linear", "cubic"}) {
+        for (const std::string coord : {"half_pixel", "asymmetric", "align_corners"}) {
+            for (int k : {2, 3, 4}) {
+                std::vector<int> sizes12 = {2, 9 * k, 11 * k};
+                std::vector<double> scales12 = {1.0, double(k), double(k)};
+                auto Y12 = resize_with_sizes(X12, shape12, sizes12, scales12, mode, coord);
+
+                // Generic evaluation straight from the tables
+                Eigen::VectorXd ref(2 * 9 * k * 11 * k);
+                auto th = resize_axis_table(9, 9 * k, k, mode, coord, "round_prefer_floor", -0.75, false, false);
+                auto tw = resize_axis_table(11, 11 * k, k, mode, coord, "round_prefer_floor", -0.75, false, false);
+                for (int n = 0; n < 2; ++n) {
+                    for (int i = 0; i < 9 * k; ++i) {
+                        for (int j = 0; j < 11 * k; ++j) {
+                            double v = 0.0;
+                            for (int a = 0; a < th.taps; ++a) {
+                                for (int b = 0; b < tw.taps; ++b) {
+                                    v += th.weight[i * th.taps + a] * tw.weight[j * tw.taps + b]
+                                       * X12(n * 99 + th.index[i * th.taps + a] * 11 + tw.index[j * tw.taps + b]);
+                                }
+                            }
+                            ref((n * 9 * k + i) * 11 * k + j) = v;
+                        }
+                    }
+                }
+                assert((Y12 - ref).norm() < 1e-10);
+            }
+        }
+    }
+    std::cout << "Test 12 (integer-ratio fast paths) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
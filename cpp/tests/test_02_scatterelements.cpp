@@ -0,0 +1,70 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "../02_scatterelements.hpp"
+
+int main() {
+    using namespace onnx;
+
+    // Test 1: ONNX example, axis=0
+    Eigen::VectorXd data = Eigen::VectorXd::Zero(9);
+    Eigen::VectorXi indices(6);
+    indices << 1, 0, 2,
+               0, 2, 1;
+    Eigen::VectorXd updates(6);
+    updates << 1.0, 1.1, 1.2,
+               2.0, 2.1, 2.2;
+
+    auto result1 = scatterelements(data, {3, 3}, indices, {2, 3}, updates, 0);
+
+    Eigen::VectorXd expected1(9);
+    expected1 << 2.0, 1.1, 0.0,
+                 1.0, 0.0, 2.2,
+                 0.0, 2.1, 1.2;
+
+    assert((result1 - expected1).norm() < 1e-10);
+    std::cout << "Test 1 (axis=0) passed" << std::endl;
+
+    // Test 2: ONNX example, axis=1 with negative index (int64)
+    Eigen::VectorXd data2(5);
+    data2 << 1, 2, 3, 4, 5;
+    Eigen::Matrix<int64_t, Eigen::Dynamic, 1> indices2(2);
+    indices2 << 1, -2;
+    Eigen::VectorXd updates2(2);
+    updates2 << 1.1, 2.1;
+
+    auto result2 = scatterelements(data2, {1, 5}, indices2, {1, 2}, updates2, 1);
+
+    Eigen::VectorXd expected2(5);
+    expected2 << 1.0, 1.1, 3.0, 2.1, 5.0;
+
+    assert((result2 - expected2).norm() < 1e-10);
+    std::cout << "Test 2 (axis=1, negative index) passed" << std::endl;
+
+    // Test 3: reductions with duplicate indices, in place
+    Eigen::VectorXd data3(5);
+    data3 << 1, 2, 3, 4, 5;
+    Eigen::VectorXi indices3(2);
+    indices3 << 1, 1;
+    Eigen::VectorXd updates3(2);
+    updates3 << 1.1, 2.1;
+
+    Eigen::VectorXd add3 = data3;
+    const double* ptr = add3.data();
+    scatterelements_inplace(add3, {1, 5}, indices3, {1, 2}, updates3, 1, "add");
+    assert(add3.data() == ptr);
+    assert(std::abs(add3(1) - 5.2) < 1e-10);
+
+    Eigen::VectorXd mul3 = scatterelements(data3, {1, 5}, indices3, {1, 2}, updates3, 1, "mul");
+    Eigen::VectorXd max3 = scatterelements(data3, {1, 5}, indices3, {1, 2}, updates3, 1, "max");
+    Eigen::VectorXd min3 = scatterelements(data3, {1, 5}, indices3, {1, 2}, updates3, 1, "min");
+    assert(std::abs(mul3(1) - 4.62) < 1e-10);
+    assert(std::abs(max3(1) - 2.1) < 1e-10);
+    assert(std::abs(min3(1) - 1.1) < 1e-10);
+    std::cout << "Test 3 (reductions, in place) passed" << std::endl;
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <vector>
 #include "../02_scatternd.hpp"
 
 int main() {
@@ -84,6 +86,65 @@ int main() {
     assert((result4 - expected4).norm() < 1e-10);
     std::cout << "Test 4 (single update) passed" << std::endl;
 
+    // Test 5: ONNX example, slice updates with reduction="add" and duplicate indices
+    std::vector<int> shape5 = {4, 4, 4};
+    Eigen::VectorXd data5(64);
+    for (int a = 0; a < 4; ++a) {
+        Eigen::VectorXd block(16);
+        block << 1, 2, 3, 4, 5, 6, 7, 8, 8, 7, 6, 5, 4, 3, 2, 1;
+        data5.segment(a * 16, 16) = block;
+    }
+    Eigen::VectorXi indices5(2);
+    indices5 << 0, 0;
+    Eigen::VectorXd updates5(32);
+    updates5 << 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 8, 8, 8, 8,
+                1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4;
+
+    auto result5 = scatternd(data5, shape5, indices5, {2, 1}, updates5, "add");
+
+    Eigen::VectorXd expected5 = data5;
+    Eigen::VectorXd block0(16);
+    block0 << 7, 8, 9, 10, 13, 14, 15, 16, 18, 17, 16, 15, 16, 15, 14, 13;
+    expected5.segment(0, 16) = block0;
+    assert((result5 - expected5).norm() < 1e-10);
+    std::cout << "Test 5 (slice updates, reduction=add) passed" << std::endl;
+
+    // Test 6: mul / max / min reductions, negative indices, int64
+    Eigen::VectorXd data6(4);
+    data6 << 1, 2, 3, 4;
+    Eigen::Matrix<int64_t, Eigen::Dynamic, 1> indices6(3);
+    indices6 << 1, -1, 1;
+    Eigen::VectorXd updates6(3);
+    updates6 << 5, 0.5, 3;
+
+    Eigen::VectorXd mul6 = scatternd(data6, {4}, indices6, {3, 1}, updates6, "mul");
+    Eigen::VectorXd max6 = scatternd(data6, {4}, indices6, {3, 1}, updates6, "max");
+    Eigen::VectorXd min6 = scatternd(data6, {4}, indices6, {3, 1}, updates6, "min");
+    Eigen::VectorXd none6 = scatternd(data6, {4}, indices6, {3, 1}, updates6);
+
+    assert(std::abs(mul6(1) - 30) < 1e-10 && std::abs(mul6(3) - 2) < 1e-10);
+    assert(std::abs(max6(1) - 5) < 1e-10 && std::abs(max6(3) - 4) < 1e-10);
+    assert(std::abs(min6(1) - 2) < 1e-10 && std::abs(min6(3) - 0.5) < 1e-10);
+    assert(std::abs(none6(1) - 3) < 1e-10 && std::abs(none6(0) - 1) < 1e-10);
+    std::cout << "Test 6 (mul/max/min reductions) passed" << std::endl;
+
+    // Test 7: in-place KV-cache update (batch, position) -> (heads * head_dim) row
+    std::vector<int> shape7 = {2, 8, 6};
+    Eigen::VectorXd cache = Eigen::VectorXd::Zero(96);
+    const double* cache_ptr = cache.data();
+    Eigen::VectorXi positions(4);
+    positions << 0, 3,
+                 1, 5;
+    Eigen::VectorXd rows7 = Eigen::VectorXd::LinSpaced(12, 1, 12);
+
+    scatternd_inplace(cache, shape7, positions, {2, 2}, rows7);
+
+    assert(cache.data() == cache_ptr);
+    assert((cache.segment(3 * 6, 6) - rows7.head(6)).norm() < 1e-10);
+    assert((cache.segment((8 + 5) * 6, 6) - rows7.tail(6)).norm() < 1e-10);
+    assert(std::abs(cache.sum() - rows7.sum()) < 1e-10);
+    std::cout << "Test 7 (in-place KV-cache update) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../02_slice.hpp"
 
 int main() {
@@ -58,6 +59,62 @@ int main() {
     assert((result4 - expected4).norm() < 1e-10);
     std::cout << "Test 4 (slice axis=1) passed" << std::endl;
 
+    // Test 5: Negative starts / ends / steps (2D)
+    auto result5 = slice_op(data, {-1, -2}, {-5, 0}, {-2, -3});
+
+    Eigen::MatrixXd expected5(2, 2);
+    expected5 << 22, 19,
+                 10, 7;
+
+    assert((result5 - expected5).norm() < 1e-10);
+    assert((slice_op(data, -3, 100, 0) - data.bottomRows(3)).norm() < 1e-10);
+    std::cout << "Test 5 (negative starts/ends/steps) passed" << std::endl;
+
+    // Test 6: N-D slice with axes, compared with a direct loop
+    std::vector<int> shape6 = {2, 3, 4, 5};
+    Eigen::VectorXd x6 = Eigen::VectorXd::LinSpaced(120, 0, 119);
+    std::vector<int> axes6 = {-1, 1, 2};
+    std::vector<long> steps6 = {-2, 1, 3};
+    std::vector<int> out_shape6;
+    Eigen::VectorXd y6 = slice(x6, shape6, {-1, 1, 0}, {-100, 3, 4}, &axes6, &steps6, &out_shape6);
+
+    assert((out_shape6 == std::vector<int>{2, 2, 2, 3}));
+    long k = 0;
+    for (int a = 0; a < 2; ++a)
+        for (int b = 1; b < 3; ++b)
+            for (int c = 0; c < 4; c += 3)
+                for (int d = 4; d >= 0; d -= 2)
+                    assert(std::abs(y6(k++) - x6(((a * 3 + b) * 4 + c) * 5 + d)) < 1e-10);
+    std::cout << "Test 6 (N-D slice with axes) passed" << std::endl;
+
+    // Test 7: contiguous slices are views, inner-axis slices are strided views
+    std::vector<int> shape7 = {4, 2, 6};  // (B*S, 2, 3*head_dim)
+    Eigen::VectorXd x7 = Eigen::VectorXd::LinSpaced(48, 0, 47);
+    Eigen::VectorXd storage;
+    std::vector<int> out_shape7;
+    std::vector<int> axes7 = {0};
+    auto view7 = slice_view(x7, shape7, {1}, {3}, &axes7, nullptr, out_shape7, storage);
+    assert(view7.data() == x7.data() + 12);
+    assert(view7.size() == 24);
+    assert(storage.size() == 0);
+
+    std::vector<int> axes8 = {2};
+    SliceLayout layout8 = slice_layout(shape7, {2}, {4}, &axes8);
+    assert(!slice_is_view(layout8));
+    assert(slice_is_strided_view(layout8));
+    auto strided8 = slice_strided_view(x7, layout8);
+    Eigen::VectorXd copy8 = slice(x7, shape7, {2}, {4}, &axes8);
+    assert(strided8.rows() == 8 && strided8.cols() == 2);
+    assert(strided8.data() == x7.data() + 2);
+    for (int r = 0; r < 8; ++r)
+        for (int c = 0; c < 2; ++c)
+            assert(std::abs(strided8(r, c) - copy8(r * 2 + c)) < 1e-10);
+
+    auto view8 = slice_view(x7, shape7, {2}, {4}, &axes8, nullptr, out_shape7, storage);
+    assert(view8.data() == storage.data());
+    assert((view8 - copy8).norm() < 1e-10);
+    std::cout << "Test 7 (zero-copy and strided views) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
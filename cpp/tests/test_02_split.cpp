@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../02_split.hpp"
 
 int main() {
@@ -69,6 +70,33 @@ int main() {
 
     std::cout << "Test 3 (split axis=1) passed" << std::endl;
 
+    // Test 4: N-D split into views (multi-head pattern along the last axis)
+    std::vector<int> shape4 = {2, 3, 6};
+    Eigen::VectorXd x4 = Eigen::VectorXd::LinSpaced(36, 0, 35);
+    std::vector<std::vector<int>> shapes4;
+    auto views4 = split_view(x4, shape4, -1, split_output_sizes(6, 3), shapes4);
+
+    assert(views4.size() == 3);
+    for (int k = 0; k < 3; ++k) {
+        assert((shapes4[k] == std::vector<int>{2, 3, 2}));
+        assert(views4[k].data() == x4.data() + 2 * k);
+        for (int r = 0; r < 6; ++r)
+            for (int c = 0; c < 2; ++c)
+                assert(std::abs(views4[k](r, c) - x4(r * 6 + 2 * k + c)) < 1e-10);
+    }
+    std::cout << "Test 4 (N-D split views) passed" << std::endl;
+
+    // Test 5: uneven split and copies along a middle axis
+    assert((split_output_sizes(7, 3) == std::vector<int>{3, 3, 1}));
+    std::vector<std::vector<int>> shapes5;
+    auto outputs5 = split(x4, shape4, 1, {1, 2}, &shapes5);
+    assert((shapes5[1] == std::vector<int>{2, 2, 6}));
+    assert(outputs5[0].size() == 12 && outputs5[1].size() == 24);
+    assert(std::abs(outputs5[0](6) - 18) < 1e-10);
+    assert(std::abs(outputs5[1](0) - 6) < 1e-10);
+    assert(std::abs(outputs5[1](12) - 24) < 1e-10);
+    std::cout << "Test 5 (N-D split with sizes) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../02_squeeze.hpp"
 
 int main() {
@@ -49,6 +50,17 @@ int main() {
     assert((squeezed4 - data4).norm() < 1e-10);
     std::cout << "Test 4 (no squeeze) passed" << std::endl;
 
+    // Test 5: N-D zero-copy view
+    Eigen::VectorXd x5 = Eigen::VectorXd::LinSpaced(6, 0, 5);
+    std::vector<int> out_shape;
+    auto view5 = squeeze_view(x5, {1, 2, 1, 3}, nullptr, out_shape);
+    assert(view5.data() == x5.data());
+    assert((out_shape == std::vector<int>{2, 3}));
+    std::vector<int> axes{-2};
+    squeeze_view(x5, {1, 2, 1, 3}, &axes, out_shape);
+    assert((out_shape == std::vector<int>{1, 2, 3}));
+    std::cout << "Test 5 (zero-copy N-D view) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,8 +1,34 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../02_transpose.hpp"
 
+// Reference N-D transpose (element by element)
+Eigen::VectorXd reference_transpose(const Eigen::VectorXd& data,
+                                    const std::vector<int>& shape,
+                                    const std::vector<int>& perm) {
+    int rank = shape.size();
+    std::vector<int> in_stride(rank, 1);
+    for (int d = rank - 2; d >= 0; --d) in_stride[d] = in_stride[d + 1] * shape[d + 1];
+
+    std::vector<int> out_shape(rank);
+    for (int k = 0; k < rank; ++k) out_shape[k] = shape[perm[k]];
+
+    Eigen::VectorXd out(data.size());
+    std::vector<int> idx(rank, 0);
+    for (int n = 0; n < data.size(); ++n) {
+        int src = 0;
+        for (int k = 0; k < rank; ++k) src += idx[k] * in_stride[perm[k]];
+        out(n) = data(src);
+        for (int k = rank - 1; k >= 0; --k) {
+            if (++idx[k] < out_shape[k]) break;
+            idx[k] = 0;
+        }
+    }
+    return out;
+}
+
 int main() {
     using namespace onnx;
 
@@ -39,6 +65,68 @@ int main() {
     assert((transposed2 - expected2).norm() < 1e-10);
     std::cout << "Test 2 (square matrix) passed" << std::endl;
 
+    // Test 3: NCHW -> NHWC on a 4D tensor
+    std::vector<int> shape3 = {2, 3, 37, 41};
+    Eigen::VectorXd data3 = Eigen::VectorXd::LinSpaced(2 * 3 * 37 * 41, 0, 2 * 3 * 37 * 41 - 1);
+
+    auto nhwc = transpose(data3, shape3, {0, 2, 3, 1});
+    assert((nhwc - reference_transpose(data3, shape3, {0, 2, 3, 1})).norm() < 1e-10);
+
+    // and back
+    auto nchw = transpose(nhwc, {2, 37, 41, 3}, {0, 3, 1, 2});
+    assert((nchw - data3).norm() < 1e-10);
+    std::cout << "Test 3 (NCHW <-> NHWC) passed" << std::endl;
+
+    // Test 4: 5D permutations including default (reversed) perm
+    std::vector<int> shape4 = {2, 3, 4, 5, 6};
+    Eigen::VectorXd data4 = Eigen::VectorXd::Random(2 * 3 * 4 * 5 * 6);
+    std::vector<std::vector<int>> perms = {
+        {0, 2, 1, 3, 4}, {0, 1, 3, 2, 4}, {4, 3, 2, 1, 0},
+        {1, 0, 4, 2, 3}, {2, 3, 0, 1, 4}, {0, 3, 4, 1, 2}
+    };
+    for (const auto& perm : perms) {
+        assert((transpose(data4, shape4, perm) - reference_transpose(data4, shape4, perm)).norm() < 1e-12);
+    }
+    assert((transpose(data4, shape4, {}) - reference_transpose(data4, shape4, {4, 3, 2, 1, 0})).norm() < 1e-12);
+    std::cout << "Test 4 (5D permutations) passed" << std::endl;
+
+    // Test 5: Attention head reshuffle (B, S, H, D) -> (B, H, S, D)
+    std::vector<int> shape5 = {2, 7, 4, 8};
+    Eigen::VectorXd data5 = Eigen::VectorXd::Random(2 * 7 * 4 * 8);
+    assert((transpose(data5, shape5, {0, 2, 1, 3}) - reference_transpose(data5, shape5, {0, 2, 1, 3})).norm() < 1e-12);
+    std::cout << "Test 5 (head reshuffle) passed" << std::endl;
+
+    // Test 6: Layout-compatible permutation returns a zero-copy view
+    std::vector<int> shape6 = {1, 3, 1, 5};
+    Eigen::VectorXd data6 = Eigen::VectorXd::Random(15);
+    Eigen::VectorXd storage;
+
+    assert(transpose_is_view(shape6, {2, 1, 0, 3}));
+    auto view6 = transpose_view(data6, shape6, {2, 1, 0, 3}, storage);
+    assert(view6.data() == data6.data());
+    assert(storage.size() == 0);
+
+    assert(!transpose_is_view(shape6, {0, 3, 2, 1}));
+    auto view6b = transpose_view(data6, shape6, {0, 3, 2, 1}, storage);
+    assert(view6b.data() == storage.data());
+    assert((view6b - reference_transpose(data6, shape6, {0, 3, 2, 1})).norm() < 1e-12);
+    std::cout << "Test 6 (zero-copy view) passed" << std::endl;
+
+    // Test 7: NCHW <-> NCHWc (C not a multiple of the block)
+    int C7 = 5, H7 = 3, W7 = 4, block7 = 4;
+    Eigen::VectorXd data7 = Eigen::VectorXd::Random(C7 * H7 * W7);
+    auto blocked7 = nchw_to_nchwc(data7, C7, H7, W7, block7);
+
+    assert(blocked7.size() == 2 * H7 * W7 * block7);
+    for (int c = 0; c < 8; ++c) {
+        for (int p = 0; p < H7 * W7; ++p) {
+            double expected = (c < C7) ? data7(c * H7 * W7 + p) : 0.0;
+            assert(blocked7(((c / block7) * H7 * W7 + p) * block7 + c % block7) == expected);
+        }
+    }
+    assert((nchwc_to_nchw(blocked7, C7, H7, W7, block7) - data7).norm() < 1e-12);
+    std::cout << "Test 7 (NCHW <-> NCHWc) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../02_unsqueeze.hpp"
 
 int main() {
@@ -43,6 +44,15 @@ int main() {
     assert((unsqueezed3 - expected3).norm() < 1e-10);
     std::cout << "Test 3 (column to row) passed" << std::endl;
 
+    // Test 4: N-D zero-copy view
+    Eigen::VectorXd x4 = Eigen::VectorXd::LinSpaced(6, 0, 5);
+    std::vector<int> out_shape;
+    auto view4 = unsqueeze_view(x4, {2, 3}, {0, -1}, out_shape);
+    assert(view4.data() == x4.data());
+    assert((out_shape == std::vector<int>{1, 2, 3, 1}));
+    assert((unsqueeze_output_shape({2, 3}, {1, 3}) == std::vector<int>{2, 1, 3, 1}));
+    std::cout << "Test 4 (zero-copy N-D view) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,8 +1,37 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../03_averagepool.hpp"
 
+// Reference AveragePool: recompute every window with bounds checks
+Eigen::MatrixXd reference_averagepool(const Eigen::MatrixXd& X, int C, int H, int W,
+                                      int kh_, int kw_, int sh, int sw,
+                                      int pt, int pl, int pb, int pr, int out_h, int out_w,
+                                      int dh, int dw, bool count_include_pad) {
+    Eigen::MatrixXd Y(C, out_h * out_w);
+    for (int c = 0; c < C; ++c) {
+        for (int oh = 0; oh < out_h; ++oh) {
+            for (int ow = 0; ow < out_w; ++ow) {
+                double sum = 0.0;
+                int count = 0;
+                for (int kh = 0; kh < kh_; ++kh) {
+                    for (int kw = 0; kw < kw_; ++kw) {
+                        int h = oh * sh - pt + kh * dh;
+                        int w = ow * sw - pl + kw * dw;
+                        bool inside = h >= 0 && h < H && w >= 0 && w < W;
+                        bool in_pad = h >= -pt && h < H + pb && w >= -pl && w < W + pr;
+                        if (inside) sum += X(c, h * W + w);
+                        if (count_include_pad ? in_pad : inside) ++count;
+                    }
+                }
+                Y(c, oh * out_w + ow) = sum / count;
+            }
+        }
+    }
+    return Y;
+}
+
 int main() {
     using namespace onnx;
 
@@ -40,6 +69,107 @@ int main() {
     assert((Y2 - expected2).norm() < 1e-10);
     std::cout << "Test 2 (simple average) passed" << std::endl;
 
+    // Test 3: NHWC and NCHWc match the planar implementation
+    int C = 5, H = 7, W = 9, block = 4;
+    Eigen::MatrixXd X3 = Eigen::MatrixXd::Random(C, H * W);
+    auto Y3 = averagepool(X3, C, H, W, 3, 3, 2, 2, 1, 1, 1, 1);
+    int P = Y3.cols();
+
+    Eigen::VectorXd X3_nhwc(C * H * W);
+    Eigen::VectorXd X3_nchwc = Eigen::VectorXd::Zero(2 * H * W * block);
+    for (int c = 0; c < C; ++c) {
+        for (int p = 0; p < H * W; ++p) {
+            X3_nhwc(p * C + c) = X3(c, p);
+            X3_nchwc(((c / block) * H * W + p) * block + c % block) = X3(c, p);
+        }
+    }
+
+    auto Y3_nhwc = averagepool_nhwc(X3_nhwc, C, H, W, 3, 3, 2, 2, 1, 1, 1, 1);
+    auto Y3_nchwc = averagepool_nchwc(X3_nchwc, C, H, W, block, 3, 3, 2, 2, 1, 1, 1, 1);
+    for (int c = 0; c < C; ++c) {
+        for (int p = 0; p < P; ++p) {
+            assert(std::abs(Y3_nhwc(p * C + c) - Y3(c, p)) < 1e-12);
+            assert(std::abs(Y3_nchwc(((c / block) * P + p) * block + c % block) - Y3(c, p)) < 1e-12);
+        }
+    }
+    std::cout << "Test 3 (NHWC / NCHWc) passed" << std::endl;
+
+    // Test 4: count_include_pad (3x3 kernel, padding 1)
+    Eigen::MatrixXd X4(1, 4);
+    X4 << 1, 2,
+          3, 4;
+    auto Y4 = averagepool(X4, 1, 2, 2, 3, 3, 1, 1, 1, 1, 1, 1);
+    auto Y4_pad = averagepool(X4, 1, 2, 2, 3, 3, 1, 1, 1, 1, 1, 1, false, true);
+    assert((Y4.array() - 2.5).abs().maxCoeff() < 1e-10);
+    assert((Y4_pad.array() - 10.0 / 9.0).abs().maxCoeff() < 1e-10);
+    std::cout << "Test 4 (count_include_pad) passed" << std::endl;
+
+    // Test 5: Separable / running-sum paths against the reference
+    struct Case { int kh, kw, sh, sw, pt, pl, pb, pr, dh, dw; bool ceil, include_pad; };
+    std::vector<Case> cases = {
+        {3, 3, 1, 1, 1, 1, 1, 1, 1, 1, false, false},
+        {3, 3, 1, 1, 1, 1, 1, 1, 1, 1, false, true},
+        {3, 2, 2, 1, 0, 1, 1, 0, 2, 3, true, false},
+        {7, 9, 1, 2, 3, 4, 3, 4, 1, 1, false, true},    // running-sum path
+        {5, 5, 3, 2, 2, 1, 2, 2, 1, 1, true, true},     // running-sum path, ceil_mode
+        {5, 5, 3, 2, 2, 1, 2, 2, 1, 1, true, false},
+    };
+    int C5 = 3, H5 = 17, W5 = 23;
+    Eigen::MatrixXd X5 = Eigen::MatrixXd::Random(C5, H5 * W5);
+    for (const auto& k : cases) {
+        auto Y5 = averagepool(X5, C5, H5, W5, k.kh, k.kw, k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                              k.ceil, k.include_pad, k.dh, k.dw);
+        int out_h = maxpool_output_size(H5, k.kh, k.sh, k.dh, k.pt, k.pb, k.ceil);
+        int out_w = maxpool_output_size(W5, k.kw, k.sw, k.dw, k.pl, k.pr, k.ceil);
+        auto ref = reference_averagepool(X5, C5, H5, W5, k.kh, k.kw, k.sh, k.sw,
+                                         k.pt, k.pl, k.pb, k.pr, out_h, out_w,
+                                         k.dh, k.dw, k.include_pad);
+        assert(Y5.cols() == out_h * out_w);
+        assert((Y5 - ref).norm() < 1e-10);
+    }
+    std::cout << "Test 5 (sliding window, dilations, count_include_pad) passed" << std::endl;
+
+    // Test 6: NHWC count_include_pad matches the planar implementation
+    Eigen::VectorXd X6_nhwc(C5 * H5 * W5);
+    for (int c = 0; c < C5; ++c) {
+        for (int p = 0; p < H5 * W5; ++p) X6_nhwc(p * C5 + c) = X5(c, p);
+    }
+    auto Y6 = averagepool(X5, C5, H5, W5, 3, 3, 2, 2, 1, 1, 1, 1, false, true);
+    auto Y6_nhwc = averagepool_nhwc(X6_nhwc, C5, H5, W5, 3, 3, 2, 2, 1, 1, 1, 1, false, true);
+    for (int c = 0; c < C5; ++c) {
+        for (int p = 0; p < Y6.cols(); ++p) {
+            assert(std::abs(Y6_nhwc(p * C5 + c) - Y6(c, p)) < 1e-12);
+        }
+    }
+    std::cout << "Test 6 (NHWC count_include_pad) passed" << std::endl;
+
+    // Test 7: NHWC / NCHWc follow the same output size with ceil_mode and dilations
+    const int block7 = 2;
+    Eigen::VectorXd X7_nchwc = Eigen::VectorXd::Zero(2 * H5 * W5 * block7);
+    for (int c = 0; c < C5; ++c) {
+        for (int p = 0; p < H5 * W5; ++p) {
+            X7_nchwc(((c / block7) * H5 * W5 + p) * block7 + c % block7) = X5(c, p);
+        }
+    }
+    for (const auto& k : cases) {
+        auto Y7 = averagepool(X5, C5, H5, W5, k.kh, k.kw, k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                              k.ceil, k.include_pad, k.dh, k.dw);
+        auto Y7_nhwc = averagepool_nhwc(X6_nhwc, C5, H5, W5, k.kh, k.kw, k.sh, k.sw,
+                                        k.pt, k.pl, k.pb, k.pr, k.ceil, k.include_pad, k.dh, k.dw);
+        auto Y7_nchwc = averagepool_nchwc(X7_nchwc, C5, H5, W5, block7, k.kh, k.kw, k.sh, k.sw,
+                                          k.pt, k.pl, k.pb, k.pr, k.ceil, k.include_pad, k.dh, k.dw);
+        int P7 = Y7.cols();
+        assert(Y7_nhwc.size() == static_cast<long>(P7) * C5);
+        assert(Y7_nchwc.size() == static_cast<long>(P7) * 2 * block7);
+        for (int c = 0; c < C5; ++c) {
+            for (int p = 0; p < P7; ++p) {
+                assert(std::abs(Y7_nhwc(p * C5 + c) - Y7(c, p)) < 1e-12);
+                assert(std::abs(Y7_nchwc(((c / block7) * P7 + p) * block7 + c % block7) - Y7(c, p)) < 1e-12);
+            }
+        }
+    }
+    std::cout << "Test 7 (NHWC / NCHWc ceil_mode, dilations) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <string>
 #include "../03_conv.hpp"
 
 int main() {
@@ -44,6 +45,107 @@ int main() {
     assert((Y2 - expected2).norm() < 1e-10);
     std::cout << "Test 2 (with bias) passed" << std::endl;
 
+    // Test 3: NHWC matches the planar implementation (stride 2, padding)
+    int C_in = 3, H = 7, W_dim = 6, M = 4;
+    Eigen::MatrixXd X3 = Eigen::MatrixXd::Random(C_in, H * W_dim);
+    Eigen::MatrixXd W3 = Eigen::MatrixXd::Random(M, C_in * 3 * 3);
+    Eigen::VectorXd bias3 = Eigen::VectorXd::Random(M);
+
+    auto Y3 = conv(X3, W3, &bias3, C_in, H, W_dim, M, 3, 3, 2, 2, 1, 1, 1, 0);
+
+    // Planar (C x HW) -> flattened (H, W, C)
+    Eigen::VectorXd X3_nhwc(C_in * H * W_dim);
+    for (int c = 0; c < C_in; ++c) {
+        for (int p = 0; p < H * W_dim; ++p) X3_nhwc(p * C_in + c) = X3(c, p);
+    }
+    auto Y3_nhwc = conv_nhwc(X3_nhwc, W3, &bias3, C_in, H, W_dim, M, 3, 3, 2, 2, 1, 1, 1, 0);
+
+    assert(Y3_nhwc.size() == Y3.size());
+    for (int m = 0; m < M; ++m) {
+        for (int p = 0; p < Y3.cols(); ++p) {
+            assert(std::abs(Y3_nhwc(p * M + m) - Y3(m, p)) < 1e-10);
+        }
+    }
+    std::cout << "Test 3 (NHWC conv) passed" << std::endl;
+
+    // Test 4: NHWC depthwise conv (group = C_in = M)
+    Eigen::MatrixXd W4 = Eigen::MatrixXd::Random(C_in, 3 * 3);
+    auto Y4_nhwc = conv_nhwc(X3_nhwc, W4, nullptr, C_in, H, W_dim, C_in, 3, 3, 1, 1, 1, 1, 1, 1, C_in);
+
+    for (int c = 0; c < C_in; ++c) {
+        Eigen::MatrixXd Xc = X3.row(c);
+        Eigen::MatrixXd Wc = W4.row(c);
+        auto Yc = conv(Xc, Wc, nullptr, 1, H, W_dim, 1, 3, 3, 1, 1, 1, 1, 1, 1);
+        for (int p = 0; p < Yc.cols(); ++p) {
+            assert(std::abs(Y4_nhwc(p * C_in + c) - Yc(0, p)) < 1e-10);
+        }
+    }
+    std::cout << "Test 4 (NHWC depthwise conv) passed" << std::endl;
+
+
+    // Test 5: Virtual reflect / edge / wrap padding matches conv on a padded copy
+    int C5 = 2, H5 = 5, W5 = 6, M5 = 3;
+    Eigen::MatrixXd X5 = Eigen::MatrixXd::Random(C5, H5 * W5);
+    Eigen::MatrixXd W5m = Eigen::MatrixXd::Random(M5, C5 * 9);
+    for (const std::string mode : {"reflect", "edge", "wrap"}) {
+        // Explicitly padded input (H5 + 2, W5 + 3)
+        Eigen::MatrixXd Xp(C5, (H5 + 2) * (W5 + 3));
+        for (int c = 0; c < C5; ++c) {
+            for (int h = 0; h < H5 + 2; ++h) {
+                for (int w = 0; w < W5 + 3; ++w) {
+                    int sh = pad_source_index(h - 1, H5, mode);
+                    int sw = pad_source_index(w - 2, W5, mode);
+                    Xp(c, h * (W5 + 3) + w) = X5(c, sh * W5 + sw);
+                }
+            }
+        }
+        auto ref = conv(Xp, W5m, nullptr, C5, H5 + 2, W5 + 3, M5, 3, 3, 1, 2);
+        auto Y5 = conv(X5, W5m, nullptr, C5, H5, W5, M5, 3, 3, 1, 2, 1, 2, 1, 1, mode);
+        assert((Y5 - ref).norm() < 1e-10);
+    }
+    std::cout << "Test 5 (virtual padding modes) passed" << std::endl;
+
+    // Test 6: conv_into writes into a block of a larger buffer
+    {
+        Eigen::MatrixXd ref = conv(X5, W5m, nullptr, C5, H5, W5, M5, 3, 3, 1, 1, 1, 1, 1, 1);
+        Eigen::MatrixXd buffer = Eigen::MatrixXd::Constant(M5 + 2, ref.cols(), 7.0);
+        conv_into(buffer.middleRows(1, M5), X5, W5m, nullptr, C5, H5, W5, M5, 3, 3, 1, 1, 1, 1, 1, 1);
+        assert((buffer.middleRows(1, M5) - ref).norm() < 1e-10);
+        assert((buffer.row(0).array() == 7.0).all() && (buffer.row(M5 + 1).array() == 7.0).all());
+    }
+    std::cout << "Test 6 (conv_into, strided output) passed" << std::endl;
+
+    // Test 7: NCHWc matches NHWC (dense, grouped, depthwise; partial tail blocks)
+    {
+        const int C7 = 6, H7 = 7, W7 = 5, block7 = 4, blocks7 = 2;
+        Eigen::VectorXd X7_nhwc = Eigen::VectorXd::Random(C7 * H7 * W7);
+        Eigen::VectorXd X7_nchwc = Eigen::VectorXd::Zero(blocks7 * H7 * W7 * block7);
+        for (int p = 0; p < H7 * W7; ++p) {
+            for (int c = 0; c < C7; ++c) {
+                X7_nchwc(((c / block7) * H7 * W7 + p) * block7 + c % block7) = X7_nhwc(p * C7 + c);
+            }
+        }
+        struct Case { int M, group, stride, pad; };
+        for (const Case& k : {Case{5, 1, 2, 1}, Case{6, 2, 1, 1}, Case{6, 6, 1, 0}}) {
+            Eigen::MatrixXd W7m = Eigen::MatrixXd::Random(k.M, (C7 / k.group) * 9);
+            Eigen::VectorXd b7 = Eigen::VectorXd::Random(k.M);
+            auto ref = conv_nhwc(X7_nhwc, W7m, &b7, C7, H7, W7, k.M, 3, 3, k.stride, k.stride,
+                                 k.pad, k.pad, k.pad, k.pad, k.group);
+            auto Y7 = conv_nchwc(X7_nchwc, W7m, &b7, C7, H7, W7, k.M, block7, 3, 3, k.stride, k.stride,
+                                 k.pad, k.pad, k.pad, k.pad, k.group);
+            const int P7 = ref.size() / k.M;
+            const int out_blocks7 = (k.M + block7 - 1) / block7;
+            assert(Y7.size() == static_cast<long>(out_blocks7) * P7 * block7);
+            for (int p = 0; p < P7; ++p) {
+                for (int m = 0; m < out_blocks7 * block7; ++m) {
+                    double y = Y7(((m / block7) * P7 + p) * block7 + m % block7);
+                    assert(std::abs(y - (m < k.M ? ref(p * k.M + m) : 0.0)) < 1e-10);
+                }
+            }
+        }
+    }
+    std::cout << "Test 7 (NCHWc conv) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,8 +1,39 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../03_convtranspose.hpp"
 
+// Reference scatter implementation with ONNX attributes
+Eigen::MatrixXd reference_convtranspose(const Eigen::MatrixXd& X, const Eigen::MatrixXd& W,
+                                        int C_in, int H, int W_dim, int M, int kH, int kW,
+                                        int sh, int sw, int pt, int pl, int pb, int pr,
+                                        int oph, int opw, int dh, int dw, int group) {
+    int out_h = (H - 1) * sh + oph + (kH - 1) * dh + 1 - pt - pb;
+    int out_w = (W_dim - 1) * sw + opw + (kW - 1) * dw + 1 - pl - pr;
+    int Cg = C_in / group, Mg = M / group;
+    Eigen::MatrixXd Y = Eigen::MatrixXd::Zero(M, out_h * out_w);
+    for (int c = 0; c < C_in; ++c) {
+        int g = c / Cg;
+        for (int h = 0; h < H; ++h) {
+            for (int w = 0; w < W_dim; ++w) {
+                for (int m = 0; m < Mg; ++m) {
+                    for (int kh = 0; kh < kH; ++kh) {
+                        for (int kw = 0; kw < kW; ++kw) {
+                            int oh = h * sh + kh * dh - pt;
+                            int ow = w * sw + kw * dw - pl;
+                            if (oh < 0 || oh >= out_h || ow < 0 || ow >= out_w) continue;
+                            Y(g * Mg + m, oh * out_w + ow) +=
+                                X(c, h * W_dim + w) * W(c, m * kH * kW + kh * kW + kw);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return Y;
+}
+
 int main() {
     using namespace onnx;
 
@@ -37,6 +68,52 @@ int main() {
 
     std::cout << "Test 2 (with bias) passed" << std::endl;
 
+    // Test 3: Exact values for the stride-2 case
+    Eigen::MatrixXd expected3(1, 16);
+    expected3 << 1, 1, 2, 2,
+                 1, 1, 2, 2,
+                 3, 3, 4, 4,
+                 3, 3, 4, 4;
+    assert((Y - expected3).norm() < 1e-10);
+    std::cout << "Test 3 (stride 2 values) passed" << std::endl;
+
+    // Test 4: col2im / sub-pixel engines against the reference
+    struct Case { int sh, sw, pt, pl, pb, pr, oph, opw, dh, dw, group; };
+    std::vector<Case> cases = {
+        {1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1},
+        {1, 1, 1, 0, 0, 1, 0, 0, 2, 1, 2},
+        {2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+        {2, 3, 0, 1, 2, 0, 1, 2, 1, 2, 2},
+        {3, 2, 2, 1, 0, 1, 0, 1, 2, 2, 1},
+    };
+    int C_in = 4, H = 5, W_dim = 6, M = 6, kH = 3, kW = 3;
+    Eigen::MatrixXd X4 = Eigen::MatrixXd::Random(C_in, H * W_dim);
+    Eigen::VectorXd bias4 = Eigen::VectorXd::Random(M);
+
+    for (const auto& k : cases) {
+        Eigen::MatrixXd W4 = Eigen::MatrixXd::Random(C_in, M / k.group * kH * kW);
+        auto ref = reference_convtranspose(X4, W4, C_in, H, W_dim, M, kH, kW,
+                                           k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                                           k.oph, k.opw, k.dh, k.dw, k.group);
+        ref.colwise() += bias4;
+
+        auto y_col2im = convtranspose_col2im(X4, W4, &bias4, C_in, H, W_dim, M, kH, kW,
+                                             k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                                             k.oph, k.opw, k.dh, k.dw, k.group);
+        auto y_subpixel = convtranspose_subpixel(X4, W4, &bias4, C_in, H, W_dim, M, kH, kW,
+                                                 k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                                                 k.oph, k.opw, k.dh, k.dw, k.group);
+        auto y = convtranspose(X4, W4, &bias4, C_in, H, W_dim, M, kH, kW,
+                               k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                               k.oph, k.opw, k.dh, k.dw, k.group);
+
+        assert(y.rows() == ref.rows() && y.cols() == ref.cols());
+        assert((y_col2im - ref).norm() < 1e-10);
+        assert((y_subpixel - ref).norm() < 1e-10);
+        assert((y - ref).norm() < 1e-10);
+    }
+    std::cout << "Test 4 (col2im / sub-pixel, dilation, groups, output_padding) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
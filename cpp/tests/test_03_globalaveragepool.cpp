@@ -35,6 +35,18 @@ int main() {
     assert((Y2 - expected2).norm() < 1e-10);
     std::cout << "Test 2 (1 channel, 3x3) passed" << std::endl;
 
+    // Test 3: NHWC and NCHWc layouts
+    Eigen::VectorXd X3_nhwc(8);
+    X3_nhwc << 1, 5, 2, 6, 3, 7, 4, 8;    // (2, 2, 2) channel-last
+
+    auto Y3 = globalaveragepool_nhwc(X3_nhwc, 2, 2, 2);
+    assert(std::abs(Y3(0) - 2.5) < 1e-10);
+    assert(std::abs(Y3(1) - 6.5) < 1e-10);
+
+    auto Y3b = globalaveragepool_nchwc(X3_nhwc, 2, 2, 2, 2);
+    assert((Y3b - Y3).norm() < 1e-10);
+    std::cout << "Test 3 (NHWC / NCHWc) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -47,6 +47,31 @@ int main() {
 
     std::cout << "Test 3 (with initial state) passed" << std::endl;
 
+    // Test 4: Values against a step-by-step reference; scratch arena is rewound
+    {
+        Eigen::VectorXd h = h0;
+        for (int t = 0; t < seq_length; ++t) {
+            Eigen::VectorXd gi = W * X.row(t).transpose() + Wb;
+            Eigen::VectorXd gh = R * h + Rb;
+            Eigen::VectorXd next(hidden_size);
+            for (int j = 0; j < hidden_size; ++j) {
+                double z = 1.0 / (1.0 + std::exp(-(gi(j) + gh(j))));
+                double r = 1.0 / (1.0 + std::exp(-(gi(hidden_size + j) + gh(hidden_size + j))));
+                double ht = std::tanh(gi(2 * hidden_size + j) + r * gh(2 * hidden_size + j));
+                next(j) = (1.0 - z) * ht + z * h(j);
+            }
+            h = next;
+            assert((Y3.row(t).transpose() - h).norm() < 1e-10);
+        }
+        assert((Y_h3 - h).norm() < 1e-10);
+
+        const runtime::Arena& arena = runtime::Arena::thread_instance();
+        assert(arena.used_bytes() == 0);
+        assert(arena.high_water() > 0);
+    }
+
+    std::cout << "Test 4 (reference values, arena rewound) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include "../03_layernormalization.hpp"
 
 int main() {
@@ -50,6 +51,75 @@ int main() {
     // Mean should be shifted by bias, variance scaled by scale^2
     std::cout << "Test 2 (scale and bias) passed" << std::endl;
 
+    // Test 3: Mean / InvStdDev outputs, large offset (numerical stability)
+    Eigen::MatrixXd X3(2, 4);
+    X3 << 1e8 + 1, 1e8 + 2, 1e8 + 3, 1e8 + 4,
+          -1, 0, 1, 2;
+
+    Eigen::VectorXd mean3, inv_std3;
+    auto Y3 = layernormalization(X3, scale, bias, 0.0, &mean3, &inv_std3);
+
+    assert(std::abs(mean3(0) - (1e8 + 2.5)) < 1e-6);
+    assert(std::abs(mean3(1) - 0.5) < 1e-12);
+    assert(std::abs(inv_std3(0) - 1.0 / std::sqrt(1.25)) < 1e-10);
+    assert(std::abs(inv_std3(1) - 1.0 / std::sqrt(1.25)) < 1e-10);
+    assert((Y3.row(0) - Y3.row(1)).norm() < 1e-8);
+    std::cout << "Test 3 (mean/inv_std outputs, large offset) passed" << std::endl;
+
+    // Test 4: N-D input (2, 2, 3) normalized over axis=1
+    Eigen::VectorXd X4(12);
+    X4 << 0, 1, 2, 3, 4, 5,
+          6, 8, 10, 12, 14, 16;
+    std::vector<int> shape4 = {2, 2, 3};
+
+    Eigen::VectorXd scale4 = Eigen::VectorXd::Ones(6);
+    Eigen::VectorXd bias4 = Eigen::VectorXd::Constant(6, 0.5);
+    Eigen::VectorXd mean4, inv_std4;
+
+    auto Y4 = layernormalization(X4, shape4, scale4, &bias4, 1, 1e-5, &mean4, &inv_std4);
+
+    assert(Y4.size() == 12);
+    assert(mean4.size() == 2);
+    assert(std::abs(mean4(0) - 2.5) < 1e-12);
+    assert(std::abs(mean4(1) - 11.0) < 1e-12);
+    for (int i = 0; i < 2; ++i) {
+        Eigen::VectorXd block = Y4.segment(i * 6, 6).array() - 0.5;
+        assert(std::abs(block.mean()) < 1e-10);
+        assert(std::abs(block.squaredNorm() / 6 - 1.0) < 1e-4);
+    }
+    // Same result with axis=-2
+    auto Y4b = layernormalization(X4, shape4, scale4, &bias4, -2);
+    assert((Y4 - Y4b).norm() < 1e-12);
+    std::cout << "Test 4 (N-D axis) passed" << std::endl;
+
+    // Test 5: N-D last axis matches the 2D overload
+    Eigen::VectorXd X5(8);
+    X5 << 1, 2, 3, 4, 5, 6, 7, 8;
+    auto Y5 = layernormalization(X5, {2, 4}, scale, &bias);
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            assert(std::abs(Y5(i * 4 + j) - Y(i, j)) < 1e-12);
+        }
+    }
+    std::cout << "Test 5 (N-D matches 2D) passed" << std::endl;
+
+    // Test 6: SkipLayerNormalization equals LayerNorm(X + skip)
+    Eigen::MatrixXd skip(2, 4);
+    skip << 0.5, -1, 2, 0,
+            1, 1, -3, 4;
+
+    Eigen::VectorXd scale6(4);
+    scale6 << 1, 2, 0.5, -1;
+
+    Eigen::MatrixXd sum6;
+    auto Y6 = skiplayernormalization(X, skip, scale6, bias, 1e-5, &sum6);
+    Eigen::MatrixXd Xs = X + skip;
+    auto expected6 = layernormalization(Xs, scale6, bias);
+
+    assert((sum6 - Xs).norm() < 1e-12);
+    assert((Y6 - expected6).norm() < 1e-10);
+    std::cout << "Test 6 (skip layer normalization) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -49,6 +49,42 @@ int main() {
 
     std::cout << "Test 3 (with initial states) passed" << std::endl;
 
+    // Test 4: Values against a step-by-step reference; scratch arena is rewound
+    {
+        Eigen::VectorXd h = h0, c = c0;
+        for (int t = 0; t < seq_length; ++t) {
+            Eigen::VectorXd g = W * X.row(t).transpose() + R * h + Wb + Rb;
+            for (int j = 0; j < hidden_size; ++j) {
+                double i = 1.0 / (1.0 + std::exp(-g(j)));
+                double f = 1.0 / (1.0 + std::exp(-g(hidden_size + j)));
+                double gg = std::tanh(g(2 * hidden_size + j));
+                double o = 1.0 / (1.0 + std::exp(-g(3 * hidden_size + j)));
+                c(j) = f * c(j) + i * gg;
+                h(j) = o * std::tanh(c(j));
+            }
+            assert((Y3.row(t).transpose() - h).norm() < 1e-10);
+        }
+        assert((Y_h3 - h).norm() < 1e-10);
+        assert((Y_c3 - c).norm() < 1e-10);
+
+        const runtime::Arena& arena = runtime::Arena::thread_instance();
+        assert(arena.used_bytes() == 0);
+        assert(arena.high_water() > 0);
+    }
+
+    std::cout << "Test 4 (reference values, arena rewound) passed" << std::endl;
+
+    // Test 5: lstm_into carries the state in caller buffers (state updated in place)
+    {
+        Eigen::MatrixXd Y5(seq_length, hidden_size);
+        Eigen::VectorXd h = h0, c = c0;
+        lstm_into(Y5, h, c, X, W, R, &Wb, &Rb, &h, &c);
+        assert((Y5 - Y3).norm() < 1e-10);
+        assert((h - Y_h3).norm() < 1e-10);
+        assert((c - Y_c3).norm() < 1e-10);
+    }
+    std::cout << "Test 5 (lstm_into, in-place state) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
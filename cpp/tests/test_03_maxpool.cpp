@@ -1,8 +1,33 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <limits>
+#include <vector>
 #include "../03_maxpool.hpp"
 
+// Reference MaxPool: recompute every window with bounds checks
+Eigen::MatrixXd reference_maxpool(const Eigen::MatrixXd& X, int C, int H, int W,
+                                  int kh_, int kw_, int sh, int sw,
+                                  int pt, int pl, int out_h, int out_w, int dh, int dw) {
+    Eigen::MatrixXd Y(C, out_h * out_w);
+    for (int c = 0; c < C; ++c) {
+        for (int oh = 0; oh < out_h; ++oh) {
+            for (int ow = 0; ow < out_w; ++ow) {
+                double m = -std::numeric_limits<double>::infinity();
+                for (int kh = 0; kh < kh_; ++kh) {
+                    for (int kw = 0; kw < kw_; ++kw) {
+                        int h = oh * sh - pt + kh * dh;
+                        int w = ow * sw - pl + kw * dw;
+                        if (h >= 0 && h < H && w >= 0 && w < W) m = std::max(m, X(c, h * W + w));
+                    }
+                }
+                Y(c, oh * out_w + ow) = m;
+            }
+        }
+    }
+    return Y;
+}
+
 int main() {
     using namespace onnx;
 
@@ -33,6 +58,123 @@ int main() {
 
     std::cout << "Test 2 (with padding) passed" << std::endl;
 
+    // Test 3: NHWC and NCHWc match the planar implementation
+    int C = 5, H = 7, W = 9, block = 4;
+    Eigen::MatrixXd X3 = Eigen::MatrixXd::Random(C, H * W);
+    auto Y3 = maxpool(X3, C, H, W, 3, 3, 2, 2, 1, 1, 1, 1);
+    int P = Y3.cols();
+
+    Eigen::VectorXd X3_nhwc(C * H * W);
+    Eigen::VectorXd X3_nchwc = Eigen::VectorXd::Zero(2 * H * W * block);
+    for (int c = 0; c < C; ++c) {
+        for (int p = 0; p < H * W; ++p) {
+            X3_nhwc(p * C + c) = X3(c, p);
+            X3_nchwc(((c / block) * H * W + p) * block + c % block) = X3(c, p);
+        }
+    }
+
+    auto Y3_nhwc = maxpool_nhwc(X3_nhwc, C, H, W, 3, 3, 2, 2, 1, 1, 1, 1);
+    auto Y3_nchwc = maxpool_nchwc(X3_nchwc, C, H, W, block, 3, 3, 2, 2, 1, 1, 1, 1);
+    for (int c = 0; c < C; ++c) {
+        for (int p = 0; p < P; ++p) {
+            assert(std::abs(Y3_nhwc(p * C + c) - Y3(c, p)) < 1e-12);
+            assert(std::abs(Y3_nchwc(((c / block) * P + p) * block + c % block) - Y3(c, p)) < 1e-12);
+        }
+    }
+    std::cout << "Test 3 (NHWC / NCHWc) passed" << std::endl;
+
+    // Test 4: ceil_mode output size (ONNX example: 4x4, kernel 3, stride 2)
+    auto Y4 = maxpool(X, 1, 4, 4, 3, 3, 2, 2, 0, 0, 0, 0, true);
+    Eigen::MatrixXd expected4(1, 4);
+    expected4 << 11, 12, 15, 16;
+    assert((Y4 - expected4).norm() < 1e-10);
+    std::cout << "Test 4 (ceil_mode) passed" << std::endl;
+
+    // Test 5: Separable / sliding-window paths against the reference
+    struct Case { int kh, kw, sh, sw, pt, pl, pb, pr, dh, dw; bool ceil; };
+    std::vector<Case> cases = {
+        {3, 3, 1, 1, 1, 1, 1, 1, 1, 1, false},
+        {3, 2, 2, 1, 0, 1, 1, 0, 2, 3, true},
+        {9, 11, 1, 2, 4, 5, 4, 5, 1, 1, false},   // deque path
+        {8, 8, 3, 3, 2, 1, 3, 0, 1, 1, true},     // deque path, ceil_mode
+        {2, 2, 2, 2, 0, 0, 0, 0, 1, 1, true},
+    };
+    int C5 = 3, H5 = 17, W5 = 23;
+    Eigen::MatrixXd X5 = Eigen::MatrixXd::Random(C5, H5 * W5);
+    for (const auto& k : cases) {
+        auto Y5 = maxpool(X5, C5, H5, W5, k.kh, k.kw, k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                          k.ceil, k.dh, k.dw);
+        int out_h = maxpool_output_size(H5, k.kh, k.sh, k.dh, k.pt, k.pb, k.ceil);
+        int out_w = maxpool_output_size(W5, k.kw, k.sw, k.dw, k.pl, k.pr, k.ceil);
+        auto ref = reference_maxpool(X5, C5, H5, W5, k.kh, k.kw, k.sh, k.sw, k.pt, k.pl,
+                                     out_h, out_w, k.dh, k.dw);
+        assert(Y5.cols() == out_h * out_w);
+        assert((Y5 - ref).norm() < 1e-12);
+    }
+    std::cout << "Test 5 (sliding window, dilations) passed" << std::endl;
+
+
+    // Test 6: Indices output (storage_order 0 and 1)
+    typedef Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic> IndexMatrix;
+    IndexMatrix I6;
+    auto Y6 = maxpool(X, 1, 4, 4, 2, 2, 2, 2, 0, 0, 0, 0, false, 1, 1, &I6);
+    IndexMatrix expected_i6(1, 4);
+    expected_i6 << 5, 7, 13, 15;
+    assert((Y6 - expected).norm() < 1e-10);
+    assert(I6 == expected_i6);
+
+    IndexMatrix I6_col;
+    maxpool(X, 1, 4, 4, 2, 2, 2, 2, 0, 0, 0, 0, false, 1, 1, &I6_col, 1);
+    IndexMatrix expected_i6_col(1, 4);
+    expected_i6_col << 5, 13, 7, 15;
+    assert(I6_col == expected_i6_col);
+
+    // Indices from every pooling path point at the max value
+    for (const auto& k : cases) {
+        IndexMatrix I7;
+        auto Y7 = maxpool(X5, C5, H5, W5, k.kh, k.kw, k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                          k.ceil, k.dh, k.dw, &I7);
+        for (int c = 0; c < C5; ++c) {
+            for (int p = 0; p < Y7.cols(); ++p) {
+                int64_t pos = I7(c, p) - static_cast<int64_t>(c) * H5 * W5;
+                assert(pos >= 0 && pos < H5 * W5);
+                assert(X5(c, pos) == Y7(c, p));
+            }
+        }
+    }
+    std::cout << "Test 6 (Indices, storage_order) passed" << std::endl;
+
+    // Test 7: NHWC / NCHWc follow the same output size with ceil_mode and dilations
+    {
+        const int block5 = 2;
+        Eigen::VectorXd X5_nhwc(C5 * H5 * W5);
+        Eigen::VectorXd X5_nchwc = Eigen::VectorXd::Zero(2 * H5 * W5 * block5);
+        for (int c = 0; c < C5; ++c) {
+            for (int p = 0; p < H5 * W5; ++p) {
+                X5_nhwc(p * C5 + c) = X5(c, p);
+                X5_nchwc(((c / block5) * H5 * W5 + p) * block5 + c % block5) = X5(c, p);
+            }
+        }
+        for (const auto& k : cases) {
+            auto Y5 = maxpool(X5, C5, H5, W5, k.kh, k.kw, k.sh, k.sw, k.pt, k.pl, k.pb, k.pr,
+                              k.ceil, k.dh, k.dw);
+            auto Y5_nhwc = maxpool_nhwc(X5_nhwc, C5, H5, W5, k.kh, k.kw, k.sh, k.sw,
+                                        k.pt, k.pl, k.pb, k.pr, k.ceil, k.dh, k.dw);
+            auto Y5_nchwc = maxpool_nchwc(X5_nchwc, C5, H5, W5, block5, k.kh, k.kw, k.sh, k.sw,
+                                          k.pt, k.pl, k.pb, k.pr, k.ceil, k.dh, k.dw);
+            int P5 = Y5.cols();
+            assert(Y5_nhwc.size() == static_cast<long>(P5) * C5);
+            assert(Y5_nchwc.size() == static_cast<long>(P5) * 2 * block5);
+            for (int c = 0; c < C5; ++c) {
+                for (int p = 0; p < P5; ++p) {
+                    assert(Y5_nhwc(p * C5 + c) == Y5(c, p));
+                    assert(Y5_nchwc(((c / block5) * P5 + p) * block5 + c % block5) == Y5(c, p));
+                }
+            }
+        }
+    }
+    std::cout << "Test 7 (NHWC / NCHWc ceil_mode, dilations) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include "../03_maxpool.hpp"
+#include "../03_maxunpool.hpp"
+
+int main() {
+    using namespace onnx;
+    typedef Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic> IndexMatrix;
+
+    // Test 1: MaxUnpool with 2x2 kernel, stride 2
+    Eigen::MatrixXd X(1, 4);
+    X << 6, 8, 14, 16;
+    IndexMatrix I(1, 4);
+    I << 5, 7, 13, 15;
+
+    auto Y = maxunpool(X, I, 1, 2, 2, 2, 2);
+
+    Eigen::MatrixXd expected = Eigen::MatrixXd::Zero(1, 16);
+    expected(0, 5) = 6;
+    expected(0, 7) = 8;
+    expected(0, 13) = 14;
+    expected(0, 15) = 16;
+
+    assert(Y.cols() == 16);
+    assert((Y - expected).norm() < 1e-10);
+    std::cout << "Test 1 (2x2 kernel, stride 2) passed" << std::endl;
+
+    // Test 2: MaxPool -> MaxUnpool round trip with explicit output shape
+    int C = 3, H = 5, W = 7;
+    Eigen::MatrixXd X2 = Eigen::MatrixXd::Random(C, H * W);
+    IndexMatrix I2;
+    auto pooled = maxpool(X2, C, H, W, 2, 2, 2, 2, 0, 0, 0, 0, false, 1, 1, &I2);
+    auto Y2 = maxunpool(pooled, I2, C, 2, 3, 2, 2, 2, 2, 0, 0, 0, 0, H, W);
+
+    assert(Y2.rows() == C && Y2.cols() == H * W);
+    for (int c = 0; c < C; ++c) {
+        for (int p = 0; p < pooled.cols(); ++p) {
+            int64_t idx = I2(c, p) - static_cast<int64_t>(c) * H * W;
+            assert(Y2(c, idx) == pooled(c, p));
+            assert(X2(c, idx) == pooled(c, p));
+        }
+    }
+    // Non-max positions are zero
+    assert(std::abs(Y2.sum() - pooled.sum()) < 1e-10);
+    std::cout << "Test 2 (MaxPool round trip) passed" << std::endl;
+
+    // Test 3: Odd-sized input (2 x 5 x 5); the output shape must be given explicitly
+    Eigen::MatrixXd X3 = Eigen::MatrixXd::Random(2, 25);
+    IndexMatrix I3;
+    auto pooled3 = maxpool(X3, 2, 5, 5, 2, 2, 2, 2, 0, 0, 0, 0, false, 1, 1, &I3);
+    auto Y3 = maxunpool(pooled3, I3, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 5, 5);
+    assert(Y3.rows() == 2 && Y3.cols() == 25);
+    for (int c = 0; c < 2; ++c) {
+        for (int p = 0; p < pooled3.cols(); ++p) {
+            assert(Y3(c, I3(c, p) - c * 25) == pooled3(c, p));
+        }
+        assert(std::abs(Y3.row(c).sum() - pooled3.row(c).sum()) < 1e-10);
+    }
+
+    // Default 4x4 output does not match the pooled plane: out-of-plane indices
+    // are skipped instead of spilling into the next channel or past the end
+    auto Y3d = maxunpool(pooled3, I3, 2, 2, 2, 2, 2);
+    assert(Y3d.rows() == 2 && Y3d.cols() == 16);
+    for (int c = 0; c < 2; ++c) {
+        for (int p = 0; p < pooled3.cols(); ++p) {
+            int64_t idx = I3(c, p) - c * 16;
+            if (idx >= 0 && idx < 16) assert(Y3d(c, idx) == pooled3(c, p));
+        }
+    }
+    std::cout << "Test 3 (odd input, explicit output shape) passed" << std::endl;
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
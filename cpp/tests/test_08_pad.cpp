@@ -3,6 +3,7 @@
 #include <cmath>
 #include <vector>
 #include "../08_pad.hpp"
+#include "../03_averagepool.hpp"
 
 int main() {
     using namespace onnx;
@@ -63,6 +64,143 @@ int main() {
     assert(std::abs(result2(1, 1) - 4.0) < 1e-10);
     std::cout << "Test 4 (asymmetric padding) passed" << std::endl;
 
+    // Test 5: NHWC padding (2 channels)
+    Eigen::VectorXd data5(2 * 3 * 2);    // (H=2, W=3, C=2)
+    for (int p = 0; p < 6; ++p) {
+        data5(p * 2) = data2(p / 3, p % 3);
+        data5(p * 2 + 1) = -data2(p / 3, p % 3);
+    }
+    auto check_nhwc = [&](const Eigen::VectorXd& out, const Eigen::MatrixXd& expected) {
+        assert(out.size() == expected.size() * 2);
+        for (int i = 0; i < expected.rows(); ++i) {
+            for (int j = 0; j < expected.cols(); ++j) {
+                int p = i * expected.cols() + j;
+                assert(std::abs(out(p * 2) - expected(i, j)) < 1e-10);
+            }
+        }
+    };
+
+    auto result5 = pad_nhwc(data5, 2, 3, 2, pads2, "constant", 9.0);
+    check_nhwc(result5, result2);
+    assert(std::abs(result5(1 * 2 + 1) + 1.0) < 1e-10);    // (0, 1), channel 1
+
+    std::vector<int> pads5 = {1, 2, 1, 2};
+    Eigen::MatrixXd expected_edge5(4, 7);
+    expected_edge5 << 1, 1, 1, 2, 3, 3, 3,
+                      1, 1, 1, 2, 3, 3, 3,
+                      4, 4, 4, 5, 6, 6, 6,
+                      4, 4, 4, 5, 6, 6, 6;
+    check_nhwc(pad_nhwc(data5, 2, 3, 2, pads5, "edge"), expected_edge5);
+
+    Eigen::MatrixXd expected_reflect5(4, 7);
+    expected_reflect5 << 6, 5, 4, 5, 6, 5, 4,
+                         3, 2, 1, 2, 3, 2, 1,
+                         6, 5, 4, 5, 6, 5, 4,
+                         3, 2, 1, 2, 3, 2, 1;
+    check_nhwc(pad_nhwc(data5, 2, 3, 2, pads5, "reflect"), expected_reflect5);
+
+    // Negative pads crop, as in the 2D pad
+    for (const std::vector<int>& pads5n : {std::vector<int>{-1, -1, 1, 0}, std::vector<int>{0, 2, -1, -2}}) {
+        check_nhwc(pad_nhwc(data5, 2, 3, 2, pads5n, "constant", 9.0), pad(data2, pads5n, "constant", 9.0));
+        check_nhwc(pad_nhwc(data5, 2, 3, 2, pads5n, "edge"), pad(data2, pads5n, "edge"));
+    }
+    std::cout << "Test 5 (NHWC padding) passed" << std::endl;
+
+
+    // Test 6: wrap mode and negative pads (2D)
+    Eigen::MatrixXd expected6(4, 7);
+    expected6 << 5, 6, 4, 5, 6, 4, 5,
+                 2, 3, 1, 2, 3, 1, 2,
+                 5, 6, 4, 5, 6, 4, 5,
+                 2, 3, 1, 2, 3, 1, 2;
+    assert((pad(data2, pads5, "wrap") - expected6).norm() < 1e-10);
+    assert((pad(data2, {0, -1, 0, 0}) - data2.rightCols(2)).norm() < 1e-10);
+    std::cout << "Test 6 (wrap, negative pads) passed" << std::endl;
+
+    // Test 7: N-D pad against the 2D implementation, every mode
+    Eigen::VectorXd data7(2 * 3);
+    for (int p = 0; p < 6; ++p) data7(p) = data2(p / 3, p % 3);
+    for (const std::string mode : {"constant", "reflect", "edge", "wrap"}) {
+        auto Y7 = pad(data7, {2, 3}, {1, 2, 1, 2}, mode, 7.0);
+        auto ref = pad(data2, pads5, mode, 7.0);
+        assert(Y7.size() == ref.size());
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 7; ++j) assert(Y7(i * 7 + j) == ref(i, j));
+        }
+    }
+
+    // ONNX example: reflect on (3, 2) with pads [0, 2, 0, 0]
+    Eigen::VectorXd data7b(6);
+    data7b << 1.0, 1.2, 2.3, 3.4, 4.5, 5.7;
+    Eigen::VectorXd expected7b(12);
+    expected7b << 1.0, 1.2, 1.0, 1.2,
+                  2.3, 3.4, 2.3, 3.4,
+                  4.5, 5.7, 4.5, 5.7;
+    assert((pad(data7b, {3, 2}, {0, 2, 0, 0}, "reflect") - expected7b).norm() < 1e-10);
+
+    // axes input: pad only axis -1 of a (2, 2, 3) tensor
+    Eigen::VectorXd data7c = Eigen::VectorXd::LinSpaced(12, 0, 11);
+    std::vector<int> axes7 = {-1};
+    auto Y7c = pad(data7c, {2, 2, 3}, {1, 0}, "edge", 0.0, &axes7);
+    assert(Y7c.size() == 16);
+    for (int r = 0; r < 4; ++r) {
+        assert(Y7c(r * 4) == data7c(r * 3));
+        for (int k = 0; k < 3; ++k) assert(Y7c(r * 4 + 1 + k) == data7c(r * 3 + k));
+    }
+
+    // 3-D constant padding on every axis
+    auto Y7d = pad(data7c, {2, 2, 3}, {1, 0, 1, 0, 1, 1}, "constant", -1.0);
+    assert(Y7d.size() == 3 * 3 * 5);
+    assert(Y7d(0) == -1.0 && Y7d.sum() == data7c.sum() - (3 * 3 * 5 - 12));
+    assert(Y7d((1 * 3 + 0) * 5 + 1) == 0.0);
+    std::cout << "Test 7 (N-D pad, axes) passed" << std::endl;
+
+    // Test 8: Folding a Pad into the consumer
+    int pt = 0, pl = 0, pb = 0, pr = 0;
+    std::string conv_mode = "constant";
+    assert(pad_fold_into_consumer({0, 0, 1, 2, 0, 0, 1, 2}, "constant", 0.0, "Conv", pt, pl, pb, pr, &conv_mode));
+    assert(pt == 1 && pl == 2 && pb == 1 && pr == 2 && conv_mode == "constant");
+    assert(!pad_fold_into_consumer({0, 0, 1, 1, 0, 0, 1, 1}, "constant", 0.0, "MaxPool", pt, pl, pb, pr));
+    assert(!pad_fold_into_consumer({0, 1, 1, 1, 0, 0, 1, 1}, "constant", 0.0, "Conv", pt, pl, pb, pr));
+    int qt = 0, ql = 0, qb = 0, qr = 0;
+    assert(pad_fold_into_consumer({0, 0, 1, 1, 0, 0, 1, 1}, "reflect", 0.0, "Conv", qt, ql, qb, qr, &conv_mode));
+    assert(conv_mode == "reflect" && qt == 1);
+
+    // Pad -> AveragePool matches the folded AveragePool only with count_include_pad
+    {
+        typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+        const int C8 = 2, H8 = 5, W8 = 4;
+        Eigen::VectorXd x8 = Eigen::VectorXd::Random(C8 * H8 * W8);
+        std::vector<int> pads8 = {0, 0, 1, 2, 0, 0, 1, 0};
+        Eigen::VectorXd padded8 = pad(x8, {1, C8, H8, W8}, pads8);
+        const int Hp = H8 + 2, Wp = W8 + 2;
+        Eigen::MatrixXd Xp = Eigen::Map<const RowMatrix>(padded8.data(), C8, Hp * Wp);
+        Eigen::MatrixXd X8 = Eigen::Map<const RowMatrix>(x8.data(), C8, H8 * W8);
+
+        // AveragePool with its own pad of 1 on each side (count_include_pad = true)
+        auto ref = averagepool(Xp, C8, Hp, Wp, 3, 3, 1, 1, 1, 1, 1, 1, false, true);
+
+        int at = 1, al = 1, ab = 1, ar = 1;
+        assert(!pad_fold_into_consumer(pads8, "constant", 0.0, "AveragePool", at, al, ab, ar));
+        assert(at == 1 && al == 1 && ab == 1 && ar == 1);
+        assert(pad_fold_into_consumer(pads8, "constant", 0.0, "AveragePool", at, al, ab, ar, nullptr, true));
+        auto folded = averagepool(X8, C8, H8, W8, 3, 3, 1, 1, at, al, ab, ar, false, true);
+        assert(folded.rows() == ref.rows() && folded.cols() == ref.cols());
+        assert((folded - ref).norm() < 1e-10);
+    }
+    std::cout << "Test 8 (fold into consumer) passed" << std::endl;
+
+    // Test 9: pad_into with pad_output_shape
+    {
+        std::vector<int> pads9 = {1, 0, 1, 0, 1, 1};
+        std::vector<int> out_shape9 = pad_output_shape({2, 2, 3}, pads9);
+        assert((out_shape9 == std::vector<int>{3, 3, 5}));
+        Eigen::VectorXd Y9(3 * 3 * 5);
+        pad_into(Y9, data7c, {2, 2, 3}, pads9, "constant", -1.0);
+        assert((Y9 - Y7d).norm() < 1e-10);
+    }
+    std::cout << "Test 9 (pad_into) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -105,6 +105,78 @@ int main() {
     assert((d2s_result - original).norm() < 1e-10);
     std::cout << "Test 3 (roundtrip) passed" << std::endl;
 
+    // Test 4: NHWC, CRD mode matches the multi-channel version
+    Eigen::VectorXd X4(2 * 2 * 8);    // (H=2, W=2, C=8)
+    for (int c = 0; c < 8; ++c) {
+        for (int h = 0; h < 2; ++h) {
+            for (int w = 0; w < 2; ++w) X4((h * 2 + w) * 8 + c) = input_multi[c](h, w);
+        }
+    }
+    auto Y4 = depthtospace_nhwc(X4, 2, 2, 8, 2, "CRD");
+    for (int c = 0; c < 2; ++c) {
+        for (int h = 0; h < 4; ++h) {
+            for (int w = 0; w < 4; ++w) {
+                assert(std::abs(Y4((h * 4 + w) * 2 + c) - output_multi[c](h, w)) < 1e-10);
+            }
+        }
+    }
+    std::cout << "Test 4 (NHWC CRD) passed" << std::endl;
+
+    // Test 5: NHWC, DCR mode (input channel = block_idx * C_out + c)
+    auto Y5 = depthtospace_nhwc(X4, 2, 2, 8, 2);
+    for (int c = 0; c < 2; ++c) {
+        for (int h = 0; h < 4; ++h) {
+            for (int w = 0; w < 4; ++w) {
+                int c_in = ((h % 2) * 2 + (w % 2)) * 2 + c;
+                assert(std::abs(Y5((h * 4 + w) * 2 + c) - input_multi[c_in](h / 2, w / 2)) < 1e-10);
+            }
+        }
+    }
+    std::cout << "Test 5 (NHWC DCR) passed" << std::endl;
+
+    // Test 6: NHWC roundtrip (SpaceToDepth -> DepthToSpace DCR)
+    Eigen::VectorXd X6 = Eigen::VectorXd::Random(6 * 4 * 3);
+    auto s2d6 = spacetodepth_nhwc(X6, 6, 4, 3, 2);
+    auto d2s6 = depthtospace_nhwc(s2d6, 3, 2, 12, 2);
+    assert((d2s6 - X6).norm() < 1e-12);
+    std::cout << "Test 6 (NHWC roundtrip) passed" << std::endl;
+
+
+    // Test 7: NCHW contiguous, ONNX examples (1, 8, 2, 3) -> (1, 2, 4, 6)
+    Eigen::VectorXd X7(48);
+    for (int i = 0; i < 48; ++i) X7(i) = i;
+    Eigen::VectorXd expected7_dcr(48);
+    expected7_dcr << 0, 12, 1, 13, 2, 14,   24, 36, 25, 37, 26, 38,
+                     3, 15, 4, 16, 5, 17,   27, 39, 28, 40, 29, 41,
+                     6, 18, 7, 19, 8, 20,   30, 42, 31, 43, 32, 44,
+                     9, 21, 10, 22, 11, 23, 33, 45, 34, 46, 35, 47;
+    Eigen::VectorXd expected7_crd(48);
+    expected7_crd << 0, 6, 1, 7, 2, 8,       12, 18, 13, 19, 14, 20,
+                     3, 9, 4, 10, 5, 11,     15, 21, 16, 22, 17, 23,
+                     24, 30, 25, 31, 26, 32, 36, 42, 37, 43, 38, 44,
+                     27, 33, 28, 34, 29, 35, 39, 45, 40, 46, 41, 47;
+    assert((depthtospace(X7, 8, 2, 3, 2) - expected7_dcr).norm() < 1e-10);
+    assert((depthtospace(X7, 8, 2, 3, 2, "CRD") - expected7_crd).norm() < 1e-10);
+    std::cout << "Test 7 (NCHW DCR / CRD) passed" << std::endl;
+
+    // Test 8: NCHW CRD matches the multi-channel version; roundtrips for blocksize 2 and 3
+    Eigen::VectorXd X8(8 * 2 * 2);
+    for (int c = 0; c < 8; ++c) {
+        for (int p = 0; p < 4; ++p) X8(c * 4 + p) = input_multi[c](p / 2, p % 2);
+    }
+    auto Y8 = depthtospace(X8, 8, 2, 2, 2, "CRD");
+    for (int c = 0; c < 2; ++c) {
+        for (int p = 0; p < 16; ++p) assert(Y8(c * 16 + p) == output_multi[c](p / 4, p % 4));
+    }
+    for (int b : {2, 3}) {
+        for (const std::string mode : {"DCR", "CRD"}) {
+            Eigen::VectorXd X8b = Eigen::VectorXd::Random(3 * 4 * b * 5 * b);
+            auto s2d = spacetodepth(X8b, 3, 4 * b, 5 * b, b, mode);
+            assert((depthtospace(s2d, 3 * b * b, 4, 5, b, mode) - X8b).norm() < 1e-12);
+        }
+    }
+    std::cout << "Test 8 (NCHW roundtrip) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
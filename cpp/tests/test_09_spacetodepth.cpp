@@ -80,6 +80,46 @@ int main() {
 
     std::cout << "Test 2 (multi-channel) passed" << std::endl;
 
+    // Test 3: NHWC (output channel = block_idx * C + c)
+    Eigen::VectorXd X3(4 * 4 * 2);    // (H=4, W=4, C=2)
+    for (int c = 0; c < 2; ++c) {
+        for (int h = 0; h < 4; ++h) {
+            for (int w = 0; w < 4; ++w) X3((h * 4 + w) * 2 + c) = input_multi[c](h, w);
+        }
+    }
+    auto Y3 = spacetodepth_nhwc(X3, 4, 4, 2, 2);
+    for (int h = 0; h < 2; ++h) {
+        for (int w = 0; w < 2; ++w) {
+            for (int c_out = 0; c_out < 8; ++c_out) {
+                int block_idx = c_out / 2;
+                int c = c_out % 2;
+                double expected = input_multi[c](h * 2 + block_idx / 2, w * 2 + block_idx % 2);
+                assert(std::abs(Y3((h * 2 + w) * 8 + c_out) - expected) < 1e-10);
+            }
+        }
+    }
+    std::cout << "Test 3 (NHWC) passed" << std::endl;
+
+
+    // Test 4: NCHW contiguous (output channel = block_idx * C + c)
+    Eigen::VectorXd X4(2 * 4 * 4);    // (C=2, H=4, W=4)
+    for (int c = 0; c < 2; ++c) {
+        for (int p = 0; p < 16; ++p) X4(c * 16 + p) = input_multi[c](p / 4, p % 4);
+    }
+    auto Y4 = spacetodepth(X4, 2, 4, 4, 2);
+    auto Y4_crd = spacetodepth(X4, 2, 4, 4, 2, "CRD");
+    for (int block_idx = 0; block_idx < 4; ++block_idx) {
+        for (int c = 0; c < 2; ++c) {
+            for (int p = 0; p < 4; ++p) {
+                double expected = input_multi[c]((p / 2) * 2 + block_idx / 2, (p % 2) * 2 + block_idx % 2);
+                assert(Y4((block_idx * 2 + c) * 4 + p) == expected);
+                // CRD order matches spacetodepth_multi
+                assert(Y4_crd((c * 4 + block_idx) * 4 + p) == output_multi[c * 4 + block_idx](p / 2, p % 2));
+            }
+        }
+    }
+    std::cout << "Test 4 (NCHW DCR / CRD) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
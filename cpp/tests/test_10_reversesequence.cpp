@@ -38,10 +38,13 @@ int main() {
 
     auto output2 = reversesequence(input2, sequence_lens2, 1, 0);
 
+    // Col 0: reverse first 3 [1,4,7,10] -> [7,4,1,10]
+    // Col 1: reverse first 2 [2,5,8,11] -> [5,2,8,11]
+    // Col 2: reverse first 4 [3,6,9,12] -> [12,9,6,3]
     Eigen::MatrixXd expected2(4, 3);
-    expected2 << 7,  5,  10,  // Col 0: reverse first 3 [1,4,7,10] -> [7,4,1,10]
-                 4,  2,  9,   // Col 1: reverse first 2 [2,5,8,11] -> [5,2,8,11]
-                 1,  8,  6,   // Col 2: reverse first 4 [3,6,9,12] -> [12,9,6,3]
+    expected2 << 7,  5,  12,
+                 4,  2,  9,
+                 1,  8,  6,
                  10, 11, 3;
 
     assert((output2 - expected2).norm() < 1e-10);
@@ -79,6 +82,53 @@ int main() {
     assert((output4 - expected4).norm() < 1e-10);
     std::cout << "Test 4 (partial reversal) passed" << std::endl;
 
+    // Test 5: N-D (time, batch, feature) layout, copy and in-place agree
+    std::vector<int> shape5 = {4, 3, 2};
+    Eigen::VectorXd x5 = Eigen::VectorXd::LinSpaced(24, 0, 23);
+    std::vector<int> lens5 = {4, 1, 3};
+
+    Eigen::VectorXd y5 = reversesequence(x5, shape5, lens5, 1, 0);
+    for (int t = 0; t < 4; ++t) {
+        for (int b = 0; b < 3; ++b) {
+            int src_t = (t < lens5[b]) ? lens5[b] - 1 - t : t;
+            for (int f = 0; f < 2; ++f) {
+                assert(std::abs(y5((t * 3 + b) * 2 + f) - x5((src_t * 3 + b) * 2 + f)) < 1e-10);
+            }
+        }
+    }
+
+    Eigen::VectorXd z5 = x5;
+    const double* ptr = z5.data();
+    reversesequence_inplace(z5, shape5, lens5, 1, 0);
+    assert(z5.data() == ptr);
+    assert((z5 - y5).norm() < 1e-10);
+    std::cout << "Test 5 (N-D time-major, in place) passed" << std::endl;
+
+    // Test 6: N-D (batch, time, feature) layout matches the 2D operator
+    std::vector<int> shape6 = {3, 4, 1};
+    Eigen::VectorXd x6(12);
+    x6 << 1, 2, 3, 4,
+          5, 6, 7, 8,
+          9, 10, 11, 12;
+    Eigen::VectorXd y6 = reversesequence(x6, shape6, sequence_lens1, 0, 1);
+    for (int b = 0; b < 3; ++b) {
+        for (int t = 0; t < 4; ++t) {
+            assert(std::abs(y6(b * 4 + t) - expected1(b, t)) < 1e-10);
+        }
+    }
+    reversesequence_inplace(x6, shape6, sequence_lens1, 0, 1);
+    assert((x6 - y6).norm() < 1e-10);
+    std::cout << "Test 6 (N-D batch-major) passed" << std::endl;
+
+    // Test 7: reversesequence_into, separate and aliased output
+    Eigen::VectorXd y7(x5.size());
+    reversesequence_into(y7, x5, shape5, lens5, 1, 0);
+    assert((y7 - y5).norm() < 1e-10);
+    Eigen::VectorXd z7 = x5;
+    reversesequence_into(z7, z7, shape5, lens5, 1, 0);
+    assert((z7 - y5).norm() < 1e-10);
+    std::cout << "Test 7 (reversesequence_into) passed" << std::endl;
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
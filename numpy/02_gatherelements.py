@@ -0,0 +1,39 @@
+import numpy as np
+
+def gatherelements(data, indices, axis=0):
+    """
+    ONNX GatherElements オペレータ
+
+    指定された軸に沿って、インデックステンソルの各要素が指す入力要素を収集する。
+    出力の形状はインデックステンソルと同じになる。
+
+    Args:
+        data: 入力テンソル
+        indices: インデックステンソル (data と同じランク、負の値は末尾から数える)
+        axis: 収集する軸 (デフォルト: 0)
+
+    Returns:
+        output: 収集された要素
+    """
+    indices = np.where(indices < 0, indices + data.shape[axis], indices)
+    return np.take_along_axis(data, indices, axis=axis)
+
+
+if __name__ == "__main__":
+    # テスト例
+    data = np.array([[1, 2], [3, 4]])
+    indices = np.array([[0, 0], [1, 0]])
+    print("元のテンソル:")
+    print(data)
+
+    result = gatherelements(data, indices, axis=1)
+    print("\nGatherElements (indices=[[0, 0], [1, 0]], axis=1):")
+    print(result)
+
+    # 軸0に沿って収集
+    data = np.array([[1, 2, 3], [4, 5, 6], [7, 8, 9]])
+    indices = np.array([[1, 2, 0], [2, 0, 0]])
+    result = gatherelements(data, indices, axis=0)
+    print("\nGatherElements (axis=0):")
+    print("結果の形状:", result.shape)
+    print(result)
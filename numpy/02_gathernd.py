@@ -0,0 +1,58 @@
+import numpy as np
+
+def gathernd(data, indices, batch_dims=0):
+    """
+    ONNX GatherND オペレータ
+
+    インデックステンソルの最後の次元を入力の先頭軸の座標とみなし、部分テンソルを収集する。
+
+    Args:
+        data: 入力テンソル
+        indices: インデックステンソル (最後の次元が座標の長さ k)
+        batch_dims: バッチ次元の数 (デフォルト: 0)
+
+    Returns:
+        output: 収集された要素
+            形状は indices.shape[:-1] + data.shape[batch_dims + k:]
+    """
+    batch_shape = data.shape[:batch_dims]
+    batch = int(np.prod(batch_shape))
+    k = indices.shape[-1]
+
+    data_b = data.reshape((batch,) + data.shape[batch_dims:])
+    indices_b = indices.reshape((batch, -1, k))
+
+    outputs = []
+    for b in range(batch):
+        for tup in indices_b[b]:
+            outputs.append(data_b[b][tuple(tup)])
+
+    output_shape = indices.shape[:-1] + data.shape[batch_dims + k:]
+    return np.array(outputs).reshape(output_shape)
+
+
+if __name__ == "__main__":
+    # テスト例
+    data = np.array([[0, 1], [2, 3]])
+    print("元のテンソル:")
+    print(data)
+
+    # 要素の収集
+    indices = np.array([[0, 0], [1, 1]])
+    result = gathernd(data, indices)
+    print("\nGatherND (indices=[[0, 0], [1, 1]]):")
+    print(result)
+
+    # 行の収集
+    indices = np.array([[1], [0]])
+    result = gathernd(data, indices)
+    print("\nGatherND (indices=[[1], [0]]):")
+    print(result)
+
+    # batch_dims=1
+    data = np.arange(8).reshape(2, 2, 2)
+    indices = np.array([[1], [0]])
+    result = gathernd(data, indices, batch_dims=1)
+    print("\nGatherND (batch_dims=1):")
+    print("結果の形状:", result.shape)
+    print(result)
@@ -0,0 +1,58 @@
+import numpy as np
+
+def scatterelements(data, indices, updates, axis=0, reduction="none"):
+    """
+    ONNX ScatterElements オペレータ
+
+    インデックステンソルの各要素が指す位置に更新値を散布する。
+
+    Args:
+        data: 入力テンソル (ベーステンソル)
+        indices: インデックステンソル (data と同じランク、負の値は末尾から数える)
+        updates: 更新値 (indices と同じ形状)
+        axis: 散布する軸 (デフォルト: 0)
+        reduction: 集約方法 ("none", "add", "mul", "max", "min")
+
+    Returns:
+        output: 更新されたテンソル
+    """
+    output = np.copy(data)
+    indices = np.where(indices < 0, indices + data.shape[axis], indices)
+
+    # 各更新値の書き込み先の座標を作る
+    for pos in np.ndindex(indices.shape):
+        target = list(pos)
+        target[axis] = indices[pos]
+        target = tuple(target)
+        if reduction == "add":
+            output[target] += updates[pos]
+        elif reduction == "mul":
+            output[target] *= updates[pos]
+        elif reduction == "max":
+            output[target] = max(output[target], updates[pos])
+        elif reduction == "min":
+            output[target] = min(output[target], updates[pos])
+        else:
+            output[target] = updates[pos]
+
+    return output
+
+
+if __name__ == "__main__":
+    # テスト例1: axis=0
+    data = np.zeros((3, 3))
+    indices = np.array([[1, 0, 2], [0, 2, 1]])
+    updates = np.array([[1.0, 1.1, 1.2], [2.0, 2.1, 2.2]])
+
+    result = scatterelements(data, indices, updates, axis=0)
+    print("axis=0:")
+    print(result)
+
+    # テスト例2: axis=1, reduction="add" (重複インデックス)
+    data = np.array([[1.0, 2.0, 3.0, 4.0, 5.0]])
+    indices = np.array([[1, 1]])
+    updates = np.array([[1.1, 2.1]])
+
+    result = scatterelements(data, indices, updates, axis=1, reduction="add")
+    print("\naxis=1, reduction=add:")
+    print(result)
@@ -1,6 +1,6 @@
 import numpy as np
 
-def scatternd(data, indices, updates):
+def scatternd(data, indices, updates, reduction="none"):
     """
     ONNX ScatterND オペレータ
 
@@ -10,6 +10,7 @@ def scatternd(data, indices, updates):
         data: 入力テンソル (ベーステンソル)
         indices: 更新する位置のインデックス
         updates: 更新値
+        reduction: 集約方法 ("none", "add", "mul", "max", "min")
 
     Returns:
         output: 更新されたテンソル
@@ -23,7 +24,16 @@ def scatternd(data, indices, updates):
     # 各インデックスに対して更新を適用
     for i in range(indices.shape[0]):
         idx = tuple(indices[i])
-        output[idx] = updates[i]
+        if reduction == "add":
+            output[idx] += updates[i]
+        elif reduction == "mul":
+            output[idx] *= updates[i]
+        elif reduction == "max":
+            output[idx] = np.maximum(output[idx], updates[i])
+        elif reduction == "min":
+            output[idx] = np.minimum(output[idx], updates[i])
+        else:
+            output[idx] = updates[i]
 
     return output
 
@@ -0,0 +1,57 @@
+import numpy as np
+
+def maxunpool(X, I, kernel_shape, strides=None, pads=None, output_shape=None):
+    """
+    ONNX MaxUnpool オペレータ
+
+    MaxPool の逆操作を行う。
+    MaxPool が出力したインデックスの位置に値を書き戻し、それ以外は 0 とする。
+
+    Args:
+        X: プーリング後の値 (N, C, H, W)
+        I: MaxPool のインデックス (N, C, H, W)、出力テンソル全体での平坦化位置
+        kernel_shape: カーネルサイズ [kH, kW]
+        strides: ストライド (デフォルト: kernel_shape)
+        pads: パディング [pad_top, pad_left, pad_bottom, pad_right] (デフォルト: [0, 0, 0, 0])
+        output_shape: 出力形状 (N, C, out_H, out_W) (デフォルト: カーネルとストライドから計算)
+
+    Returns:
+        Y: 出力テンソル
+    """
+    if strides is None:
+        strides = kernel_shape
+    if pads is None:
+        pads = [0, 0, 0, 0]
+
+    N, C, H, W = X.shape
+    kH, kW = kernel_shape
+
+    # 出力サイズ計算
+    if output_shape is None:
+        out_h = (H - 1) * strides[0] + kH - pads[0] - pads[2]
+        out_w = (W - 1) * strides[1] + kW - pads[1] - pads[3]
+        output_shape = (N, C, out_h, out_w)
+
+    # インデックス位置に値を散布
+    Y = np.zeros(int(np.prod(output_shape)), dtype=X.dtype)
+    Y[I.reshape(-1)] = X.reshape(-1)
+
+    return Y.reshape(output_shape)
+
+
+if __name__ == "__main__":
+    # テスト例
+    X = np.array([[[[1, 2, 3, 4],
+                    [5, 6, 7, 8],
+                    [9, 10, 11, 12],
+                    [13, 14, 15, 16]]]], dtype=np.float64)
+    print("プーリング前の入力:\n", X[0, 0])
+
+    # 2x2 MaxPool の値とインデックス
+    pooled = np.array([[[[6, 8], [14, 16]]]], dtype=np.float64)
+    indices = np.array([[[[5, 7], [13, 15]]]], dtype=np.int64)
+
+    Y = maxunpool(pooled, indices, kernel_shape=[2, 2])
+    print("MaxUnpool (2x2, stride=2):")
+    print("出力形状:", Y.shape)
+    print("出力:\n", Y[0, 0])